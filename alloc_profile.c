@@ -0,0 +1,265 @@
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "globals.h"
+#include "alloc_profile.h"
+#include "report.h"
+
+/* The first number of records of live heap memory, the table is doubled when it is half full */
+#define RECORDS_INIT_SIZE 1024
+
+static const char *ALLOC_SITE_NAMES[ALLOC_SITES_COUNT] = {
+	"labels", "macros", "instruction words", "data words", "fixups", "lines",
+	"messages", "file names", "buffers", "arena blocks", "tables"
+};
+
+/* a block of heap memory that was not freed yet */
+typedef struct heap_record {
+	void *ptr;              /* the memory, NULL in an empty slot */
+	size_t size;
+	int site;
+	alloc_profile *owner;   /* the profile of the file it was allocated for, NULL if there is none or the file is done */
+	long file;              /* the file of that profile */
+} heap_record;
+
+int alloc_profiling = 0;
+
+/* the threads of a batch share the records and the totals, the lock guards them and every profile */
+static pthread_mutex_t profile_lock = PTHREAD_MUTEX_INITIALIZER;
+static heap_record *records = NULL;
+static size_t record_capacity = 0;
+static size_t record_count = 0;
+static alloc_profile totals;
+static long file_count = 0;
+
+static pthread_key_t profile_key;
+static pthread_once_t profile_once = PTHREAD_ONCE_INIT;
+
+static void create_profile_key(void) {
+	pthread_key_create(&profile_key, NULL);
+}
+
+void enable_alloc_profile(void) {
+	pthread_once(&profile_once, create_profile_key);
+	memset(&totals, 0, sizeof(totals));
+	alloc_profiling = 1;
+}
+
+alloc_profile *current_alloc_profile(void) {
+	pthread_once(&profile_once, create_profile_key);
+	return pthread_getspecific(profile_key);
+}
+
+void use_alloc_profile(alloc_profile *profile) {
+	pthread_once(&profile_once, create_profile_key);
+	pthread_setspecific(profile_key, profile);
+}
+
+static void charge(alloc_site_stats *stats, size_t size) {
+	stats->calls++;
+	stats->bytes += size;
+	stats->live_bytes += size;
+	if (stats->live_bytes > stats->peak_bytes) {
+		stats->peak_bytes = stats->live_bytes;
+	}
+}
+
+/* a file can give back more than it took, from an arena that was reset by a later file */
+static void release(alloc_site_stats *stats, size_t size) {
+	stats->live_bytes = (stats->live_bytes > size) ? stats->live_bytes - size : 0;
+}
+
+/* the slot of a pointer, or the empty slot where it would be */
+static size_t find_record(void *ptr) {
+	size_t slot = (((size_t)ptr >> 4) * 2654435761UL) & (record_capacity - 1);
+
+	while (records[slot].ptr != NULL && records[slot].ptr != ptr) {
+		slot = (slot + 1) & (record_capacity - 1);
+	}
+	return slot;
+}
+
+/* the records are kept with malloc itself, so they are not counted */
+static void grow_records(void) {
+	heap_record *old = records;
+	size_t old_capacity = record_capacity;
+	size_t i;
+
+	record_capacity = (record_capacity == 0) ? RECORDS_INIT_SIZE : record_capacity * 2;
+	records = calloc(record_capacity, sizeof(heap_record));
+	if (records == NULL) {
+		fprintf(stderr, "Error: malloc failed\n");
+		exit(EXIT_FAILURE);
+	}
+	for (i = 0; i < old_capacity; i++) {
+		if (old[i].ptr != NULL) {
+			records[find_record(old[i].ptr)] = old[i];
+		}
+	}
+	free(old);
+}
+
+/* takes a record out of the table, the records after it move back so no search stops early */
+static void remove_record(size_t slot) {
+	size_t next = slot, home;
+
+	records[slot].ptr = NULL;
+	record_count--;
+	for (;;) {
+		next = (next + 1) & (record_capacity - 1);
+		if (records[next].ptr == NULL) {
+			return;
+		}
+		home = (((size_t)records[next].ptr >> 4) * 2654435761UL) & (record_capacity - 1);
+		/* the record stays if its home is in the cyclic range (slot, next] */
+		if ((slot < next) ? (home > slot && home <= next) : (home > slot || home <= next)) {
+			continue;
+		}
+		records[slot] = records[next];
+		records[next].ptr = NULL;
+		slot = next;
+	}
+}
+
+static void add_record(void *ptr, size_t size, int site) {
+	alloc_profile *profile = current_alloc_profile();
+	heap_record *record;
+
+	if ((record_count + 1) * 2 > record_capacity) {
+		grow_records();
+	}
+	record = &records[find_record(ptr)];
+	record->ptr = ptr;
+	record->size = size;
+	record->site = site;
+	record->owner = profile;
+	record->file = (profile != NULL) ? profile->file : 0;
+	record_count++;
+	charge(&totals.sites[site], size);
+	if (profile != NULL) {
+		charge(&profile->sites[site], size);
+	}
+}
+
+/* the memory is no longer live, in the totals and in the file it was allocated for */
+static void drop_record(void *ptr) {
+	heap_record *record;
+	size_t slot;
+
+	if (ptr == NULL || record_capacity == 0) {
+		return;
+	}
+	slot = find_record(ptr);
+	record = &records[slot];
+	if (record->ptr == NULL) {
+		return;
+	}
+	release(&totals.sites[record->site], record->size);
+	if (record->owner != NULL && record->owner->file == record->file) {
+		release(&record->owner->sites[record->site], record->size);
+	}
+	remove_record(slot);
+}
+
+void profile_alloc(void *ptr, size_t size, int site) {
+	pthread_mutex_lock(&profile_lock);
+	add_record(ptr, size, site);
+	pthread_mutex_unlock(&profile_lock);
+}
+
+void profile_free(void *ptr) {
+	pthread_mutex_lock(&profile_lock);
+	drop_record(ptr);
+	pthread_mutex_unlock(&profile_lock);
+}
+
+void profile_arena_alloc(arena *memory, size_t size, int site) {
+	alloc_profile *profile = current_alloc_profile();
+
+	pthread_mutex_lock(&profile_lock);
+	/* the bytes of an arena are given back to the last file that took from it */
+	if (profile != NULL) {
+		memory->profile = profile;
+		memory->profile_file = profile->file;
+		charge(&profile->sites[site], size);
+	}
+	charge(&totals.sites[site], size);
+	memory->site_bytes[site] += size;
+	pthread_mutex_unlock(&profile_lock);
+}
+
+void profile_arena_release(arena *memory) {
+	int i;
+
+	pthread_mutex_lock(&profile_lock);
+	for (i = 0; i < ALLOC_SITES_COUNT; i++) {
+		release(&totals.sites[i], memory->site_bytes[i]);
+		if (memory->profile != NULL && memory->profile->file == memory->profile_file) {
+			release(&memory->profile->sites[i], memory->site_bytes[i]);
+		}
+		memory->site_bytes[i] = 0;
+	}
+	memory->profile = NULL;
+	pthread_mutex_unlock(&profile_lock);
+}
+
+void begin_alloc_profile(alloc_profile *profile) {
+	pthread_mutex_lock(&profile_lock);
+	memset(profile->sites, 0, sizeof(profile->sites));
+	profile->file = ++file_count;
+	pthread_mutex_unlock(&profile_lock);
+	use_alloc_profile(profile);
+}
+
+/* prints the counts of the sites that allocated, they were copied so report can allocate without the lock */
+static void report_sites(alloc_site_stats *sites) {
+	int i;
+
+	report("  %-18s %10s %12s %12s %12s\n", "site", "calls", "bytes", "peak bytes", "live bytes");
+	for (i = 0; i < ALLOC_SITES_COUNT; i++) {
+		if (sites[i].calls > 0 || sites[i].live_bytes > 0) {
+			report("  %-18s %10ld %12lu %12lu %12lu\n", ALLOC_SITE_NAMES[i], sites[i].calls, sites[i].bytes,
+				sites[i].peak_bytes, sites[i].live_bytes);
+		}
+	}
+}
+
+void end_alloc_profile(alloc_profile *profile, char *name) {
+	alloc_site_stats sites[ALLOC_SITES_COUNT];
+	long live = 0;
+	unsigned long live_bytes = 0;
+	size_t i;
+
+	use_alloc_profile(NULL);
+	pthread_mutex_lock(&profile_lock);
+	/* the memory of the file that is still live is no longer counted with it once it is freed */
+	for (i = 0; i < record_capacity; i++) {
+		if (records[i].ptr != NULL && records[i].owner == profile && records[i].file == profile->file) {
+			live++;
+			live_bytes += records[i].size;
+			records[i].owner = NULL;
+		}
+	}
+	memcpy(sites, profile->sites, sizeof(sites));
+	pthread_mutex_unlock(&profile_lock);
+
+	report("Allocations of %s:\n", name);
+	report_sites(sites);
+	report("  still live after the file: %ld heap allocations, %lu bytes\n", live, live_bytes);
+}
+
+void report_alloc_totals(void) {
+	alloc_site_stats sites[ALLOC_SITES_COUNT];
+	long live;
+
+	pthread_mutex_lock(&profile_lock);
+	memcpy(sites, totals.sites, sizeof(sites));
+	live = (long)record_count;
+	pthread_mutex_unlock(&profile_lock);
+
+	report("Allocations of the run:\n");
+	report_sites(sites);
+	report("  still live at the end: %ld heap allocations\n", live);
+}
@@ -0,0 +1,88 @@
+#ifndef LABRATORY_C_FINAL_PROJECT_ALLOC_PROFILE_H
+#define LABRATORY_C_FINAL_PROJECT_ALLOC_PROFILE_H
+
+#include "globals.h"
+
+/* 1 once enable_alloc_profile was called, the allocation functions check it before they count anything */
+extern int alloc_profiling;
+
+/**
+ * @brief Turns the allocation profiler on for the rest of the run.
+ *
+ * It has to be called before the memory that is profiled is allocated, a pointer that was allocated
+ * before is not known to the profiler and its free is ignored.
+ */
+void enable_alloc_profile(void);
+
+/**
+ * @brief Counts an allocation from the heap, a reallocation is counted as a free and an allocation.
+ *
+ * @param ptr The memory that was allocated.
+ * @param size The number of bytes.
+ * @param site The site of the allocation, by enum alloc_site.
+ */
+void profile_alloc(void *ptr, size_t size, int site);
+
+/**
+ * @brief Counts the free of memory from the heap.
+ *
+ * @param ptr The memory, a pointer the profiler does not know is ignored.
+ */
+void profile_free(void *ptr);
+
+/**
+ * @brief Counts memory taken from an arena, it stays live until the arena is reset.
+ *
+ * @param memory The arena.
+ * @param size The number of bytes, with their alignment.
+ * @param site The site of the allocation, by enum alloc_site.
+ */
+void profile_arena_alloc(arena *memory, size_t size, int site);
+
+/**
+ * @brief Counts the memory of an arena as given back, when the arena is reset or freed.
+ *
+ * @param memory The arena.
+ */
+void profile_arena_release(arena *memory);
+
+/**
+ * @brief Starts counting the allocations of the calling thread in the profile of a file.
+ *
+ * @param profile The profile, its counts are set to zero.
+ */
+void begin_alloc_profile(alloc_profile *profile);
+
+/**
+ * @brief Returns the profile the allocations of the calling thread are counted in.
+ *
+ * @return The profile, or NULL if the thread is not assembling a file.
+ */
+alloc_profile *current_alloc_profile(void);
+
+/**
+ * @brief Counts the allocations of the calling thread in a profile that another thread began,
+ * a thread that reads a chunk of a file counts its allocations with the file.
+ *
+ * @param profile The profile, or NULL to stop counting the allocations of the thread in a profile.
+ */
+void use_alloc_profile(alloc_profile *profile);
+
+/**
+ * @brief Stops the profile of a file and prints it through report, with the memory of the file that is still live.
+ *
+ * Every site that allocated shows its calls, its bytes, the most bytes it held at once and the bytes it still
+ * holds. Memory that is still live after the file was allocated for it and not freed: the buffers a worker
+ * keeps for the next file, or a leak.
+ *
+ * @param profile The profile.
+ * @param name The name of the file.
+ */
+void end_alloc_profile(alloc_profile *profile, char *name);
+
+/**
+ * @brief Prints the allocations of the whole run by their site, with the memory that is still live.
+ */
+void report_alloc_totals(void);
+
+#endif
@@ -0,0 +1,114 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "globals.h"
+#include "arena.h"
+#include "pre_assembler.h"
+#include "alloc_profile.h"
+
+/* the strictest alignment of the types that are kept in an arena */
+typedef union arena_align {
+	long l;
+	double d;
+	void *p;
+} arena_align;
+
+#define ALIGN_UP(size) (((size) + sizeof(arena_align) - 1) / sizeof(arena_align) * sizeof(arena_align))
+
+/* the bytes of a block start after its header */
+#define BLOCK_DATA(block) ((char *)(block) + ALIGN_UP(sizeof(arena_block)))
+
+void init_arena(arena *memory) {
+	memory->first = NULL;
+	memory->current = NULL;
+	memory->used = 0;
+	memory->reserved = 0;
+	memset(memory->site_bytes, 0, sizeof(memory->site_bytes));
+	memory->profile = NULL;
+	memory->profile_file = 0;
+}
+
+/* makes the block after the current one, or a new block, the current block */
+static void next_block(arena *memory, size_t size) {
+	arena_block *block;
+	arena_block *current = memory->current;
+
+	/* the blocks of the files before the last reset are used again in order */
+	if (current != NULL && current->next != NULL && current->next->size >= size) {
+		memory->current = current->next;
+		memory->current->used = 0;
+		return;
+	}
+	if (size < ARENA_BLOCK_SIZE) {
+		size = ARENA_BLOCK_SIZE;
+	}
+	block = handle_malloc(ALIGN_UP(sizeof(arena_block)) + size, ALLOC_ARENA_BLOCKS);
+	block->size = size;
+	block->used = 0;
+	/* a new block goes right after the current one, the blocks after it are kept for later */
+	if (current == NULL) {
+		block->next = memory->first;
+		memory->first = block;
+	}
+	else {
+		block->next = current->next;
+		current->next = block;
+	}
+	memory->current = block;
+	memory->reserved += size;
+}
+
+void *arena_alloc(arena *memory, size_t size, int site) {
+	arena_block *block = memory->current;
+	void *ptr;
+
+	size = ALIGN_UP(size);
+	if (block == NULL || block->size - block->used < size) {
+		next_block(memory, size);
+		block = memory->current;
+	}
+	ptr = BLOCK_DATA(block) + block->used;
+	block->used += size;
+	memory->used += size;
+	if (alloc_profiling) {
+		profile_arena_alloc(memory, size, site);
+	}
+	return ptr;
+}
+
+char *arena_strndup(arena *memory, const char *str, size_t length, int site) {
+	char *copy = arena_alloc(memory, length + 1, site);
+	memcpy(copy, str, length);
+	copy[length] = '\0';
+	return copy;
+}
+
+void reset_arena(arena *memory) {
+	memory->current = memory->first;
+	if (memory->first != NULL) {
+		memory->first->used = 0;
+	}
+	memory->used = 0;
+	if (alloc_profiling) {
+		profile_arena_release(memory);
+	}
+}
+
+void free_arena(arena *memory) {
+	arena_block *block = memory->first;
+	arena_block *next;
+
+	if (alloc_profiling) {
+		profile_arena_release(memory);
+	}
+	while (block != NULL) {
+		next = block->next;
+		handle_free(block);
+		block = next;
+	}
+	init_arena(memory);
+}
+
+size_t arena_bytes_used(arena *memory) {
+	return memory->used;
+}
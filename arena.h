@@ -0,0 +1,64 @@
+#ifndef LABRATORY_C_FINAL_PROJECT_ARENA_H
+#define LABRATORY_C_FINAL_PROJECT_ARENA_H
+
+#include "globals.h"
+
+/**
+ * @brief Initializes an empty arena, no memory is taken until the first allocation.
+ *
+ * @param memory The arena to initialize.
+ */
+void init_arena(arena *memory);
+
+/**
+ * @brief Takes memory from an arena.
+ *
+ * The memory is taken from the current block by moving a pointer forward. A new block is added
+ * only when the current one is full and the next one, kept from before a reset, is too small.
+ * The memory is aligned for any type and it cannot be freed on its own, only by reset_arena.
+ * The program exits if a block cannot be allocated.
+ *
+ * @param memory The arena.
+ * @param size The number of bytes to take.
+ * @param site What the memory is for, by enum alloc_site, it is counted there when the allocations are profiled.
+ * @return A pointer to the memory.
+ */
+void *arena_alloc(arena *memory, size_t size, int site);
+
+/**
+ * @brief Copies the first characters of a string into an arena.
+ *
+ * @param memory The arena.
+ * @param str The string to copy, it does not have to end with '\0'.
+ * @param length The number of characters to copy.
+ * @param site What the copy is for, by enum alloc_site.
+ * @return The copy, ending with '\0'.
+ */
+char *arena_strndup(arena *memory, const char *str, size_t length, int site);
+
+/**
+ * @brief Gives back all the memory taken from an arena, in constant time.
+ *
+ * The blocks are kept and used again by the next allocations, so assembling many files
+ * does not allocate more memory than the largest of them needs.
+ *
+ * @param memory The arena.
+ */
+void reset_arena(arena *memory);
+
+/**
+ * @brief Releases the blocks of an arena, the arena is left empty and can be used again.
+ *
+ * @param memory The arena.
+ */
+void free_arena(arena *memory);
+
+/**
+ * @brief Returns the number of bytes taken from an arena since it was last reset, with their alignment.
+ *
+ * @param memory The arena.
+ * @return The number of bytes.
+ */
+size_t arena_bytes_used(arena *memory);
+
+#endif
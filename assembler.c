@@ -2,38 +2,173 @@
 #include <stdlib.h>
 #include <string.h>
 #include "pre_assembler.h"
-#include "first_pass.h"
+#include "cache.h"
+#include "batch.h"
+#include "server.h"
 #include "globals.h"
+#include "alloc_profile.h"
 
 int main(int argc, char* argv[]) {
-	char* as_file, * am_file;
-	node *head= NULL;
-	while (--argc) {
-		/* Generate a new file with the ".as" extension by adding it to the input filename.*/
-		printf("Start pre_assembler\n");
-		as_file = add_new_file(argv[argc], ".as");
-		/*Execute the macro preprocessor on the ".as" file.*/
-		if (!implement_macro(as_file,&head)) {
-			/*If it failed, move to the next file.*/
-			printf(" The process was not completed, the file: %s is not correct\n",as_file);
-			continue;
+	char** names;
+	int count = 0;
+	result_cache cache;
+	char* cache_dir = NULL;
+	long cache_max_size = CACHE_DEFAULT_MAX_SIZE;
+	char options_key[96];
+	assembler_options options;
+	batch_worker worker;
+	assembler_server server;
+	char* serve_path = NULL;
+	char* client_path = NULL;
+	char* watch_dirs[MAX_WATCHED_DIRS];
+	int watch_count = 0;
+	int stop_server = 0;
+	int i;
+
+	options.emit_am = 0;
+	options.emit_obb = 0;
+	options.max_line_length = 0; /* lines of any length are accepted unless a limit is asked for */
+	options.memory_report = 0;
+	options.jobs = 1;
+	options.pass_threads = 1;
+	options.stats = STATS_OFF;
+	options.alloc_profile = 0;
+
+	/* Options may appear anywhere among the file names, they are removed from argv */
+	for (i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--emit-am") == 0) {
+			options.emit_am = 1;
+		}
+		else if (strcmp(argv[i], "--emit-obb") == 0) {
+			options.emit_obb = 1;
+		}
+		else if (strcmp(argv[i], "--strict") == 0) {
+			options.max_line_length = MAX_LINE_LENGTH;
+		}
+		else if (strncmp(argv[i], "--max-line-length=", 18) == 0) {
+			options.max_line_length = atol(argv[i] + 18);
+		}
+		else if (strncmp(argv[i], "--cache-dir=", 12) == 0) {
+			cache_dir = argv[i] + 12;
+		}
+		else if (strncmp(argv[i], "--cache-max-size=", 17) == 0) {
+			cache_max_size = atol(argv[i] + 17);
+		}
+		else if (strcmp(argv[i], "--memory-report") == 0) {
+			options.memory_report = 1;
 		}
-		printf("Start first pass\n");
-		/*Generate a new file with the ".am" extension by adding it to the input filename.*/
-		am_file = add_new_file(argv[argc], ".am");
-		/*Execute the first pass, and then the second on the ".am" file.*/
-		if (!implement_first_pass(am_file,&head)) {
-			printf("The process was not completed, the file: %s is not correct\n", am_file);
-			/*If it failed, move to the next file.*/
+		else if (strcmp(argv[i], "--stats") == 0 || strcmp(argv[i], "--stats=text") == 0) {
+			options.stats = STATS_TEXT;
+		}
+		else if (strcmp(argv[i], "--stats=json") == 0) {
+			options.stats = STATS_JSON;
+		}
+		else if (strcmp(argv[i], "--alloc-profile") == 0) {
+			options.alloc_profile = 1;
+		}
+		else if (strncmp(argv[i], "--serve=", 8) == 0) {
+			serve_path = argv[i] + 8;
+		}
+		else if (strncmp(argv[i], "--watch=", 8) == 0) {
+			if (watch_count == MAX_WATCHED_DIRS) {
+				fprintf(stderr, "Error: at most %d directories can be watched: %s\n", MAX_WATCHED_DIRS, argv[i]);
+				return 1;
+			}
+			watch_dirs[watch_count++] = argv[i] + 8;
+		}
+		else if (strncmp(argv[i], "--client=", 9) == 0) {
+			client_path = argv[i] + 9;
+		}
+		else if (strcmp(argv[i], "--shutdown") == 0) {
+			stop_server = 1;
+		}
+		else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+			/* the number of threads is the next argument */
+			argv[i++] = NULL;
+			options.jobs = atoi(argv[i]);
+		}
+		else if (strncmp(argv[i], "-j", 2) == 0) {
+			options.jobs = atoi(argv[i] + 2);
+		}
+		else if (strncmp(argv[i], "--", 2) != 0) {
 			continue;
 		}
+		else {
+			/* a mistyped option would otherwise change what is assembled without a word */
+			fprintf(stderr, "Error: unknown option: %s\n", argv[i]);
+			return 1;
+		}
+		argv[i] = NULL;
+	}
+	if (options.jobs < 1) {
+		options.jobs = 1;
+	}
+	/* The profiler has to see every allocation from here on, to know when its memory is freed */
+	if (options.alloc_profile) {
+		enable_alloc_profile();
+	}
+	/* The options that change the output files are part of the cache key */
+	sprintf(options_key, "emit-am=%d emit-obb=%d max-line-length=%ld", options.emit_am, options.emit_obb, options.max_line_length);
+	if (cache_dir != NULL && !cache_open(&cache, cache_dir, cache_max_size)) {
+		cache_dir = NULL;
+	}
 
-		/*Free allocated memory*/
-      free(am_file); 
-
-		free(as_file);
-
+	/* The files are assembled from the last one on the command line to the first */
+	names = handle_malloc(argc * sizeof(char*), ALLOC_TABLES);
+	while (--argc) {
+		if (argv[argc] != NULL) {
+			names[count++] = argv[argc];
+		}
+	}
+	if (client_path != NULL) {
+		/* A running server assembles the files, its answer is printed as if they were assembled here */
+		run_client(client_path, names, count, stop_server);
+		count = 0;
+	}
+	else if (serve_path != NULL) {
+		/* The server assembles one file at a time, the threads share the first pass of each file */
+		options.pass_threads = options.jobs;
+		init_server(&server, &options, options_key, (cache_dir != NULL) ? &cache : NULL);
+		serve(&server, serve_path, watch_dirs, watch_count);
+		if (cache_dir != NULL) {
+			cache.hits += server.worker.cache.hits;
+			cache.misses += server.worker.cache.misses;
+		}
+		free_server(&server);
+		count = 0;
+	}
+	/* A single file is split among the threads instead, the lines of its first pass are read in chunks */
+	if (options.jobs > 1 && count == 1 && serve_path == NULL) {
+		options.pass_threads = options.jobs;
+		options.jobs = 1;
+	}
+	if (count == 0) {
+		/* Nothing is left to assemble */
+	}
+	else if (options.jobs > 1) {
+		/* Every thread has an arena of its own, the messages are printed in the same order as without threads */
+		run_batch(names, count, options.jobs, &options, options_key, (cache_dir != NULL) ? &cache : NULL);
+	}
+	else {
+		/* The macros, the labels and the memory images of a file are kept in one arena, which is reset after the file */
+		init_batch_worker(&worker, 0, &options, options_key, (cache_dir != NULL) ? &cache : NULL);
+		for (i = 0; i < count; i++) {
+			assemble_file(names[i], &worker);
+		}
+		if (cache_dir != NULL) {
+			cache.hits += worker.cache.hits;
+			cache.misses += worker.cache.misses;
+		}
+		free_batch_worker(&worker);
+	}
+	handle_free(names);
+	if (cache_dir != NULL) {
+		cache_evict(&cache);
+		cache_close(&cache);
+	}
+	if (options.alloc_profile) {
+		report_alloc_totals();
 	}
 	printf("end\n");
 	return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,375 @@
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include "globals.h"
+#include "batch.h"
+#include "pre_assembler.h"
+#include "libassembler.h"
+#include "file_reader.h"
+#include "cache.h"
+#include "arena.h"
+#include "report.h"
+#include "stats.h"
+#include "alloc_profile.h"
+
+extern char *CACHED_ENDINGS[];
+
+/* The tasks of one thread, a task is the first job of a file. The owner takes tasks from the head
+ * and the other threads steal from the tail, so they meet only when the queue is almost empty. */
+typedef struct task_queue {
+	int *tasks;
+	int head;
+	int tail;
+	pthread_mutex_t lock;
+} task_queue;
+
+/* The state that the threads of a batch share */
+typedef struct batch_pool {
+	batch_job *jobs;
+	task_queue *queues;
+	batch_worker *workers;
+	int threads;
+	pthread_mutex_t lock;   /* guards the done flags of the jobs */
+	pthread_cond_t finished;
+} batch_pool;
+
+/* The argument of a thread */
+typedef struct batch_thread {
+	batch_pool *pool;
+	int id;
+} batch_thread;
+
+void init_batch_worker(batch_worker *worker, int id, assembler_options *options, char *options_key, result_cache *cache) {
+	worker->id = id;
+	init_arena(&worker->memory);
+	init_assembly_result(&worker->result);
+	worker->use_cache = (cache != NULL);
+	if (cache != NULL) {
+		worker->cache = *cache;
+		worker->cache.hits = 0;
+		worker->cache.misses = 0;
+		worker->cache.stores = 0;
+		worker->cache.worker = id;
+	}
+	worker->options = options;
+	worker->options_key = options_key;
+}
+
+/* writes an output file at once, a regular file takes the whole buffer in one write */
+static int write_output_file(char *file_name, byte_buffer *content) {
+	size_t written = 0;
+	ssize_t count;
+	int fd;
+
+	fd = open(file_name, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (fd < 0) {
+		report("Failed to open file: %s\n", file_name);
+		return 0;
+	}
+	/* the loop only covers a short write */
+	while (written < content->length) {
+		count = write(fd, content->data + written, content->length - written);
+		if (count < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			report("Failed to write file: %s\n", file_name);
+			close(fd);
+			return 0;
+		}
+		written += (size_t)count;
+	}
+	if (close(fd) != 0) {
+		report("Failed to write file: %s\n", file_name);
+		return 0;
+	}
+	return 1;
+}
+
+/* writes the output files of a result next to the source, and removes the ones it did not produce */
+static int write_outputs(char *name, assembly_result *result, assembler_options *options) {
+	char *output;
+	int i, ok = 1;
+
+	for (i = 0; i < CACHED_ENDINGS_COUNT; i++) {
+		output = add_new_file(name, CACHED_ENDINGS[i]);
+		if (result->has_output[i]) {
+			ok = write_output_file(output, &result->outputs[i]) && ok;
+		}
+		else if ((i == OUTPUT_AM) ? options->emit_am : result->is_valid) {
+			/* an .am file of a source with pre-assembler errors, or an empty .ent or .ext file */
+			remove(output);
+		}
+		handle_free(output);
+	}
+	return ok;
+}
+
+/* restores a file from the cache, or assembles it and writes its output files, returns 1 if it was assembled */
+static int assemble_one_file(char *name, batch_worker *worker) {
+	char *as_file, *am_file;
+	input_file input;
+	assembly_result *result = &worker->result;
+	long read_time = 0, start = 0;
+	int i;
+
+	/* Generate a new file with the ".as" extension by adding it to the input filename.*/
+	report("Start pre_assembler\n");
+	as_file = add_new_file(name, ".as");
+	/*An unchanged file that was assembled before is restored from the cache.*/
+	if (worker->use_cache && cache_key(&worker->cache, as_file, worker->options_key) && cache_restore(&worker->cache, name)) {
+		report("Restored from the cache: %s\n", as_file);
+		handle_free(as_file);
+		return 0;
+	}
+	/*Read the ".as" file, the passes work on its content in memory.*/
+	if (worker->options->stats != STATS_OFF) {
+		read_time = stats_clock();
+	}
+	if (!open_input(as_file, &input)) {
+		report("Error opening original file\n");
+		/*If it failed, move to the next file.*/
+		report(" The process was not completed, the file: %s is not correct\n", as_file);
+		handle_free(as_file);
+		return 0;
+	}
+	report("Start first pass\n");
+	/*The output files are named after the ".am" file, even when it is not written to the disk.*/
+	am_file = add_new_file(name, ".am");
+	/*Run the pre-assembler and both passes, and then print their messages and write the files they produced.*/
+	if (worker->options->stats != STATS_OFF) {
+		read_time = stats_clock() - read_time;
+	}
+	assemble_source(input.data, input.size, worker->options, &worker->memory, result);
+	close_input(&input);
+	result->stats.nanoseconds[STATS_READ] = read_time;
+	if (result->diag.out.length > 0) {
+		report_kept(&result->diag, 0, 0, result->diag.out.length);
+	}
+	if (result->diag.err.length > 0) {
+		report_kept(&result->diag, 1, 0, result->diag.err.length);
+	}
+	if (result->is_valid) {
+		report("File closed: %s\n", am_file);
+	}
+	if (worker->options->stats != STATS_OFF) {
+		start = stats_clock();
+	}
+	if (!write_outputs(name, result, worker->options) || !result->is_valid) {
+		report("The process was not completed, the file: %s is not correct\n", am_file);
+	}
+	else if (worker->use_cache) {
+		cache_store(&worker->cache, name);
+	}
+	if (worker->options->stats != STATS_OFF) {
+		result->stats.nanoseconds[STATS_WRITE] = stats_clock() - start;
+		for (i = 0; i < CACHED_ENDINGS_COUNT; i++) {
+			result->stats.bytes_written += result->has_output[i] ? (long)result->outputs[i].length : 0;
+		}
+		report_stats(as_file, &result->stats, worker->options->stats);
+	}
+
+	/*Free allocated memory*/
+	if (worker->options->memory_report) {
+		report("Memory used by %s: %lu bytes\n", as_file, (unsigned long)arena_bytes_used(&worker->memory));
+	}
+	reset_arena(&worker->memory);
+	handle_free(am_file);
+	handle_free(as_file);
+	return 1;
+}
+
+int assemble_file(char *name, batch_worker *worker) {
+	int assembled;
+
+	if (!worker->options->alloc_profile) {
+		return assemble_one_file(name, worker);
+	}
+	/* the profile ends after the arena was reset and the names were freed, what is left is kept past the file */
+	begin_alloc_profile(&worker->profile);
+	assembled = assemble_one_file(name, worker);
+	end_alloc_profile(&worker->profile, name);
+	return assembled;
+}
+
+void free_batch_worker(batch_worker *worker) {
+	free_arena(&worker->memory);
+	free_assembly_result(&worker->result);
+}
+
+/* returns the size of the source file of a job, or -1 if it cannot be read */
+static long source_size(char *name) {
+	struct stat st;
+	char *as_file = add_new_file(name, ".as");
+	long size = (stat(as_file, &st) == 0) ? (long)st.st_size : -1;
+	handle_free(as_file);
+	return size;
+}
+
+/* takes the next task of a thread, from its own queue or from the queue of another thread, or returns -1 */
+static int next_task(batch_pool *pool, int id) {
+	task_queue *queue = &pool->queues[id];
+	int task = -1;
+	int i;
+
+	pthread_mutex_lock(&queue->lock);
+	if (queue->head < queue->tail) {
+		task = queue->tasks[queue->head++];
+	}
+	pthread_mutex_unlock(&queue->lock);
+
+	for (i = 1; task == -1 && i < pool->threads; i++) {
+		queue = &pool->queues[(id + i) % pool->threads];
+		pthread_mutex_lock(&queue->lock);
+		if (queue->head < queue->tail) {
+			task = queue->tasks[--queue->tail];
+		}
+		pthread_mutex_unlock(&queue->lock);
+	}
+	return task;
+}
+
+static void *batch_thread_main(void *arg) {
+	batch_thread *thread = arg;
+	batch_pool *pool = thread->pool;
+	batch_worker *worker = &pool->workers[thread->id];
+	batch_job *job;
+	int task;
+
+	/* the queues are filled before the threads start and tasks are never added, so an empty pass means the end */
+	while ((task = next_task(pool, thread->id)) != -1) {
+		for (; task != -1; task = job->next_same) {
+			job = &pool->jobs[task];
+			capture_reports(&job->diag);
+			assemble_file(job->name, worker);
+			capture_reports(NULL);
+
+			pthread_mutex_lock(&pool->lock);
+			job->done = 1;
+			pthread_cond_broadcast(&pool->finished);
+			pthread_mutex_unlock(&pool->lock);
+		}
+	}
+	return NULL;
+}
+
+/* orders the first jobs of the files by the size of the file, largest first */
+static int compare_jobs_by_size(const void *a, const void *b) {
+	const batch_job *first = *(batch_job *const *)a, *second = *(batch_job *const *)b;
+	if (first->size != second->size) {
+		return (first->size > second->size) ? -1 : 1;
+	}
+	/* equal sizes keep the order of the jobs */
+	return (first < second) ? -1 : 1;
+}
+
+void run_batch(char **names, int count, int threads, assembler_options *options, char *options_key, result_cache *cache) {
+	batch_pool pool;
+	batch_thread *args;
+	pthread_t *ids;
+	batch_job **tasks;
+	char **paths;
+	int task_count = 0;
+	int i, j;
+
+	if (threads > count) {
+		threads = count;
+	}
+	if (threads < 1) {
+		return;
+	}
+	pool.jobs = handle_malloc(count * sizeof(batch_job), ALLOC_TABLES);
+	tasks = handle_malloc(count * sizeof(batch_job *), ALLOC_TABLES);
+	paths = handle_malloc(count * sizeof(char *), ALLOC_TABLES);
+	for (i = 0; i < count; i++) {
+		pool.jobs[i].name = names[i];
+		pool.jobs[i].next_same = -1;
+		pool.jobs[i].done = 0;
+		init_diagnostics(&pool.jobs[i].diag);
+		/* a file named again, by any path, is chained to its last job, they write the same output files */
+		paths[i] = canonical_path(".", names[i]);
+		for (j = i - 1; j >= 0 && strcmp(paths[j], paths[i]) != 0; j--)
+			;
+		if (j >= 0) {
+			pool.jobs[j].next_same = i;
+			pool.jobs[i].size = pool.jobs[j].size;
+		}
+		else {
+			pool.jobs[i].size = source_size(names[i]);
+			tasks[task_count++] = &pool.jobs[i];
+		}
+	}
+	for (i = 0; i < count; i++) {
+		handle_free(paths[i]);
+	}
+	handle_free(paths);
+	/* the largest files start first, so a large file is not left for the end when the other threads are idle */
+	qsort(tasks, task_count, sizeof(batch_job *), compare_jobs_by_size);
+
+	pool.threads = threads;
+	pool.queues = handle_malloc(threads * sizeof(task_queue), ALLOC_TABLES);
+	pool.workers = handle_malloc(threads * sizeof(batch_worker), ALLOC_TABLES);
+	args = handle_malloc(threads * sizeof(batch_thread), ALLOC_TABLES);
+	ids = handle_malloc(threads * sizeof(pthread_t), ALLOC_TABLES);
+	pthread_mutex_init(&pool.lock, NULL);
+	pthread_cond_init(&pool.finished, NULL);
+	for (i = 0; i < threads; i++) {
+		pool.queues[i].tasks = handle_malloc(count * sizeof(*pool.queues[i].tasks), ALLOC_TABLES);
+		pool.queues[i].head = 0;
+		pool.queues[i].tail = 0;
+		pthread_mutex_init(&pool.queues[i].lock, NULL);
+		init_batch_worker(&pool.workers[i], i + 1, options, options_key, cache);
+	}
+	/* the tasks are dealt in turns, so every queue also starts with its largest file */
+	for (i = 0; i < task_count; i++) {
+		task_queue *queue = &pool.queues[i % threads];
+		queue->tasks[queue->tail++] = (int)(tasks[i] - pool.jobs);
+	}
+	for (i = 0; i < threads; i++) {
+		args[i].pool = &pool;
+		args[i].id = i;
+		if (pthread_create(&ids[i], NULL, batch_thread_main, &args[i]) != 0) {
+			fprintf(stderr, "Error: failed to start a thread\n");
+			exit(1);
+		}
+	}
+	/* the messages of a file are printed once it and all the files before it are done */
+	for (i = 0; i < count; i++) {
+		pthread_mutex_lock(&pool.lock);
+		while (!pool.jobs[i].done) {
+			pthread_cond_wait(&pool.finished, &pool.lock);
+		}
+		pthread_mutex_unlock(&pool.lock);
+		flush_diagnostics(&pool.jobs[i].diag);
+		free_diagnostics(&pool.jobs[i].diag);
+	}
+
+	/* a thread may still look into the queues of the others until it ends, so they are freed after all the threads */
+	for (i = 0; i < threads; i++) {
+		pthread_join(ids[i], NULL);
+	}
+	for (i = 0; i < threads; i++) {
+		if (cache != NULL) {
+			cache->hits += pool.workers[i].cache.hits;
+			cache->misses += pool.workers[i].cache.misses;
+		}
+		free_batch_worker(&pool.workers[i]);
+		pthread_mutex_destroy(&pool.queues[i].lock);
+		handle_free(pool.queues[i].tasks);
+	}
+	pthread_cond_destroy(&pool.finished);
+	pthread_mutex_destroy(&pool.lock);
+	fflush(stdout);
+	handle_free(ids);
+	handle_free(args);
+	handle_free(pool.workers);
+	handle_free(pool.queues);
+	handle_free(tasks);
+	handle_free(pool.jobs);
+}
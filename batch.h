@@ -0,0 +1,76 @@
+#ifndef LABRATORY_C_FINAL_PROJECT_BATCH_H
+#define LABRATORY_C_FINAL_PROJECT_BATCH_H
+
+#include "globals.h"
+#include "cache.h"
+
+/*This struct describes a file of a batch that is assembled by the worker threads*/
+typedef struct batch_job {
+    char *name;         /*The name of the file without its extension, as given on the command line*/
+    long size;          /*The size of the ".as" file, or -1 if it cannot be read*/
+    int next_same;      /*The next job of the same file, or -1, the jobs of a file run one after the other*/
+    int done;           /*1 when the file was assembled and its messages can be printed*/
+    diagnostics diag;   /*The messages of the file*/
+} batch_job;
+
+/*This struct holds the state of a thread that assembles files, nothing in it is shared with other threads*/
+typedef struct batch_worker {
+    int id;                         /*The number of the thread, 0 for the main thread*/
+    arena memory;                   /*The arena of the file being assembled, reset after every file*/
+    assembly_result result;         /*The output files and the messages of the file being assembled*/
+    result_cache cache;             /*A copy of the result cache, with counters of its own*/
+    int use_cache;                  /*1 if the result cache is used*/
+    assembler_options *options;     /*The options of the assembler*/
+    char *options_key;              /*The options that are part of the cache key*/
+    alloc_profile profile;          /*The allocations of the file being assembled, when they are profiled*/
+} batch_worker;
+
+/**
+ * @brief Initializes the state of a thread that assembles files.
+ *
+ * @param worker The worker to initialize.
+ * @param id The number of the thread, 0 for the main thread.
+ * @param options The options of the assembler.
+ * @param options_key The options that are part of the cache key.
+ * @param cache The result cache, or NULL if it is not used. The worker keeps a copy with counters of its own.
+ */
+void init_batch_worker(batch_worker *worker, int id, assembler_options *options, char *options_key, result_cache *cache);
+
+/**
+ * @brief Assembles one source file: restores it from the cache, or runs the pre-assembler and both passes.
+ *
+ * Everything the file needs is taken from the worker, so files of different workers can be assembled at the same time.
+ * When the options ask for an allocation profile, the allocations of the file are printed after its other messages.
+ *
+ * @param name The name of the file without its extension.
+ * @param worker The worker that assembles the file.
+ * @return 1 if the file was assembled and the result of the worker holds its output files, 0 if it was
+ * restored from the cache or its source could not be read.
+ */
+int assemble_file(char *name, batch_worker *worker);
+
+/**
+ * @brief Assembles the files of a batch on a pool of threads.
+ *
+ * The files are handed out largest first, each thread takes them from a queue of its own and steals from
+ * the queues of the others when its queue is empty. The jobs of the same file run one after the other on one
+ * thread. The messages of every file are kept until the files before it are done, so the output is the same
+ * as when the files are assembled one by one in the order of the jobs.
+ *
+ * @param names The names of the files without their extensions, in the order their messages are printed.
+ * @param count The number of files.
+ * @param threads The number of threads.
+ * @param options The options of the assembler.
+ * @param options_key The options that are part of the cache key.
+ * @param cache The result cache, or NULL if it is not used. The counters of the threads are added to it.
+ */
+void run_batch(char **names, int count, int threads, assembler_options *options, char *options_key, result_cache *cache);
+
+/**
+ * @brief Releases the state of a thread that assembles files.
+ *
+ * @param worker The worker to free.
+ */
+void free_batch_worker(batch_worker *worker);
+
+#endif
@@ -0,0 +1,256 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Writes a valid .as file with set numbers of lines, labels, forward references, externals, macros and
+ * macro calls, and set sizes of the .data and .string instructions, for the benchmarks.
+ * Every count is given as --name=N, the counts that are not given follow from the number of lines.
+ * An operand holds an address only up to 4095, so a program that needs more words than fit from address
+ * 100 on is not written: a larger benchmark is split into several files. */
+
+/* The number of registers an operand can name */
+#define CORPUS_REGISTERS 8
+
+/* The words of a program that fit between the first address, 100, and the last address an operand holds, 4095 */
+#define CORPUS_MAX_WORDS 3996
+
+typedef struct corpus_options {
+	long lines;         /* the lines of the whole file */
+	long labels;        /* the labels defined in the body */
+	long forward;       /* the operands that use a label defined below them */
+	long externals;     /* the .extern declarations, each one is used by a jsr */
+	long macros;        /* the macro declarations */
+	long calls;         /* the lines that call a macro */
+	long macro_body;    /* the lines of the body of a macro */
+	long entries;       /* the .entry lines */
+	long data_lines;    /* the .data lines */
+	long data_size;     /* the numbers of a .data line */
+	long string_lines;  /* the .string lines */
+	long string_size;   /* the characters of a .string line */
+	long seed;          /* the start of the random numbers, the same seed writes the same file */
+	long max_words;     /* the most words of code and data the program may have */
+} corpus_options;
+
+static unsigned long seed;
+
+static long next_random(long range) {
+	seed = seed * 1103515245UL + 12345UL;
+	return (long)((seed >> 16) % (unsigned long)range);
+}
+
+/* reads --name=N into a count, returns 0 if the argument is not that option */
+static int read_count(const char *arg, const char *name, long *count) {
+	size_t length = strlen(name);
+	if (strncmp(arg, "--", 2) != 0 || strncmp(arg + 2, name, length) != 0 || arg[2 + length] != '=') {
+		return 0;
+	}
+	*count = atol(arg + 3 + length);
+	return 1;
+}
+
+/* the line of the body where a thing of a kind is placed, the things are spread evenly over the body */
+static long spread(long index, long count, long body) {
+	return (count > 0) ? index * body / count : body;
+}
+
+/* writes an operand of an instruction: a label defined above, a label defined below, or a register after a prefix.
+ * Returns 1 for a register, it shares its word with a register operand next to it */
+static int write_operand(FILE *out, long line, long *next_forward, corpus_options *options, long body, const char *register_prefix) {
+	long first_below, label;
+
+	/* a forward reference names the first label after the line, or a label further down */
+	if (*next_forward < options->forward && spread(*next_forward, options->forward, body) <= line) {
+		(*next_forward)++;
+		first_below = (line + 1) * options->labels / body + 1;
+		if (first_below < options->labels) {
+			label = first_below + next_random(options->labels - first_below);
+			fprintf(out, "L%ld", label);
+			return 0;
+		}
+	}
+	label = line * options->labels / body;
+	if (label > 0 && next_random(2) == 0) {
+		fprintf(out, "L%ld", next_random(label));
+		return 0;
+	}
+	fprintf(out, "%sr%ld", register_prefix, next_random(CORPUS_REGISTERS));
+	return 1;
+}
+
+/* writes the file and returns the number of words of its code and data */
+static long write_corpus(FILE *out, corpus_options *options) {
+	long header = options->externals + options->macros * (options->macro_body + 2) + options->entries + 1;
+	long body = options->lines - header;
+	long line, i, j, words = 0;
+	long next_label = 0, next_call = 0, next_data = 0, next_string = 0, next_extern = 0, next_forward = 0;
+
+	if (body < 1) {
+		body = 1;
+	}
+	seed = (unsigned long)options->seed;
+	fprintf(out, "; lines=%ld labels=%ld forward=%ld externals=%ld macros=%ld calls=%ld macro-body=%ld entries=%ld data=%ldx%ld string=%ldx%ld\n",
+		options->lines, options->labels, options->forward, options->externals, options->macros, options->calls, options->macro_body,
+		options->entries, options->data_lines, options->data_size, options->string_lines, options->string_size);
+	for (i = 0; i < options->externals; i++) {
+		fprintf(out, ".extern X%ld\n", i);
+	}
+	for (i = 0; i < options->macros; i++) {
+		fprintf(out, "macr m%ld\n", i);
+		for (j = 0; j < options->macro_body; j++) {
+			fprintf(out, " add #%ld, r%ld\n", next_random(100), next_random(CORPUS_REGISTERS));
+		}
+		fprintf(out, "endmacr\n");
+	}
+	for (i = 0; i < options->entries; i++) {
+		fprintf(out, ".entry L%ld\n", spread(i, options->entries, options->labels));
+	}
+
+	for (line = 0; line < body; line++) {
+		/* a macro call takes a line of its own, a label due on it moves to the next line */
+		if (next_call < options->calls && spread(next_call, options->calls, body) <= line && options->macros > 0) {
+			fprintf(out, "m%ld\n", next_random(options->macros));
+			/* every line of a body is an add of an immediate to a register, three words */
+			words += 3 * options->macro_body;
+			next_call++;
+			continue;
+		}
+		/* the labels are spread over the body, the label of a line comes before its instruction */
+		if (next_label < options->labels && spread(next_label, options->labels, body) <= line) {
+			fprintf(out, "L%ld: ", next_label++);
+		}
+		if (next_data < options->data_lines && spread(next_data, options->data_lines, body) <= line) {
+			fprintf(out, ".data %ld", next_random(1000) - 500);
+			for (j = 1; j < options->data_size; j++) {
+				fprintf(out, ", %ld", next_random(1000) - 500);
+			}
+			fprintf(out, "\n");
+			words += options->data_size;
+			next_data++;
+		}
+		else if (next_string < options->string_lines && spread(next_string, options->string_lines, body) <= line) {
+			fprintf(out, ".string \"");
+			for (j = 0; j < options->string_size; j++) {
+				fputc('a' + (int)next_random(26), out);
+			}
+			fprintf(out, "\"\n");
+			words += options->string_size + 1;
+			next_string++;
+		}
+		else if (next_extern < options->externals && spread(next_extern, options->externals, body) <= line) {
+			fprintf(out, "jsr X%ld\n", next_extern++);
+			words += 2;
+		}
+		else {
+			switch (next_random(4)) {
+			case 0:
+				fprintf(out, "mov ");
+				words += write_operand(out, line, &next_forward, options, body, "") ? 2 : 3;
+				fprintf(out, ", r%ld\n", next_random(CORPUS_REGISTERS));
+				break;
+			case 1:
+				fprintf(out, "cmp #%ld, ", next_random(1000));
+				write_operand(out, line, &next_forward, options, body, "");
+				fprintf(out, "\n");
+				words += 3;
+				break;
+			case 2:
+				/* a jump takes a label or a register that holds the address */
+				fprintf(out, "jmp ");
+				write_operand(out, line, &next_forward, options, body, "*");
+				fprintf(out, "\n");
+				words += 2;
+				break;
+			default:
+				fprintf(out, "inc r%ld\n", next_random(CORPUS_REGISTERS));
+				words += 2;
+				break;
+			}
+		}
+	}
+	return words;
+}
+
+int main(int argc, char *argv[]) {
+	corpus_options options;
+	long words, code_lines;
+	int i;
+
+	memset(&options, 0, sizeof(options));
+	options.lines = 10000;
+	options.labels = -1;
+	options.forward = -1;
+	options.externals = -1;
+	options.macros = -1;
+	options.calls = -1;
+	options.macro_body = 3;
+	options.entries = -1;
+	options.data_lines = -1;
+	options.data_size = 8;
+	options.string_lines = -1;
+	options.string_size = 16;
+	options.seed = 1;
+	options.max_words = CORPUS_MAX_WORDS;
+
+	for (i = 1; i < argc; i++) {
+		if (!read_count(argv[i], "lines", &options.lines) && !read_count(argv[i], "labels", &options.labels)
+			&& !read_count(argv[i], "forward", &options.forward) && !read_count(argv[i], "externals", &options.externals)
+			&& !read_count(argv[i], "macros", &options.macros) && !read_count(argv[i], "calls", &options.calls)
+			&& !read_count(argv[i], "macro-body", &options.macro_body)
+			&& !read_count(argv[i], "entries", &options.entries) && !read_count(argv[i], "data-lines", &options.data_lines)
+			&& !read_count(argv[i], "data-size", &options.data_size) && !read_count(argv[i], "string-lines", &options.string_lines)
+			&& !read_count(argv[i], "string-size", &options.string_size) && !read_count(argv[i], "seed", &options.seed)
+			&& !read_count(argv[i], "max-words", &options.max_words)) {
+			fprintf(stderr, "usage: %s [--lines=N] [--labels=N] [--forward=N] [--externals=N] [--macros=N] [--calls=N]\n"
+				"       [--macro-body=N] [--entries=N] [--data-lines=N] [--data-size=N] [--string-lines=N] [--string-size=N] [--seed=N]\n"
+				"       [--max-words=N]\n", argv[0]);
+			return 1;
+		}
+	}
+	/* the counts that were not given grow with the file, the ones of the instructions with its lines that
+	 * neither call nor declare a macro */
+	if (options.calls < 0) {
+		options.calls = options.lines / 50;
+	}
+	if (options.macros < 0) {
+		options.macros = 8 + options.lines / 1000;
+	}
+	if (options.macro_body < 0) {
+		options.macro_body = 0;
+	}
+	code_lines = options.lines - options.calls - options.macros * (options.macro_body + 2);
+	if (code_lines < 0) {
+		code_lines = 0;
+	}
+	if (options.labels < 0) {
+		options.labels = code_lines / 8;
+	}
+	if (options.forward < 0) {
+		options.forward = code_lines / 20;
+	}
+	if (options.externals < 0) {
+		options.externals = 16;
+	}
+	if (options.entries < 0) {
+		options.entries = options.labels / 16;
+	}
+	if (options.data_lines < 0) {
+		options.data_lines = code_lines / 10;
+	}
+	if (options.string_lines < 0) {
+		options.string_lines = code_lines / 20;
+	}
+	/* an .entry needs a label, and a .data line a number */
+	if (options.labels < 1) {
+		options.entries = 0;
+	}
+	if (options.data_size < 1) {
+		options.data_size = 1;
+	}
+	words = write_corpus(stdout, &options);
+	if (words > options.max_words) {
+		fprintf(stderr, "%s: the program has %ld words, only %ld fit below address 4096, write it as more files with fewer lines\n",
+			argv[0], words, options.max_words);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,87 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../globals.h"
+#include "../first_pass.h"
+
+/* Measures the cost of classifying an identifier as a reserved word,
+ * with the linear strcmp scans that were used before and with find_keyword. */
+
+#define ROUNDS 2000000L
+
+extern char* INSTRUCTION[];
+extern Register REGISTERS[];
+extern op_code OPCODES[];
+
+static const char* NAMES[] = {
+	"mov", "cmp", "add", "sub", "lea", "clr", "not", "inc", "dec", "jmp", "bne", "red", "prn", "jsr", "rts", "stop",
+	".data", ".string", ".extern", ".entry", "r0", "r3", "r7",
+	"MAIN", "LOOP", "END", "STR", "LIST", "K", "x", "r8", "movx", "length", "counter", "ab", "W"
+};
+
+#define NAMES_COUNT (int)(sizeof(NAMES) / sizeof(NAMES[0]))
+
+/* the classification as it was done before, one scan of each table */
+static keyword_kind linear_keyword(const char* name, int* index) {
+	int i;
+	for (i = 0; i < INSTRUCTIONS_COUNT; i++) {
+		if (strcmp(name, INSTRUCTION[i]) == 0) {
+			*index = i;
+			return KEYWORD_INSTRUCTION;
+		}
+	}
+	for (i = 0; i < OPCODES_COUNT; i++) {
+		if (strcmp(name, OPCODES[i].name_of_opcode) == 0) {
+			*index = i;
+			return KEYWORD_OPCODE;
+		}
+	}
+	for (i = 0; i < REG_COUNT; i++) {
+		if (strcmp(name, REGISTERS[i].name_of_register) == 0) {
+			*index = i;
+			return KEYWORD_REGISTER;
+		}
+	}
+	return KEYWORD_NONE;
+}
+
+int main(void) {
+	size_t lengths[NAMES_COUNT];
+	long round;
+	int i, index, linear_index;
+	long sum = 0;
+	clock_t start;
+	double linear_time, hash_time, per_name;
+
+	for (i = 0; i < NAMES_COUNT; i++) {
+		lengths[i] = strlen(NAMES[i]);
+		index = linear_index = -1;
+		if (find_keyword(NAMES[i], lengths[i], &index) != linear_keyword(NAMES[i], &linear_index) || index != linear_index) {
+			printf("Mismatch on %s\n", NAMES[i]);
+			return 1;
+		}
+	}
+
+	start = clock();
+	for (round = 0; round < ROUNDS; round++) {
+		for (i = 0; i < NAMES_COUNT; i++) {
+			sum += linear_keyword(NAMES[i], &index);
+		}
+	}
+	linear_time = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	start = clock();
+	for (round = 0; round < ROUNDS; round++) {
+		for (i = 0; i < NAMES_COUNT; i++) {
+			sum += find_keyword(NAMES[i], lengths[i], &index);
+		}
+	}
+	hash_time = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	per_name = 1e9 / ((double)ROUNDS * NAMES_COUNT);
+	printf("%d identifiers, %ld rounds (checksum %ld)\n", NAMES_COUNT, ROUNDS, sum);
+	printf("linear scans: %.2f ns per identifier\n", linear_time * per_name);
+	printf("find_keyword: %.2f ns per identifier\n", hash_time * per_name);
+	return 0;
+}
@@ -0,0 +1,173 @@
+#define _XOPEN_SOURCE 700
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+/* Measures the latency of assembling one file with a fresh process for every run,
+ * and with requests to a server, once with an unchanged source and once after it was touched. */
+
+#define DEFAULT_ROUNDS 200
+
+static double now_usec(void) {
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec * 1e6 + t.tv_nsec / 1e3;
+}
+
+/* runs the assembler with its output thrown away, and waits for it */
+static void run_quiet(char **args) {
+	int status;
+	int null_fd;
+	pid_t pid = fork();
+
+	if (pid == 0) {
+		null_fd = open("/dev/null", O_WRONLY);
+		dup2(null_fd, 1);
+		dup2(null_fd, 2);
+		execv(args[0], args);
+		_exit(127);
+	}
+	waitpid(pid, &status, 0);
+}
+
+static int connect_to(char *socket_path) {
+	struct sockaddr_un addr;
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strcpy(addr.sun_path, socket_path);
+	if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+/* sends a request and reads the whole answer */
+static void request(char *socket_path, char *text) {
+	char answer[4096];
+	int fd = connect_to(socket_path);
+
+	if (fd < 0) {
+		printf("Failed to connect to the server\n");
+		exit(1);
+	}
+	if (write(fd, text, strlen(text)) < 0) {
+		printf("Failed to send the request\n");
+		exit(1);
+	}
+	shutdown(fd, SHUT_WR);
+	while (read(fd, answer, sizeof(answer)) > 0)
+		;
+	close(fd);
+}
+
+static int compare_doubles(const void *a, const void *b) {
+	double x = *(const double *)a, y = *(const double *)b;
+	return (x > y) - (x < y);
+}
+
+static void print_times(const char *mode, double *times, int rounds) {
+	double sum = 0;
+	int i;
+
+	for (i = 0; i < rounds; i++) {
+		sum += times[i];
+	}
+	qsort(times, rounds, sizeof(double), compare_doubles);
+	printf("%-22s mean %8.1f us  p50 %8.1f us  p95 %8.1f us\n", mode, sum / rounds, times[rounds / 2], times[rounds * 95 / 100]);
+}
+
+int main(int argc, char *argv[]) {
+	char socket_path[64], serve_option[80], cwd[4096], as_file[4096];
+	char *text;
+	char *fresh_args[3];
+	char *server_args[4];
+	struct timespec touch[2];
+	struct timespec pause;
+	double *times;
+	double start;
+	pid_t server;
+	int rounds, i, fd, status;
+
+	if (argc < 3) {
+		printf("usage: %s ASSEMBLER FILE [ROUNDS]\n", argv[0]);
+		return 1;
+	}
+	rounds = (argc > 3) ? atoi(argv[3]) : DEFAULT_ROUNDS;
+	if (rounds < 1 || getcwd(cwd, sizeof(cwd)) == NULL) {
+		return 1;
+	}
+	times = malloc(rounds * sizeof(double));
+	text = malloc(strlen(cwd) + strlen(argv[2]) + 16);
+	sprintf(text, "!cwd %s\n%s\n", cwd, argv[2]);
+	sprintf(as_file, "%.4000s.as", argv[2]);
+	sprintf(socket_path, "/tmp/serve_bench.%ld.sock", (long)getpid());
+	sprintf(serve_option, "--serve=%s", socket_path);
+
+	server_args[0] = argv[1];
+	server_args[1] = serve_option;
+	server_args[2] = NULL;
+	server = fork();
+	if (server == 0) {
+		fd = open("/dev/null", O_WRONLY);
+		dup2(fd, 1);
+		execv(argv[1], server_args);
+		_exit(127);
+	}
+	/* the server is ready once it accepts a connection */
+	pause.tv_sec = 0;
+	pause.tv_nsec = 1000000;
+	for (i = 0; (fd = connect_to(socket_path)) < 0 && i < 1000; i++) {
+		nanosleep(&pause, NULL);
+	}
+	if (fd < 0) {
+		printf("The server did not start\n");
+		return 1;
+	}
+	close(fd);
+
+	fresh_args[0] = argv[1];
+	fresh_args[1] = argv[2];
+	fresh_args[2] = NULL;
+	for (i = 0; i < rounds; i++) {
+		start = now_usec();
+		run_quiet(fresh_args);
+		times[i] = now_usec() - start;
+	}
+	print_times("fresh process", times, rounds);
+
+	request(socket_path, text); /* the first request assembles the file */
+	for (i = 0; i < rounds; i++) {
+		start = now_usec();
+		request(socket_path, text);
+		times[i] = now_usec() - start;
+	}
+	print_times("server, unchanged", times, rounds);
+
+	touch[0].tv_nsec = UTIME_NOW;
+	touch[1].tv_nsec = UTIME_NOW;
+	for (i = 0; i < rounds; i++) {
+		utimensat(AT_FDCWD, as_file, touch, 0);
+		start = now_usec();
+		request(socket_path, text);
+		times[i] = now_usec() - start;
+	}
+	print_times("server, touched", times, rounds);
+
+	request(socket_path, "!shutdown\n");
+	waitpid(server, &status, 0);
+	free(text);
+	free(times);
+	return 0;
+}
@@ -0,0 +1,163 @@
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include "../globals.h"
+#include "../libassembler.h"
+#include "../arena.h"
+#include "../pre_assembler.h"
+
+/* Measures how many small generated sources are assembled per second in memory with assemble_source,
+ * and, when an assembler is given, with a temporary file and a process for every source as before. */
+
+#define DEFAULT_SNIPPETS 200000L
+
+/* The most sources that are assembled with a process each, it takes far longer */
+#define MAX_PROCESS_SNIPPETS 500L
+
+/* The files of a source run by a process */
+#define ENDINGS_COUNT 4
+
+/* Room for the longest snippet */
+#define SNIPPET_SIZE 1024
+
+static unsigned long seed = 12345;
+
+static int next_random(int range) {
+	seed = seed * 1103515245UL + 12345UL;
+	return (int)((seed >> 16) % (unsigned long)range);
+}
+
+/* writes a small program with a macro, labels, data, an external and an entry; one in eight has an error */
+static size_t make_snippet(long number, char *out) {
+	char *end = out;
+	int reg = next_random(REG_COUNT);
+
+	end += sprintf(end, "; snippet %ld\nmacr m%ld\n inc r%d\n mov #%d, r%d\nendmacr\n", number, number, reg, next_random(100) - 50, reg);
+	end += sprintf(end, ".extern EXT%d\nMAIN: mov #%d, r%d\n", next_random(4), next_random(1000), next_random(REG_COUNT));
+	end += sprintf(end, "LOOP: cmp r%d, LEN\n bne END\n m%ld\n", next_random(REG_COUNT), number);
+	end += sprintf(end, " jsr EXT%d\n prn *r%d\n lea STR, r%d\n", next_random(4), next_random(REG_COUNT), next_random(REG_COUNT));
+	if (next_random(8) == 0) {
+		end += sprintf(end, " mov r%d\n", next_random(REG_COUNT));
+	}
+	end += sprintf(end, "END: stop\nLEN: .data %d, -%d, %d\n", next_random(500), next_random(500), next_random(500));
+	end += sprintf(end, "STR: .string \"snippet%ld\"\n.entry MAIN\n.entry LOOP\n", number);
+	return (size_t)(end - out);
+}
+
+static double now_seconds(void) {
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (double)t.tv_sec + (double)t.tv_nsec / 1e9;
+}
+
+/* writes every source to a file and runs the assembler on it in a directory of its own, as a harness would */
+static double run_processes(char *assembler, char **snippets, size_t *lengths, long count) {
+	static const char *ENDINGS[] = { ".as", ".ob", ".ent", ".ext" };
+	char dir[64], name[32], path[128];
+	double start = now_seconds();
+	double elapsed;
+	pid_t pid;
+	long i;
+	int j, fd, status;
+
+	sprintf(dir, "/tmp/snippet_bench.%ld", (long)getpid());
+	mkdir(dir, 0777);
+	for (i = 0; i < count; i++) {
+		sprintf(name, "s%ld", i);
+		sprintf(path, "%s/%s.as", dir, name);
+		fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+		if (fd < 0 || write(fd, snippets[i], lengths[i]) != (ssize_t)lengths[i]) {
+			printf("Failed to write %s\n", path);
+			exit(1);
+		}
+		close(fd);
+		pid = fork();
+		if (pid == 0) {
+			fd = open("/dev/null", O_WRONLY);
+			dup2(fd, 1);
+			dup2(fd, 2);
+			if (chdir(dir) == 0) {
+				execl(assembler, assembler, name, (char *)NULL);
+			}
+			_exit(127);
+		}
+		waitpid(pid, &status, 0);
+	}
+	elapsed = now_seconds() - start;
+	for (i = 0; i < count; i++) {
+		for (j = 0; j < ENDINGS_COUNT; j++) {
+			sprintf(path, "%s/s%ld%s", dir, i, ENDINGS[j]);
+			remove(path);
+		}
+	}
+	rmdir(dir);
+	return elapsed;
+}
+
+int main(int argc, char *argv[]) {
+	long count = (argc > 1) ? atol(argv[1]) : DEFAULT_SNIPPETS;
+	char **snippets;
+	size_t *lengths;
+	assembler_options options;
+	assembly_result result;
+	arena memory;
+	long i, valid = 0, messages = 0, process_count;
+	unsigned long output_bytes = 0;
+	double library_time, process_time;
+
+	if (count < 1) {
+		printf("usage: %s [SNIPPETS] [ASSEMBLER]\n", argv[0]);
+		return 1;
+	}
+	snippets = handle_malloc(count * sizeof(char *), ALLOC_TABLES);
+	lengths = handle_malloc(count * sizeof(size_t), ALLOC_TABLES);
+	for (i = 0; i < count; i++) {
+		snippets[i] = handle_malloc(SNIPPET_SIZE, ALLOC_BUFFERS);
+		lengths[i] = make_snippet(i, snippets[i]);
+	}
+
+	options.emit_am = 0;
+	options.emit_obb = 0;
+	options.max_line_length = 0;
+	options.memory_report = 0;
+	options.jobs = 1;
+	options.pass_threads = 1;
+	options.stats = STATS_OFF;
+	options.alloc_profile = 0;
+	init_arena(&memory);
+	init_assembly_result(&result);
+
+	/* one arena and one result for all the sources, as a harness that runs them one after the other */
+	library_time = now_seconds();
+	for (i = 0; i < count; i++) {
+		valid += assemble_source(snippets[i], lengths[i], &options, &memory, &result);
+		messages += result.message_count;
+		output_bytes += result.outputs[OUTPUT_OB].length + result.outputs[OUTPUT_ENT].length + result.outputs[OUTPUT_EXT].length;
+		reset_arena(&memory);
+	}
+	library_time = now_seconds() - library_time;
+
+	printf("%ld snippets, %ld valid, %ld messages, %lu output bytes\n", count, valid, messages, output_bytes);
+	printf("assemble_source: %.0f snippets/s (%.2f us per snippet)\n", count / library_time, library_time * 1e6 / count);
+	if (argc > 2) {
+		process_count = (count < MAX_PROCESS_SNIPPETS) ? count : MAX_PROCESS_SNIPPETS;
+		process_time = run_processes(argv[2], snippets, lengths, process_count);
+		printf("file and process: %.0f snippets/s (%.2f us per snippet, %ld snippets)\n", process_count / process_time, process_time * 1e6 / process_count, process_count);
+	}
+
+	free_assembly_result(&result);
+	free_arena(&memory);
+	for (i = 0; i < count; i++) {
+		handle_free(snippets[i]);
+	}
+	handle_free(snippets);
+	handle_free(lengths);
+	return 0;
+}
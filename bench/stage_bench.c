@@ -0,0 +1,263 @@
+#define _XOPEN_SOURCE 700
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include "../globals.h"
+#include "../pre_assembler.h"
+#include "../first_pass.h"
+#include "../second_pass.h"
+#include "../lexer.h"
+#include "../object.h"
+#include "../file_reader.h"
+#include "../arena.h"
+#include "../report.h"
+
+/* Times the stages of the assembler on source files, one after the other, and the assembler program
+ * on the same files from start to end. The times of the files are added, a program of a benchmark that
+ * would not fit in the addresses of an operand is split into several files. One line of JSON is printed
+ * with the wall time, the lines per second and how much every stage raised the peak RSS; a table for
+ * people is printed to stderr. */
+
+/* The stages, in the order they run */
+enum stage_index { STAGE_READ, STAGE_PRE_ASSEMBLER, STAGE_FIRST_PASS, STAGE_SECOND_PASS, STAGE_OUTPUT, STAGES_COUNT };
+
+static const char *STAGE_NAMES[STAGES_COUNT] = { "read", "pre_assembler", "first_pass", "second_pass", "output" };
+
+/* Small files are run again until about this many lines were read, the fastest run is kept */
+#define LINES_PER_MEASURE 200000L
+#define MAX_REPEATS 50L
+
+static double now_seconds(void) {
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (double)t.tv_sec + (double)t.tv_nsec / 1e9;
+}
+
+/* the most memory the process held so far, in KB */
+static long peak_rss_kb(int who) {
+	struct rusage usage;
+	getrusage(who, &usage);
+	return usage.ru_maxrss;
+}
+
+/* The peak RSS only grows, so every stage is given what it added to it since the previous stage. A stage
+ * that fits in memory the earlier stages freed, or in the arena they grew, adds nothing. */
+static void note_rss_growth(long *rss, int stage, long *previous) {
+	long peak = peak_rss_kb(RUSAGE_SELF);
+
+	rss[stage] += peak - *previous;
+	*previous = peak;
+}
+
+static int write_output(char *name, char *ending, byte_buffer *content) {
+	char *file_name = add_new_file(name, ending);
+	FILE *fp = fopen(file_name, "w");
+	int ok = (fp != NULL && fwrite(content->data, 1, content->length, fp) == content->length);
+
+	if (fp != NULL && fclose(fp) != 0) {
+		ok = 0;
+	}
+	handle_free(file_name);
+	return ok;
+}
+
+/* runs the stages on a file once, adds their times and its lines, and on the first run what each stage added to the peak RSS */
+static int run_stages(char *name, char *as_file, double *seconds, long *rss, int first_run, arena *memory, long *source_lines) {
+	input_file input;
+	macro_table macros;
+	line_source source;
+	assembler_options options;
+	symbol_table symbols;
+	pass_chunk pass;
+	byte_buffer outputs[CACHED_ENDINGS_COUNT];
+	char **lines = NULL;
+	char *str;
+	long count = 0, capacity = 0;
+	double start;
+	long peak = peak_rss_kb(RUSAGE_SELF);
+	int i, ok, resolved = 1;
+
+	memset(&options, 0, sizeof(options));
+	for (i = 0; i < CACHED_ENDINGS_COUNT; i++) {
+		init_buffer(&outputs[i]);
+	}
+
+	start = now_seconds();
+	if (!open_input(as_file, &input)) {
+		return 0;
+	}
+	seconds[STAGE_READ] += now_seconds() - start;
+	if (first_run) {
+		note_rss_growth(rss, STAGE_READ, &peak);
+	}
+
+	/* the expanded lines are copied, the first pass usually takes them one at a time */
+	start = now_seconds();
+	implement_macro(input.data, input.size, &source, &macros, &options, memory, NULL);
+	while ((str = next_line(&source)) != NULL) {
+		if (count == capacity) {
+			capacity = (capacity == 0) ? IMAGE_INIT_SIZE : capacity * 2;
+			lines = handle_realloc(lines, capacity * sizeof(char *), ALLOC_LINES);
+		}
+		lines[count++] = arena_strndup(memory, str, strlen(str), ALLOC_LINES);
+	}
+	*source_lines += source.source_line;
+	seconds[STAGE_PRE_ASSEMBLER] += now_seconds() - start;
+	if (first_run) {
+		note_rss_growth(rss, STAGE_PRE_ASSEMBLER, &peak);
+	}
+
+	start = now_seconds();
+	init_symbol_table(&symbols, memory);
+	init_pass_chunk(&pass, IC_INIT_VALUE, &symbols, memory);
+	for (i = 0; i < count; i++) {
+		first_pass_line(&pass, lines[i], i + 1);
+	}
+	free_line_tokens(&pass.tokens);
+	update_data_label(&symbols, pass.IC);
+	seconds[STAGE_FIRST_PASS] += now_seconds() - start;
+	if (first_run) {
+		note_rss_growth(rss, STAGE_FIRST_PASS, &peak);
+	}
+	ok = pass.is_valid && source.is_valid;
+
+	start = now_seconds();
+	if (ok) {
+		resolved = implement_second_pass(&pass.fixups, &symbols, &pass.code, &outputs[OUTPUT_ENT], &outputs[OUTPUT_EXT]);
+	}
+	seconds[STAGE_SECOND_PASS] += now_seconds() - start;
+	if (first_run) {
+		note_rss_growth(rss, STAGE_SECOND_PASS, &peak);
+	}
+
+	start = now_seconds();
+	if (ok) {
+		append_object(&pass.code, &pass.data, pass.IC, pass.DC, &outputs[OUTPUT_OB]);
+		ok = write_output(name, ".ob", &outputs[OUTPUT_OB]);
+		ok = (outputs[OUTPUT_ENT].length == 0 || write_output(name, ".ent", &outputs[OUTPUT_ENT])) && ok;
+		ok = (outputs[OUTPUT_EXT].length == 0 || write_output(name, ".ext", &outputs[OUTPUT_EXT])) && ok;
+	}
+	seconds[STAGE_OUTPUT] += now_seconds() - start;
+	if (first_run) {
+		note_rss_growth(rss, STAGE_OUTPUT, &peak);
+	}
+	/* the output stage is timed even when an address did not fit in its operand, the file is not valid though */
+	ok = resolved && ok;
+
+	close_line_source(&source);
+	close_input(&input);
+	for (i = 0; i < CACHED_ENDINGS_COUNT; i++) {
+		free_buffer(&outputs[i]);
+	}
+	handle_free(lines);
+	reset_arena(memory);
+	return ok;
+}
+
+/* runs the assembler program on the files with its messages thrown away, and returns the wall time;
+ * args holds the assembler and then the names of the files, and ends with NULL */
+static double run_assembler(char **args) {
+	double start = now_seconds();
+	int status, fd;
+	pid_t pid = fork();
+
+	if (pid == 0) {
+		fd = open("/dev/null", O_WRONLY);
+		dup2(fd, 1);
+		dup2(fd, 2);
+		execv(args[0], args);
+		_exit(127);
+	}
+	waitpid(pid, &status, 0);
+	return now_seconds() - start;
+}
+
+int main(int argc, char *argv[]) {
+	double best[STAGES_COUNT], seconds[STAGES_COUNT];
+	long rss[STAGES_COUNT];
+	double end_to_end = 0, run_time, total = 0;
+	long repeats, source_lines = 0, r;
+	char **names, **as_files;
+	int file_count;
+	diagnostics diag;
+	arena memory;
+	int i, f, ok = 1;
+
+	if (argc < 3) {
+		fprintf(stderr, "usage: %s ASSEMBLER FILE... (the names of the .as files without their extension)\n", argv[0]);
+		return 1;
+	}
+	names = argv + 2;
+	file_count = argc - 2;
+	as_files = handle_malloc(file_count * sizeof(char *), ALLOC_FILE_NAMES);
+	for (f = 0; f < file_count; f++) {
+		as_files[f] = add_new_file(names[f], ".as");
+	}
+	init_arena(&memory);
+	/* the messages of the stages are not printed, a generated corpus has none */
+	init_diagnostics(&diag);
+	capture_reports(&diag);
+
+	for (i = 0; i < STAGES_COUNT; i++) {
+		rss[i] = 0;
+	}
+	for (r = 0, repeats = 1; r < repeats; r++) {
+		for (i = 0; i < STAGES_COUNT; i++) {
+			seconds[i] = 0;
+		}
+		source_lines = 0;
+		for (f = 0; f < file_count; f++) {
+			if (!run_stages(names[f], as_files[f], seconds, rss, r == 0, &memory, &source_lines)) {
+				ok = 0;
+			}
+		}
+		if (r == 0) {
+			repeats = (source_lines > 0) ? LINES_PER_MEASURE / source_lines : MAX_REPEATS;
+			repeats = (repeats < 1) ? 1 : (repeats > MAX_REPEATS) ? MAX_REPEATS : repeats;
+		}
+		for (i = 0; i < STAGES_COUNT; i++) {
+			best[i] = (r == 0 || seconds[i] < best[i]) ? seconds[i] : best[i];
+		}
+	}
+	/* the arguments from the assembler on, with the NULL after them, are the command line of the assembler */
+	for (r = 0; r < repeats; r++) {
+		run_time = run_assembler(argv + 1);
+		end_to_end = (r == 0 || run_time < end_to_end) ? run_time : end_to_end;
+	}
+	capture_reports(NULL);
+	if (!ok || diag.out.length > 0 || diag.err.length > 0) {
+		fprintf(stderr, "%s: the stages found errors in the files\n", as_files[0]);
+	}
+
+	printf("{\"file\": \"%s\", \"files\": %d, \"lines\": %ld, \"repeats\": %ld, \"valid\": %d, \"stages\": [", as_files[0], file_count,
+		source_lines, repeats, ok);
+	for (i = 0; i < STAGES_COUNT; i++) {
+		total += best[i];
+		printf("%s{\"name\": \"%s\", \"seconds\": %.6f, \"lines_per_second\": %.0f, \"peak_rss_growth_kb\": %ld}", (i > 0) ? ", " : "",
+			STAGE_NAMES[i], best[i], (best[i] > 0) ? source_lines / best[i] : 0.0, rss[i]);
+	}
+	printf("], \"stages_seconds\": %.6f, \"end_to_end\": {\"seconds\": %.6f, \"lines_per_second\": %.0f, \"peak_rss_kb\": %ld}}\n",
+		total, end_to_end, (end_to_end > 0) ? source_lines / end_to_end : 0.0, peak_rss_kb(RUSAGE_CHILDREN));
+
+	fprintf(stderr, "%s: %d files, %ld lines, best of %ld\n", as_files[0], file_count, source_lines, repeats);
+	for (i = 0; i < STAGES_COUNT; i++) {
+		fprintf(stderr, "  %-14s %10.3f ms %12.0f lines/s %8ld KB more peak\n", STAGE_NAMES[i], best[i] * 1e3,
+			(best[i] > 0) ? source_lines / best[i] : 0.0, rss[i]);
+	}
+	fprintf(stderr, "  %-14s %10.3f ms %12.0f lines/s %8ld KB peak\n", "assembler", end_to_end * 1e3,
+		(end_to_end > 0) ? source_lines / end_to_end : 0.0, peak_rss_kb(RUSAGE_CHILDREN));
+
+	free_diagnostics(&diag);
+	free_arena(&memory);
+	for (f = 0; f < file_count; f++) {
+		handle_free(as_files[f]);
+	}
+	handle_free(as_files);
+	return ok ? 0 : 1;
+}
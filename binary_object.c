@@ -0,0 +1,344 @@
+#include <stdio.h>
+#include <string.h>
+#include "globals.h"
+#include "binary_object.h"
+#include "object.h"
+#include "first_pass.h"
+#include "pre_assembler.h"
+#include "arena.h"
+
+/* The header is 16 numbers of 4 bytes, in this order */
+enum header_field {
+	HEADER_MAGIC, HEADER_VERSION, HEADER_SIZE, HEADER_FILE_SIZE, HEADER_IC, HEADER_DC, HEADER_BASE,
+	HEADER_CODE_OFFSET, HEADER_DATA_OFFSET, HEADER_ENTRY_COUNT, HEADER_ENTRIES_OFFSET,
+	HEADER_EXTERN_COUNT, HEADER_EXTERNS_OFFSET, HEADER_POOL_SIZE, HEADER_POOL_OFFSET, HEADER_RESERVED
+};
+
+/* the number of bytes of an entry or an external in the file */
+#define SYMBOL_SIZE 8
+
+#define ALIGN4(size) (((size) + 3) / 4 * 4)
+
+/* an entry or an external before it is written, its name is not copied */
+typedef struct symbol_ref {
+	const char *name;
+	size_t length;
+	long address;
+} symbol_ref;
+
+/* a position in a text object file that is read */
+typedef struct text_cursor {
+	const char *at;
+	const char *end;
+} text_cursor;
+
+static void put_u16(char *out, unsigned int value) {
+	out[0] = (char)(value & 0xFF);
+	out[1] = (char)((value >> 8) & 0xFF);
+}
+
+static void put_u32(char *out, unsigned long value) {
+	out[0] = (char)(value & 0xFF);
+	out[1] = (char)((value >> 8) & 0xFF);
+	out[2] = (char)((value >> 16) & 0xFF);
+	out[3] = (char)((value >> 24) & 0xFF);
+}
+
+static unsigned long get_u32(const char *in) {
+	const unsigned char *bytes = (const unsigned char *)in;
+	return (unsigned long)bytes[0] | ((unsigned long)bytes[1] << 8) | ((unsigned long)bytes[2] << 16) | ((unsigned long)bytes[3] << 24);
+}
+
+/* writes the words of an image, a word whose label was not found keeps the value of the ".ob" file */
+static char *put_words(char *out, memory_image *image) {
+	int i;
+
+	for (i = 0; i < image->count; i++, out += 2) {
+		put_u16(out, (image->words[i] == UNRESOLVED_WORD) ? 1 : image->words[i]);
+	}
+	return out;
+}
+
+/* writes a table of entries or externals, and appends their names to the pool */
+static void put_symbols(char *out, symbol_ref *symbols, long count, char *pool, size_t *pool_length) {
+	long i;
+
+	for (i = 0; i < count; i++, out += SYMBOL_SIZE) {
+		put_u32(out, (unsigned long)*pool_length);
+		put_u32(out + 4, (unsigned long)symbols[i].address);
+		memcpy(pool + *pool_length, symbols[i].name, symbols[i].length);
+		*pool_length += symbols[i].length;
+		pool[(*pool_length)++] = '\0';
+	}
+}
+
+static size_t names_size(symbol_ref *symbols, long count) {
+	size_t size = 0;
+	long i;
+
+	for (i = 0; i < count; i++) {
+		size += symbols[i].length + 1;
+	}
+	return size;
+}
+
+/* appends the whole file, its size is known before anything is written so the buffer grows once */
+static void write_binary_object(memory_image *code, memory_image *data, int IC, int DC, symbol_ref *entries, long entry_count,
+	symbol_ref *externs, long extern_count, byte_buffer *out) {
+	size_t data_offset = BINARY_OBJECT_HEADER_SIZE + (size_t)code->count * 2;
+	size_t entries_offset = ALIGN4(data_offset + (size_t)data->count * 2);
+	size_t externs_offset = entries_offset + (size_t)entry_count * SYMBOL_SIZE;
+	size_t pool_offset = externs_offset + (size_t)extern_count * SYMBOL_SIZE;
+	size_t pool_size = names_size(entries, entry_count) + names_size(externs, extern_count);
+	size_t size = pool_offset + pool_size;
+	size_t pool_length = 0;
+	char *file;
+
+	reserve_buffer(out, out->length + size);
+	file = out->data + out->length;
+	memset(file, 0, size);
+	memcpy(file, BINARY_OBJECT_MAGIC, 4);
+	put_u32(file + 4 * HEADER_VERSION, BINARY_OBJECT_VERSION);
+	put_u32(file + 4 * HEADER_SIZE, BINARY_OBJECT_HEADER_SIZE);
+	put_u32(file + 4 * HEADER_FILE_SIZE, (unsigned long)size);
+	put_u32(file + 4 * HEADER_IC, (unsigned long)IC);
+	put_u32(file + 4 * HEADER_DC, (unsigned long)DC);
+	put_u32(file + 4 * HEADER_BASE, (unsigned long)code->base);
+	put_u32(file + 4 * HEADER_CODE_OFFSET, BINARY_OBJECT_HEADER_SIZE);
+	put_u32(file + 4 * HEADER_DATA_OFFSET, (unsigned long)data_offset);
+	put_u32(file + 4 * HEADER_ENTRY_COUNT, (unsigned long)entry_count);
+	put_u32(file + 4 * HEADER_ENTRIES_OFFSET, (unsigned long)entries_offset);
+	put_u32(file + 4 * HEADER_EXTERN_COUNT, (unsigned long)extern_count);
+	put_u32(file + 4 * HEADER_EXTERNS_OFFSET, (unsigned long)externs_offset);
+	put_u32(file + 4 * HEADER_POOL_SIZE, (unsigned long)pool_size);
+	put_u32(file + 4 * HEADER_POOL_OFFSET, (unsigned long)pool_offset);
+
+	put_words(put_words(file + BINARY_OBJECT_HEADER_SIZE, code), data);
+	put_symbols(file + entries_offset, entries, entry_count, file + pool_offset, &pool_length);
+	put_symbols(file + externs_offset, externs, extern_count, file + pool_offset, &pool_length);
+	out->length += size;
+}
+
+void append_binary_object(memory_image *code, memory_image *data, int IC, int DC, fixup_list *fixups, symbol_table *symbols, byte_buffer *out) {
+	symbol_ref *entries = arena_alloc(fixups->memory, (fixups->entry_count + 1) * sizeof(symbol_ref), ALLOC_FIXUPS);
+	symbol_ref *externs = arena_alloc(fixups->memory, (fixups->count + 1) * sizeof(symbol_ref), ALLOC_FIXUPS);
+	long extern_count = 0;
+	label *lbl;
+	int i;
+
+	/* the same entries and externals as the second pass writes to the ".ent" and ".ext" files */
+	for (i = 0; i < fixups->entry_count; i++) {
+		lbl = search_label(symbols, fixups->entries[i].name, fixups->entries[i].name_length);
+		entries[i].name = fixups->entries[i].name;
+		entries[i].length = fixups->entries[i].name_length;
+		entries[i].address = (lbl != NULL) ? lbl->address_of_label : 0;
+	}
+	for (i = 0; i < fixups->count; i++) {
+		lbl = search_label(symbols, fixups->fixups[i].name, fixups->fixups[i].name_length);
+		if (lbl != NULL && lbl->kind == SYMBOL_EXTERNAL) {
+			externs[extern_count].name = label_name(symbols, lbl);
+			externs[extern_count].length = lbl->name_length;
+			externs[extern_count].address = (fixups->fixups[i].slot == -1) ? 0 : code->base + fixups->fixups[i].slot;
+			extern_count++;
+		}
+	}
+	write_binary_object(code, data, IC, DC, entries, fixups->entry_count, externs, extern_count, out);
+}
+
+static void skip_blanks(text_cursor *text) {
+	while (text->at < text->end && (*text->at == ' ' || *text->at == '\t')) {
+		text->at++;
+	}
+}
+
+/* reads a number in a base, with at most a number of digits, returns 0 if there is none */
+static int read_number(text_cursor *text, int base, int max_digits, long *value) {
+	int digits = 0;
+
+	*value = 0;
+	while (text->at < text->end && *text->at >= '0' && *text->at < '0' + base && digits < max_digits) {
+		*value = *value * base + (*text->at++ - '0');
+		digits++;
+	}
+	return digits > 0;
+}
+
+static int read_end_of_line(text_cursor *text) {
+	if (text->at < text->end && *text->at == '\n') {
+		text->at++;
+		return 1;
+	}
+	return 0;
+}
+
+/* reads the lines "name address" of an ".ent" or ".ext" file, the names point into the text */
+static int read_symbols(const char *content, size_t length, symbol_ref **symbols, long *count) {
+	text_cursor text;
+	long lines = 0;
+	size_t i;
+
+	*symbols = NULL;
+	*count = 0;
+	for (i = 0; i < length; i++) {
+		lines += (content[i] == '\n');
+	}
+	*symbols = handle_malloc((size_t)(lines + 1) * sizeof(symbol_ref), ALLOC_BUFFERS);
+	text.at = content;
+	text.end = content + length;
+	while (text.at < text.end) {
+		(*symbols)[*count].name = text.at;
+		while (text.at < text.end && *text.at != ' ' && *text.at != '\t' && *text.at != '\n') {
+			text.at++;
+		}
+		(*symbols)[*count].length = (size_t)(text.at - (*symbols)[*count].name);
+		skip_blanks(&text);
+		if ((*symbols)[*count].length == 0 || !read_number(&text, 10, 10, &(*symbols)[*count].address) || !read_end_of_line(&text)) {
+			return 0;
+		}
+		(*count)++;
+	}
+	return 1;
+}
+
+/* reads the words of an ".ob" file into an image, their addresses must follow each other */
+static int read_words(text_cursor *text, memory_image *image, long address) {
+	long value, line_address;
+	int i;
+
+	for (i = 0; i < image->count; i++) {
+		if (!read_number(text, 10, 10, &line_address) || line_address != address + i || text->at == text->end || *text->at++ != ' '
+			|| !read_number(text, 8, 6, &value) || value > 0xFFFF || !read_end_of_line(text)) {
+			return 0;
+		}
+		image->words[i] = (unsigned short)value;
+	}
+	return 1;
+}
+
+int text_to_binary_object(const char *ob, size_t ob_length, const char *ent, size_t ent_length, const char *ext, size_t ext_length, byte_buffer *out) {
+	text_cursor text;
+	memory_image code, data;
+	symbol_ref *entries = NULL, *externs = NULL;
+	long entry_count = 0, extern_count = 0, code_count, data_count;
+	int ok;
+
+	text.at = ob;
+	text.end = ob + ob_length;
+	skip_blanks(&text);
+	if (!read_number(&text, 10, 10, &code_count)) {
+		return 0;
+	}
+	skip_blanks(&text);
+	/* a word takes at least 8 characters, so larger counts cannot be right */
+	if (!read_number(&text, 10, 10, &data_count) || !read_end_of_line(&text) || code_count + data_count > (long)ob_length / 8) {
+		return 0;
+	}
+	memset(&code, 0, sizeof(code));
+	memset(&data, 0, sizeof(data));
+	code.count = code.capacity = (int)code_count;
+	code.base = IC_INIT_VALUE;
+	code.words = handle_malloc((size_t)(code_count + 1) * sizeof(unsigned short), ALLOC_BUFFERS);
+	data.count = data.capacity = (int)data_count;
+	data.words = handle_malloc((size_t)(data_count + 1) * sizeof(unsigned short), ALLOC_BUFFERS);
+
+	ok = read_words(&text, &code, IC_INIT_VALUE) && read_words(&text, &data, IC_INIT_VALUE + code_count) && text.at == text.end;
+	ok = ok && read_symbols(ent, (ent != NULL) ? ent_length : 0, &entries, &entry_count);
+	ok = ok && read_symbols(ext, (ext != NULL) ? ext_length : 0, &externs, &extern_count);
+	if (ok) {
+		write_binary_object(&code, &data, (int)(IC_INIT_VALUE + code_count), (int)data_count, entries, entry_count, externs, extern_count, out);
+	}
+	handle_free(code.words);
+	handle_free(data.words);
+	handle_free(entries);
+	handle_free(externs);
+	return ok;
+}
+
+/* checks that a table of the file lies after the one before it and inside the file */
+static int fits(unsigned long offset, unsigned long size, unsigned long after, unsigned long file_size) {
+	return offset >= after && offset <= file_size && size <= file_size - offset;
+}
+
+int map_binary_object(const char *content, size_t length, binary_object *object) {
+	unsigned int probe = 1;
+	unsigned long code_count, data_offset, entries_offset, externs_offset, pool_offset, pool_size;
+	long i;
+
+	/* the words and the tables are used in place, as a little-endian machine with 4-byte ints stores them */
+	if (*(unsigned char *)&probe != 1 || sizeof(unsigned int) != 4 || sizeof(unsigned short) != 2 || ((size_t)content & 3) != 0) {
+		return 0;
+	}
+	if (length < BINARY_OBJECT_HEADER_SIZE || memcmp(content, BINARY_OBJECT_MAGIC, 4) != 0
+		|| get_u32(content + 4 * HEADER_VERSION) != BINARY_OBJECT_VERSION || get_u32(content + 4 * HEADER_SIZE) != BINARY_OBJECT_HEADER_SIZE
+		|| get_u32(content + 4 * HEADER_FILE_SIZE) != length || get_u32(content + 4 * HEADER_CODE_OFFSET) != BINARY_OBJECT_HEADER_SIZE) {
+		return 0;
+	}
+	object->IC = (long)get_u32(content + 4 * HEADER_IC);
+	object->DC = (long)get_u32(content + 4 * HEADER_DC);
+	object->base = (long)get_u32(content + 4 * HEADER_BASE);
+	object->entry_count = (long)get_u32(content + 4 * HEADER_ENTRY_COUNT);
+	object->extern_count = (long)get_u32(content + 4 * HEADER_EXTERN_COUNT);
+	data_offset = get_u32(content + 4 * HEADER_DATA_OFFSET);
+	entries_offset = get_u32(content + 4 * HEADER_ENTRIES_OFFSET);
+	externs_offset = get_u32(content + 4 * HEADER_EXTERNS_OFFSET);
+	pool_offset = get_u32(content + 4 * HEADER_POOL_OFFSET);
+	pool_size = get_u32(content + 4 * HEADER_POOL_SIZE);
+	if (object->IC < object->base) {
+		return 0;
+	}
+	code_count = (unsigned long)(object->IC - object->base);
+	if (data_offset != BINARY_OBJECT_HEADER_SIZE + code_count * 2 || !fits(data_offset, (unsigned long)object->DC * 2, data_offset, length)
+		|| entries_offset % 4 != 0 || !fits(entries_offset, (unsigned long)object->entry_count * SYMBOL_SIZE, data_offset + (unsigned long)object->DC * 2, length)
+		|| !fits(externs_offset, (unsigned long)object->extern_count * SYMBOL_SIZE, entries_offset + (unsigned long)object->entry_count * SYMBOL_SIZE, length)
+		|| !fits(pool_offset, pool_size, externs_offset + (unsigned long)object->extern_count * SYMBOL_SIZE, length)
+		|| (pool_size > 0 && content[pool_offset + pool_size - 1] != '\0')) {
+		return 0;
+	}
+	object->code = (const unsigned short *)(content + BINARY_OBJECT_HEADER_SIZE);
+	object->data = (const unsigned short *)(content + data_offset);
+	object->entries = (const object_symbol *)(content + entries_offset);
+	object->externs = (const object_symbol *)(content + externs_offset);
+	object->pool = content + pool_offset;
+	object->pool_size = (size_t)pool_size;
+	/* a name is read up to its '\0', which the last byte of the pool is */
+	for (i = 0; i < object->entry_count; i++) {
+		if (object->entries[i].name >= pool_size) {
+			return 0;
+		}
+	}
+	for (i = 0; i < object->extern_count; i++) {
+		if (object->externs[i].name >= pool_size) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+void binary_object_to_text(binary_object *object, byte_buffer *ob, byte_buffer *ent, byte_buffer *ext) {
+	memory_image code, data;
+	char line[32];
+	const char *name;
+	long i;
+
+	memset(&code, 0, sizeof(code));
+	memset(&data, 0, sizeof(data));
+	/* the images only point at the words, render_object does not change them */
+	code.words = (unsigned short *)object->code;
+	code.count = code.capacity = (int)(object->IC - object->base);
+	code.base = (int)object->base;
+	data.words = (unsigned short *)object->data;
+	data.count = data.capacity = (int)object->DC;
+	append_object(&code, &data, (int)object->IC, (int)object->DC, ob);
+
+	/* the spaces between a name and its address are the ones the second pass writes */
+	for (i = 0; i < object->entry_count; i++) {
+		name = object->pool + object->entries[i].name;
+		append_to_buffer(ent, name, strlen(name));
+		append_to_buffer(ent, line, (size_t)sprintf(line, "           %u\n", object->entries[i].address));
+	}
+	for (i = 0; i < object->extern_count; i++) {
+		name = object->pool + object->externs[i].name;
+		append_to_buffer(ext, name, strlen(name));
+		append_to_buffer(ext, line, (size_t)sprintf(line, "          %u\n", object->externs[i].address));
+	}
+}
@@ -0,0 +1,72 @@
+#ifndef LABRATORY_C_FINAL_PROJECT_BINARY_OBJECT_H
+#define LABRATORY_C_FINAL_PROJECT_BINARY_OBJECT_H
+
+#include "globals.h"
+
+/*
+ * A binary object (".obb") file holds the ".ob", ".ent" and ".ext" files of a source in one file that a loader
+ * maps and uses in place. Every number is little-endian, the header is 16 numbers of 4 bytes:
+ *
+ *   magic "OBB\0", version, header size, file size, IC, DC, base address,
+ *   offset of the code words, offset of the data words, number of entries, offset of the entries,
+ *   number of externals, offset of the externals, size of the string pool, offset of the pool, 0
+ *
+ * The code words (IC - base of them) and the data words (DC) follow the header, 2 bytes each, with the value
+ * the ".ob" file shows. The entries and the externals start at the next multiple of 4, 8 bytes each: the offset
+ * of the name in the pool and the address. The pool of names ends the file, each name is followed by '\0'.
+ */
+
+/**
+ * @brief Appends the binary object file of an assembled source to a buffer.
+ *
+ * The words are taken from the images after the second pass, the entries from the .entry lines and the
+ * externals from the operands that use an external label, in the same order as the ".ent" and ".ext" files.
+ *
+ * @param code The instruction image.
+ * @param data The data image.
+ * @param IC The instruction counter after the first pass.
+ * @param DC The data counter after the first pass.
+ * @param fixups The label operands and the .entry lines of the file.
+ * @param symbols The symbol table of the file.
+ * @param out The buffer that receives the file.
+ */
+void append_binary_object(memory_image *code, memory_image *data, int IC, int DC, fixup_list *fixups, symbol_table *symbols, byte_buffer *out);
+
+/**
+ * @brief Converts the text object files of a source to a binary object file.
+ *
+ * @param ob The content of the ".ob" file.
+ * @param ob_length The number of characters in the ".ob" file.
+ * @param ent The content of the ".ent" file, or NULL if there is none.
+ * @param ent_length The number of characters in the ".ent" file.
+ * @param ext The content of the ".ext" file, or NULL if there is none.
+ * @param ext_length The number of characters in the ".ext" file.
+ * @param out The buffer that receives the binary object file.
+ * @return 1 on success, 0 if a file is not in the format the assembler writes.
+ */
+int text_to_binary_object(const char *ob, size_t ob_length, const char *ent, size_t ent_length, const char *ext, size_t ext_length, byte_buffer *out);
+
+/**
+ * @brief Checks a binary object file in memory and points a view into it, nothing is copied or converted.
+ *
+ * The header is checked against the size of the file, so the arrays of the view never reach past its end.
+ * The words and the tables are used as they are stored, which needs a little-endian machine.
+ *
+ * @param content The file, aligned to 4 bytes as a mapped file or an allocated buffer is.
+ * @param length The number of bytes in the file.
+ * @param object The view.
+ * @return 1 on success, 0 if the file is not a binary object file or this machine cannot use it in place.
+ */
+int map_binary_object(const char *content, size_t length, binary_object *object);
+
+/**
+ * @brief Writes the text object files of a binary object file, as the assembler writes them.
+ *
+ * @param object The view of the binary object file.
+ * @param ob The buffer that receives the ".ob" file.
+ * @param ent The buffer that receives the ".ent" file, it is left empty without entries.
+ * @param ext The buffer that receives the ".ext" file, it is left empty without externals.
+ */
+void binary_object_to_text(binary_object *object, byte_buffer *ob, byte_buffer *ent, byte_buffer *ext);
+
+#endif
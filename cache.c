@@ -0,0 +1,304 @@
+#define _XOPEN_SOURCE 700
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <utime.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include "globals.h"
+#include "cache.h"
+#include "file_reader.h"
+#include "pre_assembler.h"
+#include "first_pass.h"
+
+/* The output files that are kept in an entry, the ".am" file exists only with --emit-am and the ".obb" file with --emit-obb */
+char* CACHED_ENDINGS[] = { ".am", ".ob", ".ent", ".ext", ".obb" };
+
+unsigned long cache_hash(unsigned long hash, const char* data, size_t len) {
+	size_t i;
+	for (i = 0; i < len; i++) {
+		hash ^= (unsigned char)data[i];
+		hash *= 1099511628211UL;
+	}
+	return hash;
+}
+
+char* join_path(char* dir, char* name) {
+	char* path = handle_malloc(strlen(dir) + strlen(name) + 2, ALLOC_FILE_NAMES);
+	sprintf(path, "%s/%s", dir, name);
+	return path;
+}
+
+char* canonical_path(char* dir, char* name) {
+	char* path, * slash, * real, * key;
+
+	path = (name[0] == '/') ? duplicate(name) : join_path(dir, name);
+	slash = strrchr(path, '/');
+	*slash = '\0';
+	real = realpath((slash == path) ? "/" : path, NULL);
+	*slash = '/';
+	if (real == NULL) {
+		/* the directory does not exist, the file is not found either */
+		return path;
+	}
+	key = join_path((strcmp(real, "/") == 0) ? "" : real, slash + 1);
+	free(real);
+	handle_free(path);
+	return key;
+}
+
+int copy_file(char* source_name, char* dest_name) {
+	char buffer[BUFFER_INIT_SIZE * 64];
+	size_t count;
+	int ok = 1;
+	FILE* src, * dest;
+
+	src = fopen(source_name, "rb");
+	if (src == NULL) {
+		return 0;
+	}
+	dest = fopen(dest_name, "wb");
+	if (dest == NULL) {
+		fclose(src);
+		return 0;
+	}
+	while ((count = fread(buffer, 1, sizeof(buffer), src)) > 0) {
+		if (fwrite(buffer, 1, count, dest) != count) {
+			ok = 0;
+			break;
+		}
+	}
+	if (ferror(src)) {
+		ok = 0;
+	}
+	fclose(src);
+	if (fclose(dest) != 0) {
+		ok = 0;
+	}
+	return ok;
+}
+
+void remove_entry_dir(char* entry) {
+	char* path;
+	int i;
+	for (i = 0; i < CACHED_ENDINGS_COUNT; i++) {
+		path = join_path(entry, CACHED_ENDINGS[i] + 1);
+		remove(path);
+		handle_free(path);
+	}
+	rmdir(entry);
+}
+
+int cache_open(result_cache* cache, char* dir, long max_size) {
+	struct stat st;
+
+	cache->dir = dir;
+	cache->max_size = max_size;
+	cache->hits = 0;
+	cache->misses = 0;
+	cache->stores = 0;
+	cache->worker = 0;
+	cache->key[0] = '\0';
+
+	if (mkdir(dir, 0777) != 0 && errno != EEXIST) {
+		printf("Failed to create the cache directory: %s\n", dir);
+		return 0;
+	}
+	if (stat(dir, &st) != 0 || !S_ISDIR(st.st_mode)) {
+		printf("The cache directory is not a directory: %s\n", dir);
+		return 0;
+	}
+	return 1;
+}
+
+int cache_key(result_cache* cache, char* as_file, char* options) {
+	input_file input;
+	unsigned long hash = 14695981039346656037UL;
+
+	if (!open_input(as_file, &input)) {
+		return 0;
+	}
+	hash = cache_hash(hash, input.data, input.size);
+	close_input(&input);
+	/* the terminating '\0' separates the fields */
+	hash = cache_hash(hash, ASSEMBLER_VERSION, strlen(ASSEMBLER_VERSION) + 1);
+	hash = cache_hash(hash, options, strlen(options) + 1);
+	sprintf(cache->key, "%016lx", hash);
+	return 1;
+}
+
+/* stats the entry directory, 0 if there is no such directory */
+static int stat_entry(char* entry, struct stat* st) {
+	return stat(entry, st) == 0 && S_ISDIR(st->st_mode);
+}
+
+int cache_restore(result_cache* cache, char* base_name) {
+	struct stat st, entry_st;
+	char suffix[64];
+	char* entry, * cached, * output;
+	char* temps[CACHED_ENDINGS_COUNT];
+	int i, hit;
+
+	entry = join_path(cache->dir, cache->key);
+	/* every entry holds a ".ob" file, an entry without one is removed by another invocation right now */
+	cached = join_path(entry, CACHED_ENDINGS[OUTPUT_OB] + 1);
+	hit = stat_entry(entry, &entry_st) && stat(cached, &st) == 0;
+	handle_free(cached);
+
+	/* the files are copied next to the outputs first, no output is touched before every copy succeeded */
+	sprintf(suffix, ".cache.%ld.%d", (long)getpid(), cache->worker);
+	for (i = 0; i < CACHED_ENDINGS_COUNT; i++) {
+		temps[i] = NULL;
+		if (!hit) {
+			continue;
+		}
+		cached = join_path(entry, CACHED_ENDINGS[i] + 1);
+		if (stat(cached, &st) == 0) {
+			output = add_new_file(base_name, CACHED_ENDINGS[i]);
+			temps[i] = handle_malloc(strlen(output) + strlen(suffix) + 1, ALLOC_FILE_NAMES);
+			sprintf(temps[i], "%s%s", output, suffix);
+			hit = copy_file(cached, temps[i]);
+			handle_free(output);
+		}
+		handle_free(cached);
+	}
+	/* the entry may have been renamed away by an eviction while it was read, a file that seemed
+	 * to be missing from it could have been there, so the copies are used only if it is still the same entry */
+	hit = hit && stat_entry(entry, &st) && st.st_ino == entry_st.st_ino && st.st_dev == entry_st.st_dev;
+
+	for (i = 0; i < CACHED_ENDINGS_COUNT; i++) {
+		output = add_new_file(base_name, CACHED_ENDINGS[i]);
+		if (temps[i] != NULL) {
+			if (!hit || rename(temps[i], output) != 0) {
+				remove(temps[i]);
+				hit = 0;
+			}
+			handle_free(temps[i]);
+		}
+		else if (hit && i > 0) {
+			/* an output that the assembler would not have written */
+			remove(output);
+		}
+		handle_free(output);
+	}
+
+	if (hit) {
+		utime(entry, NULL); /* mark the entry as recently used */
+		cache->hits++;
+	}
+	else {
+		cache->misses++;
+	}
+	handle_free(entry);
+	return hit;
+}
+
+void cache_store(result_cache* cache, char* base_name) {
+	char temp_name[64];
+	char* temp_dir, * entry, * cached, * output;
+	struct stat st;
+	int i, ok = 1;
+
+	sprintf(temp_name, "tmp.%ld.%d.%d", (long)getpid(), cache->worker, cache->stores++);
+	temp_dir = join_path(cache->dir, temp_name);
+	if (mkdir(temp_dir, 0777) != 0) {
+		handle_free(temp_dir);
+		return;
+	}
+
+	for (i = 0; i < CACHED_ENDINGS_COUNT && ok; i++) {
+		output = add_new_file(base_name, CACHED_ENDINGS[i]);
+		if (stat(output, &st) == 0) {
+			cached = join_path(temp_dir, CACHED_ENDINGS[i] + 1);
+			ok = copy_file(output, cached);
+			handle_free(cached);
+		}
+		handle_free(output);
+	}
+
+	/* the entry appears at once, or not at all if another invocation saved it first */
+	entry = join_path(cache->dir, cache->key);
+	if (!ok || rename(temp_dir, entry) != 0) {
+		remove_entry_dir(temp_dir);
+	}
+	handle_free(entry);
+	handle_free(temp_dir);
+}
+
+int compare_entries_by_use(const void* a, const void* b) {
+	const cache_entry* first = a;
+	const cache_entry* second = b;
+	if (first->used != second->used) {
+		return (first->used < second->used) ? -1 : 1;
+	}
+	return strcmp(first->name, second->name);
+}
+
+void cache_evict(result_cache* cache) {
+	DIR* dir;
+	struct dirent* de;
+	struct stat st;
+	cache_entry* entries = NULL;
+	int count = 0, capacity = 0, i, j;
+	long total = 0;
+	char* entry, * path;
+	char temp_name[64];
+
+	dir = opendir(cache->dir);
+	if (dir == NULL) {
+		return;
+	}
+	while ((de = readdir(dir)) != NULL) {
+		/* skip "." and "..", and the temporary directories of other invocations */
+		if (de->d_name[0] == '.' || strncmp(de->d_name, "tmp.", 4) == 0) {
+			continue;
+		}
+		entry = join_path(cache->dir, de->d_name);
+		if (stat(entry, &st) != 0 || !S_ISDIR(st.st_mode)) {
+			handle_free(entry);
+			continue;
+		}
+		if (count == capacity) {
+			capacity = (capacity == 0) ? 64 : capacity * 2;
+			entries = handle_realloc(entries, capacity * sizeof(cache_entry), ALLOC_TABLES);
+		}
+		entries[count].name = entry;
+		entries[count].used = (long)st.st_mtime;
+		entries[count].size = 0;
+		for (j = 0; j < CACHED_ENDINGS_COUNT; j++) {
+			path = join_path(entry, CACHED_ENDINGS[j] + 1);
+			if (stat(path, &st) == 0) {
+				entries[count].size += (long)st.st_size;
+			}
+			handle_free(path);
+		}
+		total += entries[count].size;
+		count++;
+	}
+	closedir(dir);
+
+	if (count > 0) {
+		qsort(entries, count, sizeof(cache_entry), compare_entries_by_use);
+	}
+	for (i = 0; i < count; i++) {
+		if (total > cache->max_size) {
+			/* move the entry out of the way first, so no reader sees it half removed */
+			sprintf(temp_name, "tmp.%ld.evict.%d", (long)getpid(), i);
+			path = join_path(cache->dir, temp_name);
+			if (rename(entries[i].name, path) == 0) {
+				remove_entry_dir(path);
+				total -= entries[i].size;
+			}
+			handle_free(path);
+		}
+		handle_free(entries[i].name);
+	}
+	handle_free(entries);
+}
+
+void cache_close(result_cache* cache) {
+	printf("cache: %d hits, %d misses\n", cache->hits, cache->misses);
+}
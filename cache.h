@@ -0,0 +1,152 @@
+#ifndef LABRATORY_C_FINAL_PROJECT_CACHE_H
+#define LABRATORY_C_FINAL_PROJECT_CACHE_H
+
+#include "globals.h"
+
+/* Version of the assembler, part of the key of the result cache */
+#define ASSEMBLER_VERSION "1.1"
+
+/* Number of hex digits in a key of the result cache */
+#define CACHE_KEY_LENGTH 16
+
+/* Default limit on the size of the result cache in bytes */
+#define CACHE_DEFAULT_MAX_SIZE (64L * 1024 * 1024)
+
+/*This struct holds the state of the result cache directory*/
+typedef struct result_cache {
+    char *dir;      /*The cache directory*/
+    long max_size;  /*The limit on the total size of the cached files in bytes*/
+    int hits;       /*The number of files restored from the cache*/
+    int misses;     /*The number of files that were not found in the cache*/
+    int stores;     /*The number of entries saved, used to name temporary directories*/
+    int worker;     /*The number of the thread that uses this copy of the cache, used to name temporary directories*/
+    char key[CACHE_KEY_LENGTH + 1]; /*The key of the source file being assembled*/
+} result_cache;
+
+/*This struct describes an entry of the result cache while it is searched for entries to remove*/
+typedef struct cache_entry {
+    char *name;     /*The path of the entry directory*/
+    long used;      /*The last time the entry was used*/
+    long size;      /*The size of the files in the entry*/
+} cache_entry;
+
+/**
+ * @brief Opens a result cache directory, and creates it if it does not exist.
+ *
+ * @param cache The cache to initialize.
+ * @param dir The name of the cache directory.
+ * @param max_size The limit on the total size of the cached files in bytes.
+ * @return 1 if the directory can be used, 0 otherwise.
+ */
+int cache_open(result_cache *cache, char *dir, long max_size);
+
+/**
+ * @brief Calculates the key of a source file in the cache.
+ *
+ * The key is a hash of the content of the file, the version of the assembler and the options
+ * that change the output, so a change in any of them leads to a different entry.
+ *
+ * @param cache The cache, the key is saved in it.
+ * @param as_file The name of the source file.
+ * @param options A string that describes the options of the assembler.
+ * @return 1 if the key was calculated, 0 if the file could not be read.
+ */
+int cache_key(result_cache *cache, char *as_file, char *options);
+
+/**
+ * @brief Restores the output files of the current key from the cache.
+ *
+ * The cached ".ob", ".ent", ".ext" (and ".am" and ".obb") files are copied next to the source under
+ * temporary names, and renamed over the output files only when every copy succeeded and the entry was
+ * not evicted meanwhile. Then the output files that are not in the entry are removed, and the entry is
+ * marked as recently used. On a miss the output files are left as they were.
+ *
+ * @param cache The cache, with the key of the source file.
+ * @param base_name The name of the source file without its extension.
+ * @return 1 on a hit, 0 on a miss.
+ */
+int cache_restore(result_cache *cache, char *base_name);
+
+/**
+ * @brief Saves the output files of a source file in the cache under the current key.
+ *
+ * The files are copied to a temporary directory that is renamed to the entry at the end, so
+ * parallel invocations never see a partial entry. If another invocation already saved the
+ * same entry, the copy is dropped.
+ *
+ * @param cache The cache, with the key of the source file.
+ * @param base_name The name of the source file without its extension.
+ */
+void cache_store(result_cache *cache, char *base_name);
+
+/**
+ * @brief Removes the least recently used entries until the cache fits in its size limit.
+ *
+ * @param cache The cache.
+ */
+void cache_evict(result_cache *cache);
+
+/**
+ * @brief Continues an FNV-1a hash (with 64 bit constants) over more characters.
+ *
+ * @param hash The hash of the characters before, or the FNV offset basis.
+ * @param data The characters to add to the hash.
+ * @param len The number of characters.
+ * @return The new hash.
+ */
+unsigned long cache_hash(unsigned long hash, const char *data, size_t len);
+
+/**
+ * @brief Joins a directory and a file name into a new path.
+ *
+ * @param dir The directory.
+ * @param name The file name.
+ * @return The allocated path.
+ */
+char *join_path(char *dir, char *name);
+
+/**
+ * @brief Returns the absolute path of a file, with the links and the "." and ".." of its directory resolved.
+ *
+ * Every name of a file gives the same path, so it can be used to tell whether two names are the same file.
+ * The file itself does not have to exist.
+ *
+ * @param dir The directory a name that is not absolute belongs to.
+ * @param name The name of the file.
+ * @return The allocated path. If the directory does not exist, the name joined to dir is returned as it is.
+ */
+char *canonical_path(char *dir, char *name);
+
+/**
+ * @brief Copies the content of a file to another file.
+ *
+ * @param source_name The file to copy.
+ * @param dest_name The file to create or overwrite.
+ * @return 1 if the whole file was copied, 0 otherwise.
+ */
+int copy_file(char *source_name, char *dest_name);
+
+/**
+ * @brief Removes the files of an entry, or of a temporary directory, and the directory itself.
+ *
+ * @param entry The path of the directory.
+ */
+void remove_entry_dir(char *entry);
+
+/**
+ * @brief Compares two cache entries by the last time they were used, for qsort.
+ *
+ * @param a The first entry.
+ * @param b The second entry.
+ * @return A negative number if the first entry was used before the second one, a positive number otherwise.
+ */
+int compare_entries_by_use(const void *a, const void *b);
+
+/**
+ * @brief Prints the hit and miss counters of the cache and releases it.
+ *
+ * @param cache The cache.
+ */
+void cache_close(result_cache *cache);
+
+#endif
@@ -0,0 +1,311 @@
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "globals.h"
+#include "chunked_pass.h"
+#include "first_pass.h"
+#include "pre_assembler.h"
+#include "lexer.h"
+#include "arena.h"
+#include "report.h"
+#include "alloc_profile.h"
+
+/* The lines of a file after the pre-assembler, with the messages that were printed while they were pulled */
+typedef struct pulled_lines {
+	char **lines;
+	int count;
+	int capacity;
+	diagnostics diag;
+	message_mark *marks;
+	int mark_count;
+	int mark_capacity;
+} pulled_lines;
+
+void add_message_mark(message_mark **marks, int *count, int *capacity, arena *memory, int line, size_t end) {
+	message_mark *grown;
+
+	if (*count == *capacity) {
+		*capacity = (*capacity == 0) ? FIXUPS_INIT_SIZE : *capacity * 2;
+		grown = arena_alloc(memory, *capacity * sizeof(message_mark), ALLOC_MESSAGES);
+		if (*count > 0) {
+			memcpy(grown, *marks, *count * sizeof(message_mark));
+		}
+		*marks = grown;
+	}
+	(*marks)[*count].line = line;
+	(*marks)[*count].end = end;
+	(*count)++;
+}
+
+void append_image(memory_image *image, memory_image *part) {
+	if (part->count == 0) {
+		return;
+	}
+	memcpy(image->words + image->count, part->words, part->count * sizeof(unsigned short));
+	memcpy(image->lines + image->count, part->lines, part->count * sizeof(int));
+	image->count += part->count;
+}
+
+/* pulls all the lines of the source into the arena of the file, the messages of the pre-assembler are kept */
+static void pull_lines(line_source *source, pulled_lines *pulled) {
+	diagnostics *outer = captured_reports();
+	char **grown;
+	char *str;
+	size_t end = 0;
+
+	pulled->lines = NULL;
+	pulled->count = 0;
+	pulled->capacity = 0;
+	init_diagnostics(&pulled->diag);
+	pulled->marks = NULL;
+	pulled->mark_count = 0;
+	pulled->mark_capacity = 0;
+
+	capture_reports(&pulled->diag);
+	while ((str = next_line(source)) != NULL) {
+		if (pulled->count == pulled->capacity) {
+			pulled->capacity = (pulled->capacity == 0) ? IMAGE_INIT_SIZE : pulled->capacity * 2;
+			grown = arena_alloc(source->memory, pulled->capacity * sizeof(char *), ALLOC_LINES);
+			if (pulled->count > 0) {
+				memcpy(grown, pulled->lines, pulled->count * sizeof(char *));
+			}
+			pulled->lines = grown;
+		}
+		pulled->lines[pulled->count++] = arena_strndup(source->memory, str, strlen(str), ALLOC_LINES);
+		/* the messages up to here were printed before the line was read */
+		if (pulled->diag.out.length != end) {
+			end = pulled->diag.out.length;
+			add_message_mark(&pulled->marks, &pulled->mark_count, &pulled->mark_capacity, source->memory, pulled->count, end);
+		}
+	}
+	capture_reports(outer);
+}
+
+static void *run_chunk(void *arg) {
+	pass_chunk *chunk = arg;
+	diagnostics *outer = captured_reports();
+	alloc_profile *outer_profile = current_alloc_profile();
+	size_t end = 0;
+	int i;
+
+	/* the allocations of the chunk are counted with the file, whatever thread reads it */
+	use_alloc_profile(chunk->profile);
+	capture_reports(&chunk->diag);
+	for (i = 0; i < chunk->line_count; i++) {
+		first_pass_line(chunk, chunk->lines[i], chunk->first_line + i);
+		if (chunk->diag.out.length != end) {
+			end = chunk->diag.out.length;
+			add_message_mark(&chunk->marks, &chunk->mark_count, &chunk->mark_capacity, chunk->memory, chunk->first_line + i, end);
+		}
+	}
+	capture_reports(outer);
+	free_line_tokens(&chunk->tokens);
+	use_alloc_profile(outer_profile);
+	return NULL;
+}
+
+/* makes room for a number of words in an empty image */
+static void reserve_image(memory_image *image, int count) {
+	if (count > 0) {
+		image->words = arena_alloc(image->memory, count * sizeof(unsigned short), image->site);
+		image->lines = arena_alloc(image->memory, count * sizeof(int), image->site);
+		image->capacity = count;
+	}
+}
+
+/* merges the chunks into the pass over the whole file, and returns the number of lines whose
+ * code label was defined in an earlier line, they are saved in failed_lines */
+static int merge_chunks(pass_chunk *chunks, int count, pass_chunk *pass, int *failed_lines) {
+	pass_chunk *chunk;
+	label_definition *definition;
+	fixup *fix;
+	entry_request *entry;
+	int code_words = 0, data_words = 0, fixup_count = 0, entry_count = 0;
+	int code_offset = 0, data_offset = 0;
+	int failed = 0;
+	int address;
+	int i, j;
+
+	for (i = 0; i < count; i++) {
+		code_words += chunks[i].code.count;
+		data_words += chunks[i].data.count;
+		fixup_count += chunks[i].fixups.count;
+		entry_count += chunks[i].fixups.entry_count;
+	}
+	reserve_image(&pass->code, code_words);
+	reserve_image(&pass->data, data_words);
+	if (fixup_count > pass->fixups.capacity) {
+		pass->fixups.fixups = arena_alloc(pass->memory, fixup_count * sizeof(fixup), ALLOC_FIXUPS);
+		pass->fixups.capacity = fixup_count;
+	}
+	if (entry_count > pass->fixups.entry_capacity) {
+		pass->fixups.entries = arena_alloc(pass->memory, entry_count * sizeof(entry_request), ALLOC_FIXUPS);
+		pass->fixups.entry_capacity = entry_count;
+	}
+
+	for (i = 0; i < count; i++) {
+		chunk = &chunks[i];
+		/* the labels are added in the order of the lines, so the first definition of a name wins as in label_process */
+		for (j = 0; j < chunk->definition_count; j++) {
+			definition = &chunk->definitions[j];
+			address = definition->address;
+			if (definition->kind == SYMBOL_CODE) {
+				address += IC_INIT_VALUE + code_offset;
+			}
+			else if (definition->kind == SYMBOL_DATA) {
+				address += data_offset;
+			}
+			if (search_label(pass->symbols, definition->name, definition->name_length) != NULL) {
+				pass->is_valid = 0;
+				if (definition->kind == SYMBOL_CODE) {
+					failed_lines[failed++] = definition->line;
+				}
+			}
+			else {
+				add_label(pass->symbols, definition->name, definition->name_length, &address, definition->kind);
+			}
+		}
+		/* the names are copied out of the arena of the chunk, which is freed before the second pass */
+		for (j = 0; j < chunk->fixups.count; j++) {
+			fix = &pass->fixups.fixups[pass->fixups.count++];
+			*fix = chunk->fixups.fixups[j];
+			fix->name = arena_strndup(pass->memory, fix->name, fix->name_length, ALLOC_FIXUPS);
+			if (fix->slot != -1) {
+				fix->slot += code_offset;
+			}
+		}
+		for (j = 0; j < chunk->fixups.entry_count; j++) {
+			entry = &pass->fixups.entries[pass->fixups.entry_count++];
+			*entry = chunk->fixups.entries[j];
+			entry->name = arena_strndup(pass->memory, entry->name, entry->name_length, ALLOC_FIXUPS);
+		}
+		append_image(&pass->code, &chunk->code);
+		append_image(&pass->data, &chunk->data);
+		code_offset += chunk->IC;
+		data_offset += chunk->DC;
+		if (!chunk->is_valid) {
+			pass->is_valid = 0;
+		}
+	}
+	pass->IC = IC_INIT_VALUE + code_offset;
+	pass->DC = data_offset;
+	return failed;
+}
+
+/* returns the earlier of two lines, -1 stands for no line */
+static int earlier_line(int line, int other) {
+	return (line == -1 || (other != -1 && other < line)) ? other : line;
+}
+
+/* prints the kept messages in the order of the lines: for every line the messages of the pre-assembler,
+ * then the messages of its chunk, and last the message of a label that was defined in an earlier line */
+static void report_in_line_order(pulled_lines *pulled, pass_chunk *chunks, int count, int *failed_lines, int failed) {
+	pass_chunk *chunk;
+	size_t pulled_start = 0, chunk_start;
+	int p = 0, f = 0, m;
+	int line, end_line;
+	int i;
+
+	/* only the pre-assembler writes to stderr, the two streams are not ordered with each other */
+	if (pulled->diag.err.length > 0) {
+		report_kept(&pulled->diag, 1, 0, pulled->diag.err.length);
+	}
+	for (i = 0; i < count; i++) {
+		chunk = &chunks[i];
+		end_line = chunk->first_line + chunk->line_count;
+		chunk_start = 0;
+		m = 0;
+		for (;;) {
+			line = (p < pulled->mark_count && pulled->marks[p].line < end_line) ? pulled->marks[p].line : -1;
+			if (m < chunk->mark_count) {
+				line = earlier_line(line, chunk->marks[m].line);
+			}
+			if (f < failed && failed_lines[f] < end_line) {
+				line = earlier_line(line, failed_lines[f]);
+			}
+			if (line == -1) {
+				break;
+			}
+			if (p < pulled->mark_count && pulled->marks[p].line == line) {
+				report_kept(&pulled->diag, 0, pulled_start, pulled->marks[p].end);
+				pulled_start = pulled->marks[p++].end;
+			}
+			if (m < chunk->mark_count && chunk->marks[m].line == line) {
+				report_kept(&chunk->diag, 0, chunk_start, chunk->marks[m].end);
+				chunk_start = chunk->marks[m++].end;
+			}
+			if (f < failed && failed_lines[f] == line) {
+				report_at(line, "invalid label in line: %d\n", line);
+				f++;
+			}
+		}
+		if (chunk->diag.err.length > 0) {
+			report_kept(&chunk->diag, 1, 0, chunk->diag.err.length);
+		}
+	}
+	/* the messages of the pre-assembler after the last line */
+	report_kept(&pulled->diag, 0, pulled_start, pulled->diag.out.length);
+}
+
+void chunked_first_pass(line_source *source, int threads, pass_chunk *pass, symbol_table *symbols) {
+	pulled_lines pulled;
+	pass_chunk *chunks;
+	arena *memories;
+	pthread_t *ids;
+	int *failed_lines;
+	int count, per_chunk, failed;
+	int definitions = 0;
+	int i;
+
+	/* the pre-assembler keeps state from line to line, so the lines are pulled before they are split */
+	pull_lines(source, &pulled);
+	count = pulled.count / CHUNK_MIN_LINES;
+	if (count > threads) {
+		count = threads;
+	}
+	if (count < 1) {
+		count = 1;
+	}
+	chunks = handle_malloc(count * sizeof(pass_chunk), ALLOC_TABLES);
+	memories = handle_malloc(count * sizeof(arena), ALLOC_TABLES);
+	ids = handle_malloc(count * sizeof(pthread_t), ALLOC_TABLES);
+	per_chunk = pulled.count / count;
+	for (i = 0; i < count; i++) {
+		/* every chunk has an arena of its own and counters that start at 0, the labels wait for the merge */
+		init_arena(&memories[i]);
+		init_pass_chunk(&chunks[i], 0, NULL, &memories[i]);
+		chunks[i].lines = pulled.lines + i * per_chunk;
+		chunks[i].first_line = i * per_chunk + 1;
+		chunks[i].line_count = (i == count - 1) ? pulled.count - i * per_chunk : per_chunk;
+	}
+	/* the first chunk is read by the calling thread */
+	for (i = 1; i < count; i++) {
+		if (pthread_create(&ids[i], NULL, run_chunk, &chunks[i]) != 0) {
+			fprintf(stderr, "Error: failed to start a thread\n");
+			exit(1);
+		}
+	}
+	run_chunk(&chunks[0]);
+	for (i = 1; i < count; i++) {
+		pthread_join(ids[i], NULL);
+	}
+
+	init_pass_chunk(pass, IC_INIT_VALUE, symbols, source->memory);
+	for (i = 0; i < count; i++) {
+		definitions += chunks[i].definition_count;
+	}
+	failed_lines = arena_alloc(source->memory, (definitions + 1) * sizeof(int), ALLOC_LABELS);
+	failed = merge_chunks(chunks, count, pass, failed_lines);
+	report_in_line_order(&pulled, chunks, count, failed_lines, failed);
+
+	for (i = 0; i < count; i++) {
+		free_diagnostics(&chunks[i].diag);
+		free_arena(&memories[i]);
+	}
+	free_diagnostics(&pulled.diag);
+	handle_free(ids);
+	handle_free(memories);
+	handle_free(chunks);
+}
@@ -0,0 +1,42 @@
+#ifndef LABRATORY_C_FINAL_PROJECT_CHUNKED_PASS_H
+#define LABRATORY_C_FINAL_PROJECT_CHUNKED_PASS_H
+
+#include "globals.h"
+
+/**
+ * @brief Performs the first pass of a file in chunks of lines on several threads.
+ *
+ * The lines are pulled from the pre-assembler first. Each chunk encodes its lines into images of its own,
+ * with counters that start at 0, and keeps its labels for later. The chunks are then merged in order:
+ * the counters of the chunks before are added to the addresses, and the labels are added to the symbol
+ * table line by line, so a label defined twice fails on the same line as in a pass over the whole file.
+ * The messages of the chunks are kept and printed in the order of the lines.
+ *
+ * @param source The line source of the file.
+ * @param threads The largest number of threads, a chunk has at least CHUNK_MIN_LINES lines.
+ * @param pass The pass over the whole file, it receives the merged counters, images and fixups.
+ * @param symbols The symbol table of the file, empty.
+ */
+void chunked_first_pass(line_source *source, int threads, pass_chunk *pass, symbol_table *symbols);
+
+/**
+ * @brief Adds a mark at the end of the messages of a line, the array of marks grows as needed.
+ *
+ * @param marks The array of marks.
+ * @param count The number of marks.
+ * @param capacity The number of marks the array can hold.
+ * @param memory The arena that holds the array.
+ * @param line The line.
+ * @param end The number of characters of the messages up to the end of the line.
+ */
+void add_message_mark(message_mark **marks, int *count, int *capacity, arena *memory, int line, size_t end);
+
+/**
+ * @brief Copies the words of a chunk to the end of the image of the whole file.
+ *
+ * @param image The image of the whole file, it has room for the words.
+ * @param part The image of the chunk.
+ */
+void append_image(memory_image *image, memory_image *part);
+
+#endif
@@ -0,0 +1,78 @@
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "globals.h"
+#include "file_reader.h"
+#include "pre_assembler.h"
+
+/* Size of the first buffer when the input cannot be mapped */
+#define READ_CHUNK_SIZE 65536
+
+int open_input(char *file_name, input_file *input) {
+	struct stat st;
+	ssize_t count;
+	size_t capacity;
+	int fd;
+
+	input->data = NULL;
+	input->size = 0;
+	input->pos = 0;
+	input->is_mapped = 0;
+	input->is_borrowed = 0;
+
+	fd = open(file_name, O_RDONLY);
+	if (fd < 0) {
+		return 0;
+	}
+	if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+		void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data != MAP_FAILED) {
+			posix_madvise(data, (size_t)st.st_size, POSIX_MADV_SEQUENTIAL);
+			input->data = data;
+			input->size = (size_t)st.st_size;
+			input->is_mapped = 1;
+			close(fd);
+			return 1;
+		}
+	}
+
+	/* fall back to reading the whole input into a buffer */
+	capacity = READ_CHUNK_SIZE;
+	input->data = handle_malloc(capacity, ALLOC_BUFFERS);
+	while ((count = read(fd, input->data + input->size, capacity - input->size)) != 0) {
+		if (count < 0) {
+			handle_free(input->data);
+			input->data = NULL;
+			input->size = 0;
+			close(fd);
+			return 0;
+		}
+		input->size += (size_t)count;
+		if (input->size == capacity) {
+			char *bigger = handle_malloc(capacity * 2, ALLOC_BUFFERS);
+			memcpy(bigger, input->data, input->size);
+			handle_free(input->data);
+			input->data = bigger;
+			capacity *= 2;
+		}
+	}
+	close(fd);
+	return 1;
+}
+
+void close_input(input_file *input) {
+	if (input->is_mapped) {
+		munmap(input->data, input->size);
+	}
+	else if (!input->is_borrowed) {
+		handle_free(input->data);
+	}
+	input->data = NULL;
+	input->size = 0;
+	input->pos = 0;
+}
@@ -0,0 +1,25 @@
+#ifndef LABRATORY_C_FINAL_PROJECT_FILE_READER_H
+#define LABRATORY_C_FINAL_PROJECT_FILE_READER_H
+
+#include "globals.h"
+
+/**
+ * @brief Opens an input file and loads its content.
+ *
+ * A regular file is mapped to memory once with mmap. Other files, like pipes, cannot be mapped,
+ * so they are read into a buffer that grows until the end of the input.
+ *
+ * @param file_name The name of the file to open.
+ * @param input The input file to initialize.
+ * @return 1 if the file was loaded, 0 if it could not be opened or read.
+ */
+int open_input(char *file_name, input_file *input);
+
+/**
+ * @brief Releases the content of an input file that was opened with open_input.
+ *
+ * @param input The input file to close.
+ */
+void close_input(input_file *input);
+
+#endif
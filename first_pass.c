@@ -6,199 +6,266 @@
 #include "first_pass.h"
 #include "pre_assembler.h"
 #include "second_pass.h"
-#define stop_with_error()                                 \
-    do                                                    \
-    {                                                     \
-        free_label_list(label_head);                      \
-        free_instruction_memory(instruction_memory_head); \
-        return 0;                                         \
-    } while (0)
+#include "lexer.h"
+#include "object.h"
+#include "binary_object.h"
+#include "chunked_pass.h"
+#include "arena.h"
+#include "report.h"
+#include "stats.h"
+#include "alloc_profile.h"
 
-int implement_first_pass(char file_name[],node **head)
+int implement_first_pass(line_source *source,assembler_options *options,assembly_result *result)
 {
-    
     int is_valid_file = 1;
     /* string to save the current line */
-    char str[MAX_LINE_LENGTH] = {0};
-    /* strings to divide the line into sections */
-    char first_word[MAX_LINE_LENGTH] = {0};
-    char second_word[MAX_LINE_LENGTH] = {0};
-    char rest_of_line[MAX_LINE_LENGTH] = {0};
-    /* strings to save the lines to write into entry and extern files */
-    /* string to handle the name of files */
-    char *temp_ob_file, *ob_file;
-
-    FILE *fp, *temp_ob_p;
-
-    /* Initialize IC and DC pointers */
-    int IC = IC_INIT_VALUE;
-    int IC_CURRENT = IC_INIT_VALUE;
-    int extern_address = 0;
-    int DC = 0;
-    int DC_CURRENT = 0;
-    instruction_memory *instruction_memory_head = NULL;
-    data_image *data_image_head = NULL;
-    label *label_head = NULL;
+    char *str;
+    /* the counters, the images and the fixups of the whole file */
+    pass_chunk pass;
+    symbol_table symbols;
+    /* the statistics of the file, NULL if they are not kept */
+    assembly_stats *stats = source->stats;
+    long start = 0, pulled = 0;
 
     int line = 0;
 
-    /* opening the am file to read */
-    fp = fopen(file_name, "r");
-    if (fp == NULL)
+    /* the labels and the words are kept in the arena of the file, they are released together with it */
+    init_symbol_table(&symbols, source->memory);
+    if (stats != NULL)
     {
-        printf("Failed to open file: %s\n", file_name);
-        return 0;
+        /* the lines are pulled inside the pass, the time of the pre-assembler is taken out of it */
+        start = stats_clock();
+        pulled = stats->nanoseconds[STATS_PRE_ASSEMBLER];
+    }
+    if (options->pass_threads > 1)
+    {
+        /* a large file is read in chunks on several threads, the result is the same as reading it line by line */
+        chunked_first_pass(source, options->pass_threads, &pass, &symbols);
+    }
+    else
+    {
+        init_pass_chunk(&pass, IC_INIT_VALUE, &symbols, source->memory);
+        /* pull the lines from the pre-assembler and parsing them */
+        while ((str = next_line(source)) != NULL)
+        {
+            first_pass_line(&pass, str, ++line);
+        }
+        free_line_tokens(&pass.tokens);
+    }
+    is_valid_file = pass.is_valid;
+    update_data_label(&symbols, pass.IC);
+    if (stats != NULL)
+    {
+        stats->nanoseconds[STATS_FIRST_PASS] += stats_clock() - start - (stats->nanoseconds[STATS_PRE_ASSEMBLER] - pulled);
+        stats->labels = symbols.count;
+        stats->instruction_words = pass.IC - IC_INIT_VALUE;
+        stats->data_words = pass.DC;
+        stats->fixups = pass.fixups.count;
+        stats->entries = pass.fixups.entry_count;
+    }
+    /* end first pass and parsing the line without entry  */
+    if (!source->is_valid)
+    {
+        is_valid_file = 0; /* errors in the macro declarations */
     }
 
-    temp_ob_file = add_new_file(file_name, ".tob");
-    temp_ob_p = fopen(temp_ob_file, "w");
-    if (temp_ob_p == NULL)
+    if (!is_valid_file)
     {
-        printf("Failed to open file: %s\n", temp_ob_file);
-        fclose(fp); /* Close the opened file before returning */
         return 0;
     }
+    start = (stats != NULL) ? stats_clock() : 0;
+    is_valid_file = implement_second_pass(&pass.fixups, &symbols, &pass.code, &result->outputs[OUTPUT_ENT], &result->outputs[OUTPUT_EXT]);
+    if (stats != NULL)
+    {
+        stats->nanoseconds[STATS_SECOND_PASS] += stats_clock() - start;
+        start = stats_clock();
+    }
+    if (!is_valid_file)
+    {
+        return 0; /* an address that does not fit in its operand */
+    }
+    /* the images are rendered straight into the content of the .ob file */
+    append_object(&pass.code, &pass.data, pass.IC, pass.DC, &result->outputs[OUTPUT_OB]);
+    if (options->emit_obb)
+    {
+        append_binary_object(&pass.code, &pass.data, pass.IC, pass.DC, &pass.fixups, &symbols, &result->outputs[OUTPUT_OBB]);
+    }
+    if (stats != NULL)
+    {
+        stats->nanoseconds[STATS_OBJECT] += stats_clock() - start;
+    }
+    /* an empty .ent or .ext file is not written */
+    result->has_output[OUTPUT_OB] = 1;
+    result->has_output[OUTPUT_ENT] = (result->outputs[OUTPUT_ENT].length > 0);
+    result->has_output[OUTPUT_EXT] = (result->outputs[OUTPUT_EXT].length > 0);
+    result->has_output[OUTPUT_OBB] = options->emit_obb;
+    return 1;
+}
 
-    ob_file = add_new_file(file_name, ".ob");
+void init_pass_chunk(pass_chunk *chunk, int base, symbol_table *symbols, arena *memory)
+{
+    chunk->lines = NULL;
+    chunk->first_line = 1;
+    chunk->line_count = 0;
+    chunk->IC = base;
+    chunk->DC = 0;
+    chunk->memory = memory;
+    init_memory_image(&chunk->code, base, memory, ALLOC_INSTRUCTION_WORDS);
+    init_memory_image(&chunk->data, 0, memory, ALLOC_DATA_WORDS);
+    chunk->symbols = symbols;
+    chunk->definitions = NULL;
+    chunk->definition_count = 0;
+    chunk->definition_capacity = 0;
+    init_fixup_list(&chunk->fixups, memory);
+    init_line_tokens(&chunk->tokens);
+    init_diagnostics(&chunk->diag);
+    chunk->marks = NULL;
+    chunk->mark_count = 0;
+    chunk->mark_capacity = 0;
+    chunk->profile = current_alloc_profile();
+    chunk->is_valid = 1;
+}
 
-    /* read line from file and parsing it */
-    while (fgets(str, MAX_LINE_LENGTH, fp))
-    {
-        line++;
-        IC_CURRENT = IC; /*save the current ic before change*/
-        DC_CURRENT = DC;
-        memset(first_word, 0, MAX_LINE_LENGTH);
-        memset(second_word, 0, MAX_LINE_LENGTH);
-        memset(rest_of_line, 0, MAX_LINE_LENGTH);
+int define_label(pass_chunk *chunk, const char *name, size_t length, int address, symbol_kind kind, int line)
+{
+    label_definition *grown;
 
-        sscanf(str, "%s %s %s", first_word, second_word, rest_of_line);
-        if (*str == ';')
-        { /* if its a comment, ignor. */
-            continue;
+    if (chunk->symbols != NULL)
+    {
+        return label_process(name, length, &address, chunk->symbols, kind, line);
+    }
+    /* the same checks as label_process, but a label of an earlier chunk is found only at the merge */
+    if (length > MAX_LABEL_LENGTH)
+    {
+        report_at(line, "The label is too long\n");
+        return 0;
+    }
+    if (length > 0 && name[length - 1] == ':')
+    {
+        length--;
+    }
+    if (!is_valid_label(name, length))
+    {
+        return 0;
+    }
+    if (chunk->definition_count == chunk->definition_capacity)
+    {
+        chunk->definition_capacity = (chunk->definition_capacity == 0) ? FIXUPS_INIT_SIZE : chunk->definition_capacity * 2;
+        grown = arena_alloc(chunk->memory, chunk->definition_capacity * sizeof(label_definition), ALLOC_LABELS);
+        if (chunk->definition_count > 0)
+        {
+            memcpy(grown, chunk->definitions, chunk->definition_count * sizeof(label_definition));
         }
-        if (endsWithColon(first_word))
-        { /* optional label */
-            if (is_instruction(second_word))
+        chunk->definitions = grown;
+    }
+    /* the lines of a chunk are kept until the end of the file, so the name is not copied */
+    grown = &chunk->definitions[chunk->definition_count++];
+    grown->name = name;
+    grown->name_length = length;
+    grown->address = address;
+    grown->kind = kind;
+    grown->line = line;
+    return 1;
+}
+
+void first_pass_line(pass_chunk *chunk, char *str, int line)
+{
+    line_tokens *tokens = &chunk->tokens;
+    token *statement;
+    /* the counters before the line, the address of its label */
+    int IC_CURRENT = chunk->IC;
+    int DC_CURRENT = chunk->DC;
+
+    lex_line(str, tokens);
+    if (tokens->count == 0)
+    { /* an empty line, ignor. */
+        return;
+    }
+    statement = (tokens->statement != -1) ? &tokens->tokens[tokens->statement] : NULL;
+    if (tokens->tokens[0].kind == TOKEN_LABEL_DEF)
+    { /* optional label */
+        if (statement == NULL)
+        {
+            return; /* a label without an instruction is ignored */
+        }
+        if (statement->kind == TOKEN_DIRECTIVE)
+        {
+            if (instruction_data_process(tokens, &chunk->DC, line, &chunk->data))
             {
-                if (!strcmp(first_word, ".entry") || !strcmp(first_word, ".extern"))
-                {
-                    continue; /*ignor from defination label on .entry/.extern */
-                }
-                else if (instruction_data_process(str, second_word, rest_of_line, &DC, line, &data_image_head))
-                {
-                    if (!label_process(first_word, &DC_CURRENT, &label_head, ".data"))
-                    {
-                        is_valid_file = 0; /*or label or instruction wrong*/
-                    }
-                }
-                else
+                if (!define_label(chunk, tokens->tokens[0].start, tokens->tokens[0].length, DC_CURRENT, SYMBOL_DATA, line))
                 {
-                    printf("invalid instruction in line: %d\n", line);
-                    is_valid_file = 0; /*or label or instruction wrong*/
+                    chunk->is_valid = 0; /*or label or instruction wrong*/
                 }
             }
-            else if (opcode_detection(second_word))
+            else
             {
-                if (opcode_process(second_word, rest_of_line, &IC, line, &instruction_memory_head))
+                report_at(line, "invalid instruction in line: %d\n", line);
+                chunk->is_valid = 0; /*or label or instruction wrong*/
+            }
+        }
+        else
+        {
+            if (statement->kind == TOKEN_MNEMONIC)
+            {
+                if (opcode_process(tokens, &chunk->IC, line, &chunk->code))
                 {
-                    if (!label_process(first_word, &IC_CURRENT, &label_head, ".code"))
+                    if (!define_label(chunk, tokens->tokens[0].start, tokens->tokens[0].length, IC_CURRENT, SYMBOL_CODE, line))
                     {
-                        printf("invalid label in line: %d\n", line);
-                        is_valid_file = 0;
+                        report_at(line, "invalid label in line: %d\n", line);
+                        chunk->is_valid = 0;
                         ; /*invalid label */
                     }
                 }
                 else
                 {
-                    printf("invalid code line: %d\n", line);
-                    is_valid_file = 0; /*invalid opcode*/
+                    report_at(line, "invalid code line: %d\n", line);
+                    chunk->is_valid = 0; /*invalid opcode*/
                 }
             }
+            /* the operands are looked up after a label even when the word after it is not an opcode */
+            add_operand_fixups(&chunk->fixups, tokens, line, &chunk->code, IC_CURRENT);
         }
-        else if (is_instruction(first_word))
+    }
+    else if (statement->kind == TOKEN_DIRECTIVE)
+    {
+        if (statement->value == ENTRY_INSTRUCTION)
         {
-            if (!strcmp(first_word, ".entry"))
-            {
-
-                continue;
-            }
-            else if (!strcmp(first_word, ".extern"))
-            {
-                if (!label_process(second_word, &extern_address, &label_head, ".external"))
-                    is_valid_file = 0;
-            }
-            else if (!instruction_data_process(str, first_word, second_word, &DC, line, &data_image_head))
-            {
-                is_valid_file = 0;
-            }
+            /* the label may be defined below, the .ent file is written after the first pass */
+            add_entry_request(&chunk->fixups, tokens->operands.start, tokens->operands.length, line);
         }
-        else if (opcode_detection(first_word))
+        else if (statement->value == EXTERN_INSTRUCTION)
         {
-            if (!opcode_process(first_word, second_word, &IC, line, &instruction_memory_head))
-            {
-                is_valid_file = 0;
-            }
+            /* the address of an external label is found by the linker */
+            if (!define_label(chunk, tokens->operands.start, tokens->operands.length, 0, SYMBOL_EXTERNAL, line))
+                chunk->is_valid = 0;
         }
-        else
+        else if (!instruction_data_process(tokens, &chunk->DC, line, &chunk->data))
         {
-            if (is_empty_line(str))
-            {
-                continue;
-            }
-            else
-            {
-                printf("Error: Unrecognized line format in line %d: %s\n", line, str);
-                is_valid_file = 0;
-            }
+            chunk->is_valid = 0;
         }
     }
-    update_data_label(label_head, IC);
-    /* end first pass and parsing the line without entry  */
-
-    if (!is_valid_file)
+    else if (statement->kind == TOKEN_MNEMONIC)
     {
-        return 0;
+        if (!opcode_process(tokens, &chunk->IC, line, &chunk->code))
+        {
+            chunk->is_valid = 0;
+        }
+        add_operand_fixups(&chunk->fixups, tokens, line, &chunk->code, IC_CURRENT);
     }
-    if (!implement_second_pass(file_name, &label_head, &instruction_memory_head, &data_image_head))
+    else
     {
-        printf("second pass failed\n");
-        is_valid_file = 0;
+        report_at(line, "Error: Unrecognized line format in line %d: %.*s\n", line, (int)strcspn(str, "\n"), str);
+        chunk->is_valid = 0;
     }
-    printf("File closed: %s\n", file_name);
-    print_memory(instruction_memory_head, data_image_head, IC, DC, temp_ob_p);
-    fclose(temp_ob_p);
-    copyAndConvertFile(temp_ob_file, ob_file);
-    remove(temp_ob_file);
-    fclose(fp);
-
-    free_label_list(label_head);
-    free_instruction_memory(instruction_memory_head);
-    return is_valid_file;
 }
 
-void printlist_label(label *head)
+void printlist_label(symbol_table *symbols)
 {
-    while (head)
-    {
-        printf("The name of label is: %s\n", head->name_of_label);
-        printf("The address of label: %d\n", head->address_of_label);
-        printf("The type of label: %s\n", head->type_of_label);
-        head = head->next;
-    }
-}
-
-void print_memory(instruction_memory *instruction_head, data_image *data_head, int IC, int DC, FILE *fp)
-{
-    fprintf(fp, "   %d %d\n", IC - IC_INIT_VALUE, DC);
-    while (instruction_head)
-    {
-        fprintf(fp, "%d          %s\n", instruction_head->address, instruction_head->binary_str);
-        instruction_head = instruction_head->next;
-    }
-    while (data_head)
+    int i;
+    for (i = 0; i < symbols->count; i++)
     {
-        data_head->address += IC;
-        fprintf(fp, "%d          %s\n", data_head->address, data_head->binary_value);
-        data_head = data_head->next;
+        printf("The name of label is: %s\n", label_name(symbols, &symbols->labels[i]));
+        printf("The address of label: %d\n", symbols->labels[i].address_of_label);
+        printf("The kind of label: %d\n", (int)symbols->labels[i].kind);
     }
 }
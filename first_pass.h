@@ -5,20 +5,57 @@
  * @brief Performs the first pass on the assembly file.
  *
  * This function processes an assembly file in the first pass, which includes:
- * 1. Opening the source file and corresponding .ent and .ext files for writing.
- * 2. Parsing each line of the file to detect labels, instructions, and directives.
- * 3. Storing labels and their associated addresses in a linked list.
- * 4. Handling .entry and .extern directives.
- * 5. Processing data and instruction memory storage for later use in the second pass.
- * 6. Handling errors related to invalid labels, instructions, or opcodes.
- * 7. Finalizing the first pass by updating label addresses and preparing for the second pass.
- * 8. Printing memory and label data for verification.
+ * 1. Pulling each line from the pre-assembler and parsing it to detect labels, instructions, and directives.
+ * 2. Storing labels and their associated addresses in the symbol table.
+ * 3. Handling .extern directives, and recording the .entry requests and the label operands as fixups.
+ * 4. Storing the words of the data and the instructions in their images for later use in the second pass.
+ * 5. Handling errors related to invalid labels, instructions, or opcodes.
+ * 6. Finalizing the first pass by updating label addresses and resolving the fixups in the second pass.
+ * 7. Rendering the ".ob", ".ent" and ".ext" files into the outputs of the result, for a valid file,
+ *    and the ".obb" file when the options ask for it.
  *
- * @param file_name The name of the file to be processed in the first pass.
- * @param head A pointer to the head of the linked list for storing macro definitions.
- * @return Returns 0 if the first pass was completed successfully, or an error code if a failure occurred.
+ * @param source The line source that returns the lines of the file after the pre-assembler.
+ * @param options The options of the assembler: pass_threads, the number of threads that may share the first pass
+ *                (1 to read the lines one by one), and emit_obb.
+ * @param result The result that receives the output files, they are left empty if the file is not valid.
+ * @return Returns 1 if the file was assembled successfully, or 0 if an error was found.
  */
-int implement_first_pass(char file_name[],node **head);  
+int implement_first_pass(line_source *source,assembler_options *options,assembly_result *result);
+
+/**
+ * @brief Initializes the first pass over a chunk of lines.
+ *
+ * @param chunk The chunk to initialize.
+ * @param base The address of the first instruction of the chunk.
+ * @param symbols The symbol table that the labels are added to, or NULL to keep them in the chunk until the merge.
+ * @param memory The arena of the chunk.
+ */
+void init_pass_chunk(pass_chunk *chunk, int base, symbol_table *symbols, arena *memory);
+
+/**
+ * @brief Reads one line in the first pass: encodes its words, defines its label and records its fixups.
+ *
+ * @param chunk The chunk of the line.
+ * @param str The line after the pre-assembler.
+ * @param line The number of the line.
+ */
+void first_pass_line(pass_chunk *chunk, char *str, int line);
+
+/**
+ * @brief Defines the label of a line, in the symbol table or among the labels of the chunk.
+ *
+ * A label kept in the chunk is checked like in label_process, except that a label of the same name
+ * is looked for only when the chunks are merged.
+ *
+ * @param chunk The chunk of the line.
+ * @param name The label, it does not have to end with '\0'.
+ * @param length The number of characters in the label.
+ * @param address The address of the label, from the start of the code or the data of the chunk.
+ * @param kind The kind of the label.
+ * @param line The number of the line.
+ * @return 1 if the label is valid so far, 0 otherwise.
+ */
+int define_label(pass_chunk *chunk, const char *name, size_t length, int address, symbol_kind kind, int line);
 
 
 /**
@@ -27,19 +64,19 @@ int implement_first_pass(char file_name[],node **head);
  * This function handles the detection and validation of labels in the assembly code, performing the following steps:
  * 1. Removes the colon (`:`) at the end of the label if present.
  * 2. Checks if the label length exceeds the maximum allowed length.
- * 3. Searches for the label in the existing linked list of labels.
- * 4. If the label is not found and is valid, it adds the label to the linked list with its corresponding address.
+ * 3. Searches for the label in the symbol table.
+ * 4. If the label is not found and is valid, it adds the label to the symbol table with its corresponding address.
  *
- * @param first_word The label to be processed (e.g., "LOOP:").
+ * @param name The label to be processed (e.g., "LOOP:"), it does not have to end with '\0'.
+ * @param length The number of characters in the label.
  * @param p_address A pointer to the address associated with the label (e.g., instruction or data address).
+ * @param symbols The symbol table where labels are stored.
+ * @param kind The kind of the label: SYMBOL_CODE, SYMBOL_DATA or SYMBOL_EXTERNAL.
  * @param line The current line number being processed in the assembly file.
- * @param label_head A pointer to the head of the linked list where labels are stored.
- * @param type_of_label A string indicating the type of the label (e.g., ".code", ".data", ".external").
- * @param head A pointer to the head of the linked list for storing macro definitions.
  * @return Returns 1 if the label was processed and added successfully, 0 if the label was invalid or already existed.
  */
 
-int label_process(char* first_word, int* p_address, label** label_head,char *type_of_label);
+int label_process(const char* name, size_t length, int* p_address, symbol_table* symbols, symbol_kind kind, int line);
 
 /**
  * @brief Processes an instruction related to data in the assembly code.
@@ -49,66 +86,85 @@ int label_process(char* first_word, int* p_address, label** label_head,char *typ
  * 1. Detects and processes data instructions using the `instr_data_detection` function.
  * 2. If the instruction is not recognized, it prints an error message indicating an undefined instruction.
  *
- * @param str The current line of assembly code being processed.
- * @param first_word The first word in the line, typically representing the instruction.
- * @param rest_of_line The remaining part of the line after the first word, containing the data or operands.
+ * @param tokens The tokens of the line, the instruction and the data or operands after it.
  * @param DC A pointer to the Data Counter (DC), which tracks the memory address for data storage.
  * @param line The current line number being processed in the assembly file.
- * @param data_image_head A pointer to the head of the linked list where data instructions are stored.
- * @return Returns 1 if the instruction was successfully processed, 0 if the instruction was undefined.
+ * @param data The data image where the data words are stored.
+ * @return Returns 1 if the instruction was successfully processed, 0 if the instruction was undefined
+ *         or a number of its data does not fit in a data word.
  */
-int instruction_data_process(char *str,char *first_word, char *rest_of_line,int * DC,int line,data_image **data_image_head);
+int instruction_data_process(line_tokens *tokens,int * DC,int line,memory_image *data);
 
 /**
  * @brief Processes an opcode instruction in the assembly code.
  *
  * This function handles the parsing and conversion of an opcode instruction into its binary form
- * and stores it in the instruction memory. It performs the following steps:
+ * and stores it in the instruction image. It performs the following steps:
  * 1. Validates the number of arguments for the given opcode.
  * 2. Parses the arguments and converts them into binary strings.
- * 3. Adds the binary representation of the opcode and its arguments to the instruction memory.
+ * 3. Adds the binary representation of the opcode and its arguments to the instruction image.
  * 4. Increments the Instruction Counter (IC) for each piece of binary data added to the memory.
  * 5. Frees allocated memory used for binary strings after processing.
  *
- * @param first_word The opcode to be processed.
- * @param rest_of_line The remaining part of the line containing the operands.
+ * @param tokens The tokens of the line, the opcode to be processed and its operands.
  * @param IC A pointer to the Instruction Counter (IC), tracking the current memory address for instructions.
  * @param line The current line number in the assembly file.
- * @param instruction_memory_head A pointer to the head of the instruction memory linked list.
+ * @param code The instruction image.
  * @param head A pointer to the head of the macro linked list.
  * @return Returns 1 if the opcode and its arguments were successfully processed, 0 if an error occurred.
  */
-int opcode_process(char *first_word, char *rest_of_line,int * IC,int line,instruction_memory **instruction_memory_head);
+int opcode_process(line_tokens *tokens,int * IC,int line,memory_image *code);
+
+
+
 
 /**
- * @brief Converts a decimal number to a binary representation.
+ * @brief Finds the field of an addressing method in the first word of an instruction.
+ *
+ * Each addressing method has its own bit in the 4 bits of the field.
  *
- * This function converts a given decimal number into its binary representation and stores
- * it in the provided character array. The binary string is right-aligned and padded with '0'
- * to match the specified length.
+ * @param addressing_mode The addressing method, 0 to 3, or -2 for a missing operand.
+ * @return The value of the field, 0 for a missing operand.
+ */
+int addressing_mode_field(int addressing_mode);
+
+/**
+ * @brief Encodes the first word of an instruction.
  *
- * @param length The length of the binary representation, including the null terminator.
- * @param decimal The decimal number to be converted to binary.
- * @param binary The character array where the binary representation will be stored. 
- *               It should have at least 'length' + 1 elements to accommodate the null terminator.
+ * @param num_of_opcode The number of the opcode.
+ * @param type_of_source_arg The addressing method of the source operand, -2 if there is none.
+ * @param type_of_target_arg The addressing method of the target operand, -2 if there is none.
+ * @return The 15-bit word, with an absolute A/R/E field.
  */
-void convert_to_binary(int length, int decimal, char binary[]);
+int encode_first_word(int num_of_opcode, int type_of_source_arg, int type_of_target_arg);
 
+/**
+ * @brief Encodes a word with a 12-bit operand, a number or the address of a label.
+ *
+ * The operand is kept in two's complement, only its lowest 12 bits are used.
+ *
+ * @param value The operand.
+ * @param ARE The A/R/E field of the word: ARE_ABSOLUTE, ARE_RELOCATABLE or ARE_EXTERNAL.
+ * @return The 15-bit word.
+ */
+int encode_operand_word(int value, int ARE);
 
 /**
- * @brief Converts a decimal number to its binary representation, handling negative numbers.
+ * @brief Checks if an immediate or an address fits in the 12 bits of an operand word.
  *
- * This function converts a given decimal number to its binary representation and stores
- * it in the provided character array. The binary string is padded with '0's to ensure it
- * matches the specified length. If the number is negative, the function computes its two's
- * complement representation.
+ * @param value The immediate or the address.
+ * @return 1 if the value is between OPERAND_MIN and OPERAND_MAX, 0 otherwise.
+ */
+int operand_fits(int value);
+
+/**
+ * @brief Encodes the word of the register operands of an instruction.
  *
- * @param length The length of the binary representation, including the null terminator.
- * @param decimal The decimal number to be converted to binary.
- * @param binary The character array where the binary representation will be stored. 
- *               It should have at least 'length' + 1 elements to accommodate the null terminator.
+ * @param source_register The number of the source register, 0 if there is none.
+ * @param target_register The number of the target register, 0 if there is none.
+ * @return The 15-bit word, with an absolute A/R/E field.
  */
-void decimal_to_binary(int length, int decimal, char binary[]);
+int encode_register_word(int source_register, int target_register);
 
 /**
  * @brief Detects and processes data-related instructions in a given string.
@@ -116,116 +172,87 @@ void decimal_to_binary(int length, int decimal, char binary[]);
  * This function checks if the instruction is related to data definition (".data" or ".string") 
  * and processes it accordingly. It updates the data image and data count based on the instruction.
  *
- * @param str The input string that contains the instruction and additional data.
- * @param first_word The instruction keyword (e.g., ".data" or ".string").
- * @param rest_of_line A buffer to store the remaining part of the line after the instruction keyword.
+ * @param tokens The tokens of the line, the instruction keyword (e.g., ".data" or ".string") and the data after it.
  * @param DC A pointer to the data count (DC) which is updated during processing.
  * @param line The line number where the instruction was found.
- * @param data_image_head A pointer to the head of the data image linked list, which is updated during processing.
+ * @param data The data image, which is updated during processing.
+ * @param fits Set to 0 if a number of a .data line does not fit in a data word, left unchanged otherwise.
  *
  * @return 1 if the instruction was recognized and processed successfully, 0 otherwise.
  */
-int instr_data_detection(char *str,char *first_word, char *rest_of_line,int * DC,int line,data_image **data_image_head);
+int instr_data_detection(line_tokens *tokens,int * DC,int line,memory_image *data,int *fits);
 
 /**
- * @brief Detects if a given string is a valid instruction.
+ * @brief Finds the slot of a name in the perfect hash table of the reserved words.
  *
- * This function checks whether the input string matches any of the known instructions 
- * by comparing it against a predefined list of instructions. 
- *
- * @param str The input string to be checked for validity as an instruction.
- *
- * @return 1 if the string matches a known instruction, 0 otherwise.
+ * @param name The name, it does not have to end with '\0' but must have at least two characters.
+ * @param length The number of characters in the name.
+ * @return The slot, the only one where the name can be found.
  */
-int instr_detection(char *str);
+unsigned int keyword_slot(const char *name, size_t length);
 
 /**
- * @brief Detects if a given string is a valid opcode.
- *
- * This function checks whether the input string matches any of the known opcodes 
- * by comparing it against a predefined list of opcodes. 
+ * @brief Classifies a name as an opcode, an instruction, a register or none of them.
  *
- * @param str The input string to be checked for validity as an opcode.
+ * The reserved words are kept in a perfect hash table, so the name is compared with one reserved word at most.
  *
- * @return 1 if the string matches a known opcode, 0 otherwise.
+ * @param name The name to look for, it does not have to end with '\0'.
+ * @param length The number of characters in the name.
+ * @param index Receives the index of the opcode or the instruction, or the number of the register.
  *
- * @note This function uses the global array `OPCODES` which holds the list of known opcodes
- *       and the constant `OPCODES_COUNT` that represents the number of opcodes in the list.
- *       Each element in `OPCODES` is expected to be a struct with a member `name_of_opcode`
- *       that stores the name of the opcode.
+ * @return The kind of the reserved word, or KEYWORD_NONE if the name is not reserved.
  */
-int opcode_detection(char *str);
+keyword_kind find_keyword(const char *name, size_t length, int *index);
 
 /**
- * @brief Detects if a given string is a valid register and returns its number.
+ * @brief Finds the instruction with a given name.
  *
- * This function checks whether the input string matches any of the known registers
- * by comparing it against a predefined list of registers. It returns the number
- * of the register if found, otherwise, it returns 0.
+ * This function looks the name up with `find_keyword`.
  *
- * @param str The input string to be checked for validity as a register.
+ * @param name The name to look for, it does not have to end with '\0'.
+ * @param length The number of characters in the name.
  *
- * @return The number of the register if the string matches a known register,
- *         0 otherwise.
+ * @return The index of the instruction in the list (e.g., DATA_INSTRUCTION), or -1 if there is none.
  */
-int reg_detection(char *str);
+int find_instruction(const char *name, size_t length);
 
 /**
- * @brief Detects if there are extra characters in a string beyond the first token.
+ * @brief Finds the opcode with a given name.
  *
- * This function checks whether there are any additional tokens (i.e., extra characters) 
- * in the input string after the first token. It tokenizes the string based on spaces and 
- * determines if there is more than one token.
+ * This function looks the name up with `find_keyword`.
  *
- * @param str The input string to be checked for extra characters.
+ * @param name The name to look for, it does not have to end with '\0'.
+ * @param length The number of characters in the name.
  *
- * @return 1 if extra characters are found beyond the first token, 0 otherwise.
- *
- * @note This function allocates memory for a copy of the input string to avoid modifying
- *       the original string. The copy is tokenized using `strtok` to split the string by spaces.
- *       After checking for extra tokens, the allocated memory is freed.
+ * @return The index of the opcode in the `OPCODES` list, or -1 if there is none.
  */
-int extra_char_detection(char *str);
+int find_opcode(const char *name, size_t length);
 
 /**
- * @brief Checks if the given string ends with a colon.
+ * @brief Finds the register with a given name.
  *
- * This function determines whether the provided string ends with a colon (':').
- * It is useful for identifying labels in a line of code where labels are typically
- * denoted by a trailing colon.
+ * This function looks the name up with `find_keyword`.
  *
- * @param str The string to be checked.
+ * @param name The name to look for, it does not have to end with '\0'.
+ * @param length The number of characters in the name.
  *
- * @return `true` if the string ends with a colon, `false` otherwise.
+ * @return The number of the register, or -1 if there is none.
  */
-bool endsWithColon(const char *str);
+int find_register(const char *name, size_t length);
 
 /**
- * @brief Checks if the given string is alphanumeric.
+ * @brief Checks if the given slice of a string is alphanumeric.
  *
- * This function determines whether every character in the provided string is either
+ * This function determines whether every character in the provided slice is either
  * a letter or a digit. It is useful for validating identifiers or labels that should
  * consist solely of alphanumeric characters.
  *
- * @param str The string to be checked.
- *
- * @return `true` if all characters in the string are alphanumeric, `false` otherwise.
- */
-bool is_alphanumeric_string(const char* str);
-
-/**
- * @brief Checks if the given string represents an instruction.
- *
- * This function determines if the provided string begins with a period ('.'),
- * which is used to denote instructions or directives in certain assembly languages.
+ * @param str The first character of the slice.
+ * @param length The number of characters in the slice.
  *
- * @param str The string to be checked.
- *
- * @return `1` if the string starts with a period ('.'), indicating it is an instruction;
- *         `0` otherwise.
+ * @return `true` if all characters in the slice are alphanumeric, `false` otherwise.
  */
-int is_instruction(char * str);
-
+bool is_alphanumeric_slice(const char* str, size_t length);
 
 /**
  * @brief Validates and processes a string for insertion into the data image.
@@ -237,75 +264,83 @@ int is_instruction(char * str);
  * 4. Updates the data counter (`DC`) accordingly.
  * 5. If the string does not start and end with quotes, it prints an error message indicating the line number.
  *
- * @param rest_of_line The string to be validated and processed.
+ * @param rest_of_line The string to be validated and processed, it does not have to end with '\0'.
+ * @param length The number of characters in the string.
  * @param DC Pointer to the data counter that tracks the current position in the data image.
  * @param line The line number where the string was found, used for error reporting.
- * @param data_image_head Pointer to the head of the data image linked list where the string will be added.
+ * @param data The data image where the string will be added.
  */
-void check_valid_string(char *rest_of_line,int * DC,int line,data_image **data_image_head);
+void check_valid_string(const char *rest_of_line,size_t length,int * DC,int line,memory_image *data);
 
 /**
  * @brief Validates and processes data from a string for insertion into the data image.
  *
  * This function performs the following steps:
- * 1. Checks if the string format is valid by verifying comma separation.
- * 2. Creates a copy of the input string to avoid modifying the original.
- * 3. Tokenizes the string using commas as delimiters.
- * 4. For each token:
- *    - Checks if it represents a valid integer.
+ * 1. Checks if the data format is valid by verifying comma separation.
+ * 2. For each operand token:
+ *    - Checks if it is a number.
  *    - Adds the integer value to the data image.
  *    - Updates the data counter (`DC`).
- * 5. If any token is not a valid integer, prints an error message with the line number.
- * 6. If the data format is invalid, prints an error message with the line number.
+ * 3. If any token is not a number, prints an error message with the line number.
+ * 4. If the data format is invalid, prints an error message with the line number.
+ * 5. If a number does not fit in a data word (DATA_MIN to DATA_MAX), prints an error message and stops.
  *
- * @param rest_of_line The string containing the data to be validated and processed.
+ * @param tokens The tokens of the line, with the data to be validated and processed.
  * @param DC Pointer to the data counter that tracks the current position in the data image.
  * @param line The line number where the data was found, used for error reporting.
- * @param data_image_head Pointer to the head of the data image linked list where the data will be added.
+ * @param data The data image where the data will be added.
+ * @return 0 if a number does not fit in a data word, 1 otherwise.
  */
-void check_valid_data(char *rest_of_line, int * DC,int line,data_image **data_image_head);
+int check_valid_data(line_tokens *tokens, int * DC,int line,memory_image *data);
 
 /**
- * @brief Updates the address of labels of type ".data" by adding the instruction counter (IC) value.
+ * @brief Initializes an empty fixup list.
  *
- * This function iterates through the linked list of labels and performs the following steps:
- * 1. Checks if the label's type is ".data".
- * 2. If the label type is ".data", it updates the `address_of_label` by adding the current value of the instruction counter (IC).
- * 3. Continues to the next label in the list until all labels have been processed.
+ * The fixups, the .entry requests and their names are kept in an arena, they are released when the arena is reset.
  *
- * @param label_head Pointer to the head of the linked list of labels.
- * @param IC The current value of the instruction counter to be added to the address of labels of type ".data".
+ * @param fixups The fixup list to initialize.
+ * @param memory The arena of the file.
  */
-void update_data_label(label *label_head,int IC);
+void init_fixup_list(fixup_list *fixups, arena *memory);
 
 /**
- * @brief Checks the validity of the data format in the string, ensuring proper comma usage.
+ * @brief Records the operands of a line that may be labels, to be resolved after the first pass.
  *
- * This function performs the following checks on the input string:
- * 1. Ensures the string does not start with a comma.
- * 2. Ensures that no two consecutive commas exist.
- * 3. Ensures that the string does not end with a comma.
+ * An operand that is a label reference or a number gets a fixup with a copy of its name and the line number,
+ * in the order of the operands, so the second pass does not have to read the line again.
+ * Each label reference takes the next unresolved word of the instruction as its slot, so its address
+ * is later written there directly.
  *
- * @param rest_of_line The string to be checked for valid comma usage in a data format.
- * 
- * @return 1 if the format is valid, 0 otherwise.
+ * @param fixups The fixup list.
+ * @param tokens The tokens of the line.
+ * @param line The line number.
+ * @param code The instruction image.
+ * @param address The address of the first word of the instruction of the line, or IC if it has none.
+ */
+void add_operand_fixups(fixup_list *fixups, line_tokens *tokens, int line, memory_image *code, int address);
+
+/**
+ * @brief Records the label of an .entry line, to be written to the ".ent" file after the first pass.
+ *
+ * @param fixups The fixup list.
+ * @param name The name of the label, it does not have to end with '\0'. It is copied.
+ * @param length The number of characters in the name.
+ * @param line The number of the .entry line.
  */
-int check_valid_data_comma(char *rest_of_line);
+void add_entry_request(fixup_list *fixups, const char *name, size_t length, int line);
 
 /**
- * @brief Checks if the given string represents a valid integer.
+ * @brief Updates the address of the data labels by adding the instruction counter (IC) value.
  *
- * This function performs the following checks:
- * 1. Handles empty strings or strings with only non-digit characters.
- * 2. Skips optional leading '+' or '-' signs.
- * 3. Ensures that there are digits left after any optional sign.
- * 4. Checks if the remaining string is composed only of digits.
+ * This function iterates through the labels in the order of definition and performs the following steps:
+ * 1. Checks if the label's kind is SYMBOL_DATA.
+ * 2. If it is, it updates the `address_of_label` by adding the current value of the instruction counter (IC).
+ * 3. Continues to the next label until all labels have been processed.
  *
- * @param rest_of_line The string to be checked for integer validity.
- * 
- * @return 1 if the string is a valid integer, 0 otherwise.
+ * @param symbols The symbol table.
+ * @param IC The current value of the instruction counter to be added to the address of the data labels.
  */
-int is_valid_integer(char *token);
+void update_data_label(symbol_table *symbols,int IC);
 
 /**
  * @brief Checks if the given string starts and ends with a double quote.
@@ -314,11 +349,12 @@ int is_valid_integer(char *token);
  * 1. The string is not empty.
  * 2. The first and last characters of the string are double quotes (").
  *
- * @param rest_of_line The string to be checked.
+ * @param rest_of_line The string to be checked, it does not have to end with '\0'.
+ * @param length The number of characters in the string.
  * 
  * @return 1 if the string starts and ends with a double quote, 0 otherwise.
  */
-int starts_and_ends_with_quote(char *rest_of_line);
+int starts_and_ends_with_quote(const char *rest_of_line, size_t length);
 
 /**
  * @brief Trims leading and trailing whitespace characters from a string.
@@ -333,112 +369,124 @@ int starts_and_ends_with_quote(char *rest_of_line);
 char *trim_whitespace(char *str);
 
 /**
- * @brief Checks if a line is empty or contains only whitespace characters.
+ * @brief Initializes an empty memory image.
  *
- * This function trims leading and trailing whitespace characters from the given line
- * and checks if the resulting string is empty. A line is considered empty if it contains
- * only whitespace characters or is completely blank.
+ * The words are kept in an arena, they are released when the arena is reset.
  *
- * @param line The line to be checked.
- * 
- * @return 1 if the line is empty or contains only whitespace characters, 0 otherwise.
+ * @param image The image to initialize.
+ * @param base The address of the first word of the image, IC_INIT_VALUE for the code and 0 for the data.
+ * @param memory The arena of the file.
+ * @param site ALLOC_INSTRUCTION_WORDS or ALLOC_DATA_WORDS, what the words are counted as by the allocation profiler.
  */
-int is_empty_line(char *line);
+void init_memory_image(memory_image *image, int base, arena *memory, int site);
 
 /**
- * @brief Finds a label by its name in the linked list of labels.
+ * @brief Stores a word in a memory image at a given address.
  *
- * This function traverses the linked list of labels to search for a label with the
- * specified name. It returns a pointer to the label if found, or NULL if the label
- * is not present in the list.
+ * The word is kept at the index address - base of the image, and its line number at the same index
+ * of the parallel array of lines. The arrays are doubled when the address is past their end, so
+ * adding the words one after the other takes amortized constant time.
  *
- * @param name_of_label The name of the label to search for.
- * @param label_head The head of the linked list of labels.
- * 
- * @return A pointer to the label if found, NULL otherwise.
+ * @param image The memory image.
+ * @param address The address of the word, it cannot be below the base of the image.
+ * @param word The value of the word, or UNRESOLVED_WORD if it is not known yet.
+ * @param line The line number in the source code where the word originates.
  */
-label* find_label_by_name(const char *name_of_label, label* label_head);
+void store_word(memory_image *image, int address, int word, int line);
 
 /**
- * @brief Updates the type of a label.
+ * @brief Adds a data word to the data image.
  *
- * This function updates the type of a given label by freeing the existing type string
- * and assigning a new type string to the label. The new type string is duplicated using
- * the `duplicate` function.
+ * This function keeps the lowest 15 bits of an integer value, in two's complement, and
+ * stores them in the data image along with its line number.
  *
- * @param lbl A pointer to the label whose type is to be updated.
- * @param new_type The new type string to be assigned to the label.
+ * @param value The integer value to be added to the data image.
+ * @param address The address to be associated with the value.
+ * @param data The data image where the data will be stored.
+ * @param line The line number in the source code where the data originates.
  */
-void update_label_type(label *lbl, const char *new_type);
+void add_to_data_image(int value,int address, memory_image *data,int line);
 
 /**
- * @brief Creates an entry file with the specified label information.
+ * @brief Checks if a given label name is valid.
  *
- * This function searches for a label by its name in the given linked list of labels.
- * If the label is found, it creates a new file with the specified filename and writes
- * the label's name and address to the file. If the label is not found, an error message
- * is printed. If the file cannot be opened, an error message is printed using `perror`.
+ * This function checks if the given `name_of_label` is valid by ensuring it
+ * is not an instruction, opcode, or register, starts with an alphabetic character, and is composed 
+ * only of alphanumeric characters.
  *
- * @param filename The name of the file to be created.
- * @param rest_of_line The name of the label to search for in the label list.
- * @param label_head A pointer to the head of the linked list of labels.
+ * @param name_of_label The label name to be validated, it does not have to end with '\0'.
+ * @param length The number of characters in the name.
+ * @return int 1 if the label is valid, 0 otherwise.
  */
-void create_entry_file(const char *filename, const char *content, label* label_head);
+int is_valid_label(const char *name_of_label, size_t length);
 
 /**
- * @brief Adds a new data image node to the linked list.
+ * @brief Initializes an empty symbol table.
  *
- * This function converts an integer value to its binary representation,
- * stores the binary string along with the address and line number in a new
- * node, and adds this node to the end of the linked list pointed to by
- * `data_image_head`.
+ * The slots, the labels and the pool of their names are kept in an arena, they are released when the arena is reset.
  *
- * @param value The integer value to be added to the data image list.
- * @param address The address to be associated with the value.
- * @param data_image_head A pointer to the head of the linked list where the data will be stored.
- * @param line The line number in the source code where the data originates.
+ * @param symbols The symbol table to initialize.
+ * @param memory The arena of the file.
  */
-void add_to_data_image(int value,int address, data_image** data_image_head,int line);
+void init_symbol_table(symbol_table *symbols, arena *memory);
 
 /**
- * @brief Checks if a given label name is valid.
+ * @brief Puts a label in the first free slot after the slot of its hash.
  *
- * This function checks if the given `name_of_label` is valid by ensuring it does not conflict 
- * with any macro names stored in a linked list, is not an instruction, opcode, or register, 
- * does not contain extra characters, starts with an alphabetic character, and is composed 
- * only of alphanumeric characters.
+ * @param symbols The symbol table, it must have a free slot.
+ * @param index The index of the label in the labels of the table.
+ */
+void insert_label_slot(symbol_table *symbols, int index);
+
+/**
+ * @brief Copies a name to the end of the name pool of a symbol table.
  *
- * @param name_of_label The label name to be validated.
- * @return int 1 if the label is valid, 0 otherwise.
+ * The pool is doubled when it is full. The names are found by their offsets, which do not change when it grows.
+ *
+ * @param symbols The symbol table.
+ * @param name The name to copy, it does not have to end with '\0'.
+ * @param length The number of characters in the name.
+ * @return The offset of the copy in the pool, it ends with '\0'.
  */
-int is_valid_label(char *name_of_label);
+size_t add_to_name_pool(symbol_table *symbols, const char *name, size_t length);
 
 /**
- * @brief Adds a new label to the linked list of labels.
+ * @brief Returns the name of a label.
  *
- * This function allocates memory for a new label, sets its name, address, and type, 
- * and adds it to the end of the linked list of labels.
+ * @param symbols The symbol table of the label.
+ * @param lbl The label.
+ * @return The name of the label in the name pool of the table, ending with '\0'.
+ */
+const char *label_name(symbol_table *symbols, label *lbl);
+
+/**
+ * @brief Adds a new label to the symbol table.
  *
- * @param name_of_label The name of the label to be added.
+ * This function adds a label after the labels of the table, sets its address and kind,
+ * and copies its name to the name pool of the table.
+ * The table is doubled when it becomes more than half full, which moves the labels.
+ *
+ * @param symbols The symbol table.
+ * @param name_of_label The name of the label to be added, it is copied and does not have to end with '\0'.
+ * @param length The number of characters in the name.
  * @param address_of_label A pointer to the address of the label. If NULL, the address is set to 0.
- * @param head A pointer to the pointer to the head of the linked list.
- * @param type_of_label The type of the label (e.g., data, code).
+ * @param kind The kind of the label.
  */
-void add_label_to_list(char *name_of_label, int *address_of_label, label **head,char *type_of_label);
+void add_label(symbol_table *symbols, const char *name_of_label, size_t length, int *address_of_label, symbol_kind kind);
 
 /**
- * @brief Searches for a label in a linked list by its name.
+ * @brief Searches for a label in the symbol table by its name.
  *
- * This function traverses a linked list of labels, searching for a label with a specific name.
- * If the label is found, it sets the `found` flag to 1, prints a message indicating the label is already defined, 
- * and returns a pointer to the label. If the label is not found, it sets the `found` flag to 0 and returns NULL.
+ * The name is hashed once and the table is probed from the slot of the hash until an empty slot,
+ * so the search takes constant time regardless of the number of labels. The names in the pool are
+ * compared only with the labels of the same hash and length.
  *
- * @param head Pointer to the head of the linked list of labels.
- * @param name_of_label The name of the label to search for.
- * @param found Pointer to an integer that will be set to 1 if the label is found, otherwise 0.
- * @return A pointer to the label if found, or NULL if not found.
+ * @param symbols The symbol table.
+ * @param name_of_label The name of the label to search for, it does not have to end with '\0'.
+ * @param length The number of characters in the name.
+ * @return A pointer to the label if found, or NULL if not found. It is valid until the next label is added.
  */
-label* search_label_on_list(label *head, char *name_of_label, int *found);
+label* search_label(symbol_table *symbols, const char *name_of_label, size_t length);
 
 /**
  * @brief Saves information about a line of code in a linked list.
@@ -466,94 +514,54 @@ void save_data_line(char* name_of_file,short num_of_line,char* content_of_line,l
  */
 char* duplicate(const char* str);
 
-/**
- * @brief Frees the memory allocated for a linked list of labels.
- *
- * This function iterates through a linked list of labels and frees the memory 
- * allocated for each label's name, type, and the label struct itself.
- *
- * @param head A pointer to the head of the linked list of labels.
- */
-void free_label_list(label *head);
-
-/**
- * @brief Converts a comma-separated string of numbers into a binary string.
- *
- * This function takes a string of comma-separated numbers, converts each number
- * to its binary representation, and concatenates them into a single binary string.
- * It also appends the specified ARE (Addressing, Relocatability, Extern) value at the end.
- *
- * @param length The length of the binary representation for each number.
- * @param str A string containing the comma-separated numbers to be converted.
- * @param ARE A string representing the ARE value to be appended to the binary string.
- */
-void convert_str_to_binary(int length,char *str, char *ARE);
-
 /**
  * @brief Validates the number of arguments in a given string against the expected number of arguments for an opcode.
  *
- * This function checks if the number of arguments in the `rest_of_line` string matches the expected number
- * for the opcode specified in `str`. It counts the number of arguments by checking for commas, 
- * and then compares this count with the expected argument count for the opcode.
+ * This function checks that the operands of the line are separated by single commas and that
+ * their number matches the expected number for the opcode of the line.
  *
- * @param str The string containing the opcode name.
- * @param rest_of_line The string containing the rest of the line, which includes the arguments.
+ * @param tokens The tokens of the line, the opcode and its operands.
  * @param num_of_opcode A pointer to an integer that will hold the opcode number if a match is found.
+ * @param line The number of the line, for the errors it reports.
  * @return 1 if the number of arguments matches the expected number for the opcode, 0 otherwise.
  */
-int valid_num_argument(char * str ,char * rest_of_line,int * num_of_opcode);
+int valid_num_argument(line_tokens *tokens,int * num_of_opcode, int line);
 
 /**
- * @brief Parses the opcode arguments and converts them to binary representations.
+ * @brief Parses the opcode arguments and encodes the words of the instruction.
  *
- * This function processes the arguments of an opcode, determines their types and sizes, and generates binary strings for the first, second, and third words based on the detected argument types.
+ * This function processes the arguments of an opcode, determines their addressing methods, and encodes the first word
+ * and the words of the operands. The word of a label operand is left unresolved until the second pass.
  *
- * @param name_of_opcode The name of the opcode to validate.
- * @param arguments The arguments string associated with the opcode.
- * @param first_word_to_binary The buffer to store the binary representation of the first word.
- * @param second_word_to_binary The buffer to store the binary representation of the second word.
- * @param third_word_to_binary The buffer to store the binary representation of the third word.
- * @param fieldBitSize1 Pointer to an integer to store the bit size of the first field.
- * @param fieldBitSize2 Pointer to an integer to store the bit size of the second field.
- * @param fieldBitSize3 Pointer to an integer to store the bit size of the third field.
+ * @param tokens The tokens of the line, the opcode and its operands, after `valid_num_argument` accepted them.
+ * @param words The array that receives the words, with room for MAX_INSTRUCTION_WORDS words.
+ * @param word_count Pointer to an integer that receives the number of words.
  * @param detected_label_on_first_pass Pointer to an integer to track detected labels.
+ * @param line The number of the line, for the errors it reports.
  * @return Returns 1 if parsing and validation are successful, otherwise returns 0.
  */
-int parsing_arg(char *name_of_opcode, char *arguments,char *first_word_to_binary,char *second_word_to_binary,char *third_word_to_binary,int * fieldBitSize1,int * fieldBitSize2,int * fieldBitSize3, int *detected_label_on_first_pass);
+int parsing_arg(line_tokens *tokens,int *words,int *word_count, int *detected_label_on_first_pass, int line);
 
 /**
- * @brief Detects and converts an argument to its corresponding integer value or register number.
- *
- * This function analyzes the provided `argument` string to determine if it represents a valid integer or
- * a register. It then returns the appropriate value based on the type of the argument.
+ * @brief Encodes the word of a single operand.
  *
- * - If the argument is a valid integer, the function converts it to an integer and returns it.
- * - If the argument is identified as a register, the function returns the register number (adjusted by subtracting 1).
- * - If the argument is neither a valid integer nor a recognized register, the function returns -1.
- *
- * @param argument A string representing the argument to be detected and converted.
- * @return The integer value of the argument if it is a valid integer or register number (adjusted), or -1 if invalid.
+ * @param addressing_mode The addressing method of the operand.
+ * @param value The number, or the number of the register, of the operand.
+ * @param register_shift The place of a register in the word: SOURCE_REGISTER_SHIFT or TARGET_REGISTER_SHIFT.
+ * @return The 15-bit word, or UNRESOLVED_WORD for a label.
  */
-int detection_argument(char *argument);
+int encode_argument_word(int addressing_mode, int value, int register_shift);
 
 /**
- * @brief Identifies the addressing modes of source and target arguments.
- *
- * This function determines the addressing modes for source and target arguments based on their initial characters
- * and updates the corresponding type of addressing modes. It also checks if the arguments could be labels if 
- * the initial determination is inconclusive.
+ * @brief Identifies the addressing mode of an argument.
  *
- * - The function iterates through predefined types of addressing methods to identify the type of each argument based
- *   on its first character.
- * - If the argument's initial character does not match any predefined type, it checks if the argument could be a label.
+ * The lexer already sorted the argument by its first character, '#' for an immediate, '*' for an indirect register
+ * and 'r' for a register. Any other argument is checked to be a valid label.
  *
- * @param source_arg A string representing the source argument.
- * @param target_arg A string representing the target argument.
- * @param type_of_source_arg A pointer to an integer where the type of the source argument's addressing mode will be stored.
- * @param type_of_target_arg A pointer to an integer where the type of the target argument's addressing mode will be stored.
- * @param head A pointer to the head of the linked list of labels used for label validation.
+ * @param argument The token of the argument.
+ * @return The addressing mode of the argument, or -3 if it is not valid.
  */
-void identifyAddressingMode(char *target_arg,char *source_arg,int *type_of_target_arg,int *type_of_source_arg);
+int identifyAddressingMode(token *argument);
 
 /**
  * @brief Validates the opcode and its associated addressing modes.
@@ -562,66 +570,24 @@ void identifyAddressingMode(char *target_arg,char *source_arg,int *type_of_targe
  * It compares the provided opcode with a list of valid opcodes and ensures that the source and target
  * addressing modes match the expected types for the given opcode.
  *
- * @param name_of_opcode The name of the opcode to be validated.
+ * @param opcode The index of the opcode in the `OPCODES` list.
  * @param num_of_opcode A pointer to an integer where the number associated with the opcode will be stored if valid.
  * @param type_of_target_arg The addressing mode type of the target argument.
  * @param type_of_source_arg The addressing mode type of the source argument.
  *
  * @return Returns 1 if the opcode is valid and the addressing modes match; otherwise, returns 0.
  */
-int validateParameters(char *name_of_opcode,int *num_of_opcode,int type_of_target_arg,int type_of_source_arg);
+int validateParameters(int opcode,int *num_of_opcode,int type_of_target_arg,int type_of_source_arg);
 
 /**
- * @brief Adds a new instruction to the instruction memory list.
+ * @brief Adds a new instruction word to the instruction image.
  *
- * This function creates a new node for the instruction memory list with the provided line number, address,
- * and binary string representation of the instruction. It then adds this new node to the end of the instruction memory list.
+ * This function stores the encoded instruction word in the instruction image
+ * at its address, along with its line number.
  *
  * @param line The line number where the instruction is located.
  * @param address The address of the instruction in memory.
- * @param binary_str A string representing the binary encoding of the instruction.
- * @param instruction_memory_head A pointer to the head of the instruction memory list. This will be updated if the list is empty.
- */
-void add_to_instruction_memory(int line,int address,char* binary_str , instruction_memory** instruction_memory_head);
-
-/**
- * @brief Frees all nodes in the instruction memory list.
- *
- * This function iterates through the entire instruction memory list, freeing memory allocated for each node's
- * binary string and then freeing the node itself. The process continues until all nodes in the list are freed.
- *
- * @param head A pointer to the head of the instruction memory list.
+ * @param word The encoded instruction word, or UNRESOLVED_WORD for the address of a label.
+ * @param code The instruction image.
  */
-void free_instruction_memory(instruction_memory *head);
-
-/**
- * @brief Converts the first number in a comma-separated string to binary and appends it with the remaining numbers.
- *
- * This function takes a comma-separated string of numbers and converts each number to its binary representation. 
- * The first number is treated as a special case where its binary representation is converted using `decimal_to_binary`.
- * Subsequent numbers are converted using `convert_to_binary`. All binary representations are concatenated and appended 
- * with the value of `ARE`. The final binary string is then copied back into the original string `str`.
- *
- * @param length The length of the binary representation for each number.
- * @param str A comma-separated string of numbers. The string is modified to contain the final binary representation.
- */
-
-/**
- * @brief Converts the first number in a comma-separated string to binary and appends it with the remaining numbers.
- *
- * This function takes a comma-separated string of numbers and converts each number to its binary representation. 
- * The first number is treated as a special case where its binary representation is converted using `decimal_to_binary`.
- * Subsequent numbers are converted using `convert_to_binary`. All binary representations are concatenated and appended 
- * with the value of `ARE`. The final binary string is then copied back into the original string `str`.
- *
- * @param length The length of the binary representation for each number.
- * @param str A comma-separated string of numbers. The string is modified to contain the final binary representation.
- * @param ARE A string to be appended at the end of the final binary representation.
- */
-void convert_first_word_to_binary(int length, char* str, char* ARE);
-
-void print_memory(instruction_memory *instruction_head, data_image *data_head, int IC, int DC, FILE *fp);
-
-
-void copyAndConvertFile(char *sourceFile, char *destinationFile);
-unsigned int binaryToOctal(const char *binary);
\ No newline at end of file
+void add_to_instruction_memory(int line,int address,int word , memory_image *code);
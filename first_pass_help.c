@@ -5,23 +5,22 @@
 #include "globals.h"
 #include "first_pass.h"
 #include "pre_assembler.h"
+#include "lexer.h"
+#include "arena.h"
+#include "report.h"
 
-int label_process(char* first_word, int* p_address, label** label_head,char *type_of_label) {
-	size_t len = strlen(first_word);
-	int found;
-	if (len > 0 && first_word[len - 1] == ':') {
-		first_word[len - 1] = '\0';  /* Remove the column */
-	}
-	if (len > MAX_LABEL_LENGTH) {
-		printf("The label is too long\n");
+int label_process(const char* name, size_t length, int* p_address, symbol_table* symbols, symbol_kind kind, int line) {
+	if (length > MAX_LABEL_LENGTH) {
+		report_at(line, "The label is too long\n");
 		return 0;
 	}
+	if (length > 0 && name[length - 1] == ':') {
+		length--;  /* Remove the column */
+	}
 
-	search_label_on_list(*label_head, first_word, &found);
-
-	if (!found) {
-		if (is_valid_label(first_word)) {
-			add_label_to_list(first_word, p_address, label_head,type_of_label);
+	if (search_label(symbols, name, length) == NULL) {
+		if (is_valid_label(name, length)) {
+			add_label(symbols, name, length, p_address, kind);
 			return 1;
 		}
 	}
@@ -31,20 +30,88 @@ int label_process(char* first_word, int* p_address, label** label_head,char *typ
 
 char* duplicate(const char* str)
 {
-	char* new_str = (char*)handle_malloc((strlen(str) + 1) * sizeof(char));
+	char* new_str = (char*)handle_malloc((strlen(str) + 1) * sizeof(char), ALLOC_FILE_NAMES);
 	strcpy(new_str, str);
 	return new_str;
 }
 
-/* Function to add a new label to the list */
-void add_label_to_list(char* name_of_label, int* address_of_label, label** head,char *type_of_label) {
-	label* new_label = (label*)handle_malloc(sizeof(label));
-	if (new_label == NULL) {
-		perror("Failed to allocate memory for new label");
-		exit(EXIT_FAILURE);
+void init_symbol_table(symbol_table* symbols, arena* memory) {
+	int i;
+	symbols->capacity = SYMBOL_TABLE_INIT_SIZE;
+	symbols->count = 0;
+	symbols->memory = memory;
+	symbols->slots = arena_alloc(memory, symbols->capacity * sizeof(int), ALLOC_LABELS);
+	for (i = 0; i < symbols->capacity; i++) {
+		symbols->slots[i] = EMPTY_SLOT;
+	}
+	/* the table is at most half full, so the labels need half as many places as the slots */
+	symbols->labels = arena_alloc(memory, (symbols->capacity / 2) * sizeof(label), ALLOC_LABELS);
+	symbols->names = arena_alloc(memory, NAME_POOL_INIT_SIZE, ALLOC_LABELS);
+	symbols->names_length = 0;
+	symbols->names_capacity = NAME_POOL_INIT_SIZE;
+}
+
+void insert_label_slot(symbol_table* symbols, int index) {
+	int mask = symbols->capacity - 1;
+	int i = (int)(symbols->labels[index].hash & mask);
+	while (symbols->slots[i] != EMPTY_SLOT) {
+		i = (i + 1) & mask;
 	}
+	symbols->slots[i] = index;
+}
+
+size_t add_to_name_pool(symbol_table* symbols, const char* name, size_t length) {
+	size_t offset = symbols->names_length;
+	size_t new_capacity;
+	char* names;
 
-	new_label->name_of_label = duplicate(name_of_label);  /* Copy the string */
+	/* the pool is doubled when it is full, the offsets of the names in it do not change */
+	if (offset + length + 1 > symbols->names_capacity) {
+		new_capacity = symbols->names_capacity;
+		while (offset + length + 1 > new_capacity) {
+			new_capacity *= 2;
+		}
+		names = arena_alloc(symbols->memory, new_capacity, ALLOC_LABELS);
+		memcpy(names, symbols->names, offset);
+		symbols->names = names;
+		symbols->names_capacity = new_capacity;
+	}
+	memcpy(symbols->names + offset, name, length);
+	symbols->names[offset + length] = '\0';
+	symbols->names_length += length + 1;
+	return offset;
+}
+
+const char* label_name(symbol_table* symbols, label* lbl) {
+	return symbols->names + lbl->name_offset;
+}
+
+/* Function to add a new label to the table */
+void add_label(symbol_table* symbols, const char* name_of_label, size_t length, int* address_of_label, symbol_kind kind) {
+	label* old_labels;
+	int i;
+	label* new_label;
+
+	/* keep the table at most half full */
+	if ((symbols->count + 1) * 2 > symbols->capacity) {
+		old_labels = symbols->labels;
+		symbols->capacity *= 2;
+		/* the old slots and labels stay in the arena until the file is done */
+		symbols->slots = arena_alloc(symbols->memory, symbols->capacity * sizeof(int), ALLOC_LABELS);
+		symbols->labels = arena_alloc(symbols->memory, (symbols->capacity / 2) * sizeof(label), ALLOC_LABELS);
+		memcpy(symbols->labels, old_labels, symbols->count * sizeof(label));
+		for (i = 0; i < symbols->capacity; i++) {
+			symbols->slots[i] = EMPTY_SLOT;
+		}
+		for (i = 0; i < symbols->count; i++) {
+			insert_label_slot(symbols, i);
+		}
+	}
+
+	new_label = &symbols->labels[symbols->count];
+	new_label->hash = hash_name(name_of_label, length);
+	new_label->name_offset = add_to_name_pool(symbols, name_of_label, length);  /* Copy the name */
+	new_label->name_length = length;
 	if (address_of_label != NULL)
 	{
 		new_label->address_of_label = *address_of_label;
@@ -53,487 +120,267 @@ void add_label_to_list(char* name_of_label, int* address_of_label, label** head,
 	{
 		new_label->address_of_label = 0;
 	}
-	new_label->type_of_label = NULL;  /* Initialize or set appropriately */
-	new_label->next = NULL;
-	update_label_type(new_label,type_of_label);
-
-	if (*head == NULL) {
-		*head = new_label;
-	}
-	else {
-		label* current = *head;
-		while (current->next != NULL) {
-			current = current->next;
-		}
-		current->next = new_label;
-	}
-
+	new_label->kind = kind;
+	insert_label_slot(symbols, symbols->count);
+	symbols->count++;
 }
 
 
-/* Function to search for a label in the list */
-label* search_label_on_list(label* head, char* name_of_label, int* found) {
-	label* current = head;
-	*found = 0;
+/* Function to search for a label in the table */
+label* search_label(symbol_table* symbols, const char* name_of_label, size_t length) {
+	unsigned long hash = hash_name(name_of_label, length);
+	int mask = symbols->capacity - 1;
+	int i = (int)(hash & mask);
+	label* current;
 
-	while (current != NULL) {
-		if (strcmp(name_of_label, current->name_of_label) == 0) {
-			*found = 1;
+	/* linear probing until an empty slot, the names are compared only when the hashes and the lengths are equal */
+	while (symbols->slots[i] != EMPTY_SLOT) {
+		current = &symbols->labels[symbols->slots[i]];
+		if (current->hash == hash && current->name_length == length &&
+			memcmp(symbols->names + current->name_offset, name_of_label, length) == 0) {
 			return current;
 		}
-		current = current->next;
+		i = (i + 1) & mask;
 	}
-
 	return NULL;
 }
 
 /* Function to check if a label is valid */
-int is_valid_label(char* name_of_label) {
-	return (!instr_detection(name_of_label) &&
-		!opcode_detection(name_of_label) &&
-		!reg_detection(name_of_label) &&
-		!extra_char_detection(name_of_label) &&
-		isalpha(*name_of_label))&&
-		is_alphanumeric_string(name_of_label);
+int is_valid_label(const char* name_of_label, size_t length) {
+	int index;
+	return (length > 0 &&
+		find_keyword(name_of_label, length, &index) == KEYWORD_NONE &&
+		isalpha((unsigned char)*name_of_label)) &&
+		is_alphanumeric_slice(name_of_label, length);
 }
 
 
-int instruction_data_process(char *str,char* first_word, char* rest_of_line, int* DC, int line, data_image** data_image_head) {
-	if (!instr_data_detection(str,first_word, rest_of_line, DC, line, data_image_head)) {
-		printf("undefinde instruchion in line: %d\n",line);
+int instruction_data_process(line_tokens* tokens, int* DC, int line, memory_image* data) {
+	int fits = 1;
+
+	if (!instr_data_detection(tokens, DC, line, data, &fits)) {
+		report_at(line, "undefinde instruchion in line: %d\n",line);
 		return 0;
 	}
-	return 1;
+	return fits;
 }
 
-void check_valid_data(char* rest_of_line, int* DC, int line, data_image** data_image_head) {
-	char* token;
+int check_valid_data(line_tokens* tokens, int* DC, int line, memory_image* data) {
+	int i;
 	
-	if (check_valid_data_comma(rest_of_line)) {
-
-		char rest_of_line_copy[MAX_LINE_LENGTH];
-		strncpy(rest_of_line_copy, rest_of_line, MAX_LINE_LENGTH);
-		token = strtok(rest_of_line_copy, ",");
-		while (token != NULL) {
-			if (is_valid_integer(token)) {
-				
-				add_to_data_image(atoi(token),*DC, data_image_head,line);
+	if (check_operand_commas(tokens)) {
+		/* the numbers and the commas take turns */
+		for (i = tokens->statement + 1; i < tokens->count; i += 2) {
+			if (tokens->tokens[i].kind == TOKEN_NUMBER) {
+				/* a number is not cut to the bits of its word */
+				if (tokens->tokens[i].value < DATA_MIN || tokens->tokens[i].value > DATA_MAX) {
+					report_at(line, "The number %.*s does not fit in a data word\n", (int)tokens->tokens[i].length, tokens->tokens[i].start);
+					return 0;
+				}
+				add_to_data_image(tokens->tokens[i].value,*DC, data,line);
 				(*DC)++;
 			}
 			else {
 				
-				printf("One or more numbers are invalid");
+				report_at(line, "One or more numbers are invalid");
 				break;
 			}
-			token = strtok(NULL, ",");
 		}
-		
 	}
 	else {
-		printf("Invalid data format in line: %d\n", line);
+		report_at(line, "Invalid data format in line: %d\n", line);
 	}
+	return 1;
 }
 
-void check_valid_string(char* rest_of_line, int* DC, int line, data_image** data_image_head) {
+void check_valid_string(const char* rest_of_line, size_t length, int* DC, int line, memory_image* data) {
 	int i;
-	if (starts_and_ends_with_quote(rest_of_line)) {
+	if (starts_and_ends_with_quote(rest_of_line, length)) {
 		
-		for (i = 1; i < (int)strlen(rest_of_line) - 1; i++) { 
-			add_to_data_image((int)rest_of_line[i],*DC, data_image_head,line);
+		for (i = 1; i < (int)length - 1; i++) { 
+			add_to_data_image((int)rest_of_line[i],*DC, data,line);
 			(*DC)++;
 		}
 		
-		add_to_data_image((int)'\0',*DC, data_image_head,line);
+		add_to_data_image((int)'\0',*DC, data,line);
 		(*DC)++;
 	}
 	else {
-		printf("Invalid string in line: %d\n", line);
+		report_at(line, "Invalid string in line: %d\n", line);
 	}
 }
 
 
-void update_data_label(label *label_head,int IC){
-	label* current = label_head;
-	while (current != NULL) {
-		if (strcmp(current->type_of_label,".data") == 0) {
-			current->address_of_label += IC;
+void init_fixup_list(fixup_list* fixups, arena* memory) {
+	fixups->memory = memory;
+	fixups->fixups = arena_alloc(memory, FIXUPS_INIT_SIZE * sizeof(fixup), ALLOC_FIXUPS);
+	fixups->count = 0;
+	fixups->capacity = FIXUPS_INIT_SIZE;
+	fixups->entries = arena_alloc(memory, FIXUPS_INIT_SIZE * sizeof(entry_request), ALLOC_FIXUPS);
+	fixups->entry_count = 0;
+	fixups->entry_capacity = FIXUPS_INIT_SIZE;
+}
+
+void add_operand_fixups(fixup_list* fixups, line_tokens* tokens, int line, memory_image* code, int address) {
+	fixup* grown;
+	token* operand;
+	int i;
+	/* the words of the instruction of the line, the label operands left them unresolved in their order */
+	int slot = address - code->base;
+
+	for (i = tokens->statement + 1; i < tokens->count; i++) {
+		operand = &tokens->tokens[i];
+		/* immediates, registers and commas are not labels */
+		if (operand->kind != TOKEN_LABEL_REF && operand->kind != TOKEN_NUMBER) {
+			continue;
 		}
-		current = current->next;
+		if (fixups->count == fixups->capacity) {
+			fixups->capacity *= 2;
+			grown = arena_alloc(fixups->memory, fixups->capacity * sizeof(fixup), ALLOC_FIXUPS);
+			memcpy(grown, fixups->fixups, fixups->count * sizeof(fixup));
+			fixups->fixups = grown;
+		}
+		/* the line is reused for the next line, so the name is copied */
+		fixups->fixups[fixups->count].name = arena_strndup(fixups->memory, operand->start, operand->length, ALLOC_FIXUPS);
+		fixups->fixups[fixups->count].name_length = operand->length;
+		fixups->fixups[fixups->count].line = line;
+		fixups->fixups[fixups->count].slot = -1;
+		if (operand->kind == TOKEN_LABEL_REF) {
+			while (slot < code->count && code->words[slot] != UNRESOLVED_WORD) {
+				slot++;
+			}
+			if (slot < code->count) {
+				fixups->fixups[fixups->count].slot = slot++;
+			}
+		}
+		fixups->count++;
 	}
-	
 }
 
+void add_entry_request(fixup_list* fixups, const char* name, size_t length, int line) {
+	entry_request* grown;
 
+	if (fixups->entry_count == fixups->entry_capacity) {
+		fixups->entry_capacity *= 2;
+		grown = arena_alloc(fixups->memory, fixups->entry_capacity * sizeof(entry_request), ALLOC_FIXUPS);
+		memcpy(grown, fixups->entries, fixups->entry_count * sizeof(entry_request));
+		fixups->entries = grown;
+	}
+	fixups->entries[fixups->entry_count].name = arena_strndup(fixups->memory, name, length, ALLOC_FIXUPS);
+	fixups->entries[fixups->entry_count].name_length = length;
+	fixups->entries[fixups->entry_count].line = line;
+	fixups->entry_count++;
+}
 
+void update_data_label(symbol_table *symbols,int IC){
+	int i;
+	for (i = 0; i < symbols->count; i++) {
+		if (symbols->labels[i].kind == SYMBOL_DATA) {
+			symbols->labels[i].address_of_label += IC;
+		}
+	}
+	
+}
 
 
-void add_to_data_image(int value, int address, data_image** data_image_head, int line) {
-    
-
-    int i;
-    char binary_value[16]; 
-    data_image* new_node;
-    binary_value[15] = '\0';
-    
 
-  
-    for (i = 14; i >= 0; i--) {
-        binary_value[i] = (value & 1) ? '1' : '0';
-        value >>= 1;
-    }
 
-    new_node = (data_image*)handle_malloc(sizeof(data_image));
-    
-    new_node->binary_value = duplicate(binary_value);
-    new_node->address = address;
-    new_node->line = line;
-    new_node->next = NULL;
-    
 
-    if (*data_image_head == NULL) {
-        *data_image_head = new_node;
-    } else {
-        data_image* current = *data_image_head;
-        while (current->next != NULL) {
-            current = current->next;
-        }
-        current->next = new_node;
-    }
-	
+void init_memory_image(memory_image* image, int base, arena* memory, int site) {
+	image->words = NULL;
+	image->lines = NULL;
+	image->count = 0;
+	image->capacity = 0;
+	image->base = base;
+	image->memory = memory;
+	image->site = site;
 }
 
+void store_word(memory_image* image, int address, int word, int line) {
+	int index = address - image->base;
+	unsigned short* words;
+	int* lines;
 
-
-
-void add_to_instruction_memory(int line,int address,char* binary_str , instruction_memory** instruction_memory_head) {
-	instruction_memory* new_instruction = (instruction_memory*)handle_malloc(sizeof(instruction_memory));
-	new_instruction->address = address;
-	new_instruction->line = line;
-	new_instruction->binary_str = duplicate(binary_str);
-	new_instruction->next = NULL;
-
-	if (*instruction_memory_head == NULL) {
-		*instruction_memory_head = new_instruction;
-	}
-	else {
-		instruction_memory* current = *instruction_memory_head;
-		while (current->next != NULL) {
-			current = current->next;
+	/* the arrays are doubled when they are full, so a word is added in constant time */
+	if (index >= image->capacity) {
+		while (index >= image->capacity) {
+			image->capacity = (image->capacity == 0) ? IMAGE_INIT_SIZE : image->capacity * 2;
 		}
-		current->next = new_instruction;
-	}
-}
-label* find_label_by_name(const char* name_of_label, label* label_head) {
-	label* current = label_head;
-	while (current != NULL) {
-		if (strcmp(current->name_of_label, name_of_label) == 0) {
-			return current;
+		/* the old arrays stay in the arena until the file is done, together they are smaller than the new ones */
+		words = arena_alloc(image->memory, image->capacity * sizeof(unsigned short), image->site);
+		lines = arena_alloc(image->memory, image->capacity * sizeof(int), image->site);
+		if (image->count > 0) {
+			memcpy(words, image->words, image->count * sizeof(unsigned short));
+			memcpy(lines, image->lines, image->count * sizeof(int));
 		}
-		current = current->next;
+		image->words = words;
+		image->lines = lines;
 	}
-	return NULL;
-}
-void update_label_type(label* lbl, const char* new_type) {
-	if (lbl->type_of_label != NULL) {
-		free(lbl->type_of_label);
+	image->words[index] = (unsigned short)word;
+	image->lines[index] = line;
+	if (index >= image->count) {
+		image->count = index + 1;
 	}
-	lbl->type_of_label = duplicate(new_type);
 }
-void create_entry_file(const char* filename, const char* rest_of_line, label* label_head) {
-	FILE* file;
-	label* lbl = find_label_by_name(rest_of_line, label_head);
-	if (lbl == NULL) {
-		printf("Label %s not found\n", rest_of_line);
-		return;
-	}
 
-	file = fopen(filename, "w");
-	if (file == NULL) {
-		perror("Error opening file");
-		return;
-	}
-
-	fprintf(file, "%s %d\n", rest_of_line, lbl->address_of_label);
-
-	fclose(file);
+void add_to_data_image(int value, int address, memory_image* data, int line) {
+	/* a data word keeps the lowest 15 bits of the value, in two's complement */
+	store_word(data, address, value & WORD_MASK, line);
 }
 
-void convert_str_to_binary(int length, char *str, char *ARE) {
-    char *token;
-    char binary[WORD_LEN];
-    char result[FILED_SIZE] = "";
-	if(str[0]=='\0' ||!strcmp(str,"NULL")){/*if its label or empty argument*/
-		return;
-	}
-	else{
-		token = strtok(str, ",");
-		while (token != NULL) {
-			int num = atoi(token);
-			decimal_to_binary(length, num, binary);
-			strcat(result, binary);
-			token = strtok(NULL, ",");
-		}
-
-		strcat(result, ARE);
-		strcpy(str, result);
-	}
-		
+void add_to_instruction_memory(int line,int address,int word , memory_image* code) {
+	store_word(code, address, word, line);
 }
-
-
-void convert_first_word_to_binary(int length, char* str, char* ARE) {
-
-	char* token;
-	char binary[WORD_LEN];
-	int first_number = 1;
-	char result[FILED_SIZE] = "";
-	
-	token = strtok(str, ",");
-	while (token != NULL) {
-		int num = atoi(token);
-		if (first_number && (num >= 0)) {
-			decimal_to_binary(length, num, binary);
-			first_number = 0;
-		} else {
-			convert_to_binary(length, num, binary);
-		}
-		strcat(result, binary);
-		token = strtok(NULL, ",");
+int addressing_mode_field(int addressing_mode) {
+	/* one bit for each addressing method, none for a missing operand */
+	if (addressing_mode >= 0 && addressing_mode < 4) {
+		return 1 << addressing_mode;
 	}
-	
-	strcat(result, ARE);
-	strcpy(str, result);
+	return 0;
 }
 
-void decimal_to_binary(int length, int decimal, char binary[])
-{
-	int i;
-	int is_negative = 0;
-	char temp;
-	/* Handle negative numbers */
-	if (decimal < 0)
-	{
-		is_negative = 1;
-		decimal = -decimal;
-	}
-	/* Handle special case for 0 */
-	if (decimal == 0)
-	{
-		memset(binary, '0', length);
-		binary[length] = '\0';
-		return;
-	}
-	/* Convert the decimal number to binary */
-	i = 0;
-	while (decimal > 0)
-	{
-		binary[i++] = (decimal % 2) ? '1' : '0';
-		decimal /= 2;
-	}
-	/* Pad the binary representation with '0's to ensure it has the correct length */
-	while (i < length)
-		binary[i++] = '0';
-
-	/* Null-terminate the string */
-	binary[i] = '\0';
-	/* Reverse the binary array to get the correct representation */
-	for (i = 0; i < length / 2; i++)
-	{
-		temp = binary[i];
-		binary[i] = binary[length - i - 1];
-		binary[length - i - 1] = temp;
-	}
-	/* If number was negative, compute two's complement */
-	if (is_negative)
-	{
-		for (i = 0; i < length; i++)
-		{
-			binary[i] = (binary[i] == '0') ? '1' : '0'; /*Invert bits */
-		}
-		/* Add 1 to the binary number */
-		for (i = length - 1; i >= 0; i--)
-		{
-			if (binary[i] == '0')
-			{
-				binary[i] = '1';
-				break;
-			}
-			else
-			{
-				binary[i] = '0';
-			}
-		}
-	}
+int encode_first_word(int num_of_opcode, int type_of_source_arg, int type_of_target_arg) {
+	return (num_of_opcode << OPCODE_SHIFT) |
+		(addressing_mode_field(type_of_source_arg) << SOURCE_MODE_SHIFT) |
+		(addressing_mode_field(type_of_target_arg) << TARGET_MODE_SHIFT) |
+		ARE_ABSOLUTE;
 }
 
-void convert_to_binary(int length, int decimal, char binary[]) {
-
-	memset(binary, '0', length);
-
-	if (decimal >= 0 && decimal < length) {
-		binary[length - decimal - 1] = '1';
-	}
+int operand_fits(int value) {
+	return value >= OPERAND_MIN && value <= OPERAND_MAX;
+}
 
-	binary[length] = '\0';
+int encode_operand_word(int value, int ARE) {
+	return ((value & OPERAND_MASK) << OPERAND_SHIFT) | ARE;
 }
 
+int encode_register_word(int source_register, int target_register) {
+	return ((source_register & REGISTER_MASK) << SOURCE_REGISTER_SHIFT) |
+		((target_register & REGISTER_MASK) << TARGET_REGISTER_SHIFT) |
+		ARE_ABSOLUTE;
+}
 
 
-int opcode_process(char* first_word, char* rest_of_line, int* IC,int line,instruction_memory **instruction_memory_head) {
+int opcode_process(line_tokens* tokens, int* IC,int line,memory_image *code) {
 	
 	int detected_label_on_first_pass = 0;
 	int num_of_opcode = 0;
-	int fieldBitSize1 = 0, fieldBitSize2 = 0, fieldBitSize3 = 0;
-	char* first_word_to_binary = (char*)calloc(16, sizeof(char)); /* Allocate memory for the binary string */
-	char* second_word_to_binary = (char*)calloc(16, sizeof(char)); /* Allocate memory for the binary string */
-	char* third_word_to_binary = (char*)calloc(16, sizeof(char)); /* Allocate memory for the binary string */
-
-	if (first_word_to_binary == NULL || second_word_to_binary == NULL || third_word_to_binary == NULL) {
-        fprintf(stderr, "Error: malloc failed\n");
-        free(first_word_to_binary);
-        free(second_word_to_binary);
-        free(third_word_to_binary);
-        return 0;
-    }
+	int words[MAX_INSTRUCTION_WORDS];
+	int word_count = 0;
+	int i;
 	
-	if (valid_num_argument(first_word, rest_of_line, &num_of_opcode)) {
-		if(!parsing_arg(first_word, rest_of_line, first_word_to_binary, second_word_to_binary, third_word_to_binary,
-		&fieldBitSize1, &fieldBitSize2, &fieldBitSize3, &detected_label_on_first_pass))
+	if (valid_num_argument(tokens, &num_of_opcode, line)) {
+		if(!parsing_arg(tokens, words, &word_count, &detected_label_on_first_pass, line))
 		{
-			printf("invalid argument in line: %d\n",line);
+			report_at(line, "invalid argument in line: %d\n",line);
 			return 0;
 		}
 		
-		if (first_word_to_binary != NULL) {
-			convert_first_word_to_binary(fieldBitSize1, first_word_to_binary, "100");
-			convert_str_to_binary(fieldBitSize2, second_word_to_binary, "100");
-			convert_str_to_binary(fieldBitSize3, third_word_to_binary, "100");
-		
-		}
-		
-			add_to_instruction_memory(line,*IC,first_word_to_binary,instruction_memory_head);
+		for (i = 0; i < word_count; i++) {
+			add_to_instruction_memory(line,*IC,words[i],code);
 			(*IC)++;
-
-			
-			if (strcmp(second_word_to_binary,"NULL") != 0) {/*if its not empty*/
-				add_to_instruction_memory(line,*IC,second_word_to_binary,instruction_memory_head);
-				(*IC)++;
-			}
-			
-			
-			if (strcmp(third_word_to_binary,"NULL") != 0) {
-				add_to_instruction_memory(line,*IC,third_word_to_binary,instruction_memory_head);
-				(*IC)++;
-			}
-		
-			free(first_word_to_binary);
-			free(second_word_to_binary);
-			free(third_word_to_binary);
-			return 1;
 		}
-	
-	free(first_word_to_binary);
-	free(second_word_to_binary);
-	free(third_word_to_binary);
-	return 0;
-}
-
-
-void free_label_list(label* head) {
-	label* current = head;
-	label* next;
-
-	while (current != NULL) {
-		next = current->next;
-		free(current->name_of_label);
-		free(current->type_of_label);
-		free(current);
-		current = next;
-	}
-}
-
-void free_instruction_memory(instruction_memory* head) {
-	instruction_memory* current = head;
-	instruction_memory* next;
-
-	while (current != NULL) {
-		next = current->next;
-		free(current->binary_str);
-		free(current);
-		current = next;
-	}
-}
-
-void free_data_image(data_image* data_image_head) {
-	data_image* current = data_image_head;
-	data_image* next_node;
-
-	while (current != NULL) {
-		next_node = current->next;
-		free(current);
-		current = next_node;
+		return 1;
 	}
-
-	data_image_head = NULL;
-}
-
-
-unsigned int binaryToOctal(const char *binary) {
-    unsigned int octal = 0;
-    unsigned int power = 1;
-    int len = strlen(binary);
-    int i;
-
-    for (i = len - 1; i >= 0; i--) {
-        if (binary[i] == '1') {
-            octal += power;
-        }
-        power *= 2;
-    }
-
-    return octal;
-}
-
-void copyAndConvertFile(char *sourceFile, char *destinationFile) {
-    FILE *src = fopen(sourceFile, "r");
-    FILE *dest = fopen(destinationFile, "w");
-    char buffer[256];
-
-    if (!src || !dest) {
-        perror("Error opening file");
-        exit(EXIT_FAILURE);
-    }
-
-    
-
-
-    if (fgets(buffer, sizeof(buffer), src)) {
-        fputs(buffer, dest);
-    }
-
-
-    while (fgets(buffer, sizeof(buffer), src)) {
-        unsigned int address;
-        char binary[128] = "";
-
-
-        int result = sscanf(buffer, "%u\t%127[^\n]", &address, binary);
-
-
-        if (result == 1 || strlen(binary) == 0) {
-
-            fprintf(dest, "%04u 00001\n", address);
-        } else if (result == 2) {
-
-            unsigned int octal = binaryToOctal(binary);
-
-
-            fprintf(dest, "%04u %05o\n", address, octal);
-        } else {
-            fprintf(stderr, "Failed to parse line: %s", buffer);
-        }
-    }
-
-    fclose(src);
-    fclose(dest);
+	return 0;
 }
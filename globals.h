@@ -1,17 +1,17 @@
 #ifndef LABRATORY_C_FINAL_PROJECT_GLOBALS_H
 #define LABRATORY_C_FINAL_PROJECT_GLOBALS_H
 
+#include <stdio.h>
+
 /*The File contain all the global values in the program*/
 
 /* Maximum length of a label in command line  */
 #define MAX_LABEL_LENGTH 31
 
-/* Maximum length of a single command line  */
+/* Maximum length of a single command line in the strict dialect, including the '\n' */
 #define MAX_LINE_LENGTH 81
 /* Default IC value */
 #define IC_INIT_VALUE 100
-/* arbitrary very big number for line length */
-#define BIG_NUMBER_CONST 1000
 
 #define INSTRUCTIONS_COUNT 4
 
@@ -21,7 +21,97 @@
 
 #define WORD_LEN 16
 
-#define FILED_SIZE 13
+/* The fields of a 15-bit machine word, from its lowest bit:
+ * A/R/E (3 bits), then the target and the source addressing modes (4 bits each) and the opcode (4 bits)
+ * in the first word of an instruction, or the operand (12 bits) in the other words */
+#define WORD_MASK 0x7FFF
+#define ARE_ABSOLUTE 4
+#define ARE_RELOCATABLE 2
+#define ARE_EXTERNAL 1
+#define OPCODE_SHIFT 11
+#define SOURCE_MODE_SHIFT 7
+#define TARGET_MODE_SHIFT 3
+#define OPERAND_SHIFT 3
+#define OPERAND_MASK 0xFFF
+/* The values an operand word holds without losing a bit, read as a signed or as an unsigned 12-bit number */
+#define OPERAND_MIN (-2048)
+#define OPERAND_MAX 4095
+/* The values a data word holds without losing a bit, read as a signed or as an unsigned 15-bit number */
+#define DATA_MIN (-16384)
+#define DATA_MAX 32767
+#define SOURCE_REGISTER_SHIFT 6
+#define TARGET_REGISTER_SHIFT 3
+#define REGISTER_MASK 7
+
+/* A word of the code whose label address is filled in the second pass, it is not a 15-bit value */
+#define UNRESOLVED_WORD 0xFFFF
+
+/* The most words an instruction can take */
+#define MAX_INSTRUCTION_WORDS 3
+
+
+/* Initial number of slots in the macro table, must be a power of 2 */
+#define MACRO_TABLE_INIT_SIZE 64
+
+/* Initial number of slots in the symbol table, must be a power of 2 */
+#define SYMBOL_TABLE_INIT_SIZE 64
+
+/* The value of an empty slot of the symbol table */
+#define EMPTY_SLOT (-1)
+
+/* Initial number of characters in the pool of the label names */
+#define NAME_POOL_INIT_SIZE 1024
+
+/* Initial number of fixups and of .entry requests in a fixup list */
+#define FIXUPS_INIT_SIZE 64
+
+/* The fewest lines worth a thread of their own in the first pass of a file */
+#define CHUNK_MIN_LINES 4096
+
+/* Number of output files of an assembly, ".am", ".ob", ".ent", ".ext" and ".obb" */
+#define CACHED_ENDINGS_COUNT 5
+
+/* Initial number of words in a memory image */
+#define IMAGE_INIT_SIZE 256
+
+/* Initial capacity of a growable buffer */
+#define BUFFER_INIT_SIZE 256
+
+/* Number of bytes in a block of an arena, larger allocations get a block of their own */
+#define ARENA_BLOCK_SIZE (64 * 1024)
+
+/* Initial number of tokens in the token array of a line */
+#define TOKENS_INIT_SIZE 16
+
+/* The first bytes of a binary object (".obb") file, with its '\0', and the version of its layout */
+#define BINARY_OBJECT_MAGIC "OBB"
+#define BINARY_OBJECT_VERSION 1
+
+/* Number of bytes in the header of a binary object file, 16 numbers of 4 bytes */
+#define BINARY_OBJECT_HEADER_SIZE 64
+
+/* Number of slots in the perfect hash table of the reserved words, must be a power of 2 */
+#define KEYWORD_SLOTS 64
+
+/* Length of the shortest and the longest reserved word */
+#define KEYWORD_MIN_LENGTH 2
+#define KEYWORD_MAX_LENGTH 7
+
+/*The indexes of the instructions in the INSTRUCTION table*/
+enum instruction_index { DATA_INSTRUCTION, STRING_INSTRUCTION, EXTERN_INSTRUCTION, ENTRY_INSTRUCTION };
+
+/*The formats of the statistics of a file, --stats prints them as text and --stats=json as a line of JSON*/
+enum stats_format { STATS_OFF, STATS_TEXT, STATS_JSON };
+
+/*The stages of an assembly that are timed for the statistics, the normalization is a part of the pre-assembler*/
+enum stats_stage { STATS_READ, STATS_PRE_ASSEMBLER, STATS_NORMALIZE, STATS_FIRST_PASS, STATS_SECOND_PASS, STATS_OBJECT, STATS_WRITE, STATS_STAGES_COUNT };
+
+/*The kinds of memory that the allocation profiler counts apart, every allocation names the one it is for*/
+enum alloc_site { ALLOC_LABELS, ALLOC_MACROS, ALLOC_INSTRUCTION_WORDS, ALLOC_DATA_WORDS, ALLOC_FIXUPS, ALLOC_LINES,
+    ALLOC_MESSAGES, ALLOC_FILE_NAMES, ALLOC_BUFFERS, ALLOC_ARENA_BLOCKS, ALLOC_TABLES, ALLOC_SITES_COUNT };
+
+/*The indexes of the output files of an assembly, in the order of their endings*/
+enum output_index { OUTPUT_AM, OUTPUT_OB, OUTPUT_ENT, OUTPUT_EXT, OUTPUT_OBB };
 
 /*This struct holds information about the location of a particular piece of code within a source file.*/
 typedef struct location {
@@ -51,35 +141,352 @@ typedef struct op_code {
     int source_type[4];/*all the possible values to source type*/
 } op_code;
 
+/*This struct holds the options of the assembler from the command line*/
+typedef struct assembler_options {
+    int emit_am;            /*1 to write the expanded source to the ".am" file*/
+    int emit_obb;           /*1 to write the binary object (".obb") file next to the ".ob" file*/
+    long max_line_length;   /*The longest line allowed, including its '\n', or 0 for no limit*/
+    int memory_report;      /*1 to print the number of bytes each file took from its arena*/
+    int jobs;               /*The number of threads that assemble files, 1 to assemble them one by one*/
+    int pass_threads;       /*The number of threads that share the first pass of a large file*/
+    int stats;              /*The format of the statistics of every file, STATS_OFF to leave them out*/
+    int alloc_profile;      /*1 to count the allocations of every file by their site, for --alloc-profile*/
+} assembler_options;
+
+/*This struct holds the time of every stage of an assembly and what it counted, for --stats*/
+typedef struct assembly_stats {
+    long nanoseconds[STATS_STAGES_COUNT]; /*The monotonic time spent in every stage, by enum stats_stage*/
+    long source_lines;      /*The lines of the source file*/
+    long expanded_lines;    /*The lines after the macros were expanded*/
+    long macros;            /*The macros that were declared*/
+    long macro_calls;       /*The lines that called a macro*/
+    long labels;            /*The labels, the external ones included*/
+    long instruction_words; /*The words of the instruction image*/
+    long data_words;        /*The words of the data image*/
+    long fixups;            /*The operands that may be labels*/
+    long entries;           /*The .entry lines*/
+    long bytes_read;        /*The characters of the source file*/
+    long bytes_written;     /*The characters of the output files*/
+} assembly_stats;
+
+/*This struct holds what the allocation profiler counted for one site*/
+typedef struct alloc_site_stats {
+    long calls;                 /*The allocations, a reallocation counts as one*/
+    unsigned long bytes;        /*The bytes of all the allocations*/
+    unsigned long live_bytes;   /*The bytes of the allocations that were not freed yet*/
+    unsigned long peak_bytes;   /*The most bytes that were live at once*/
+} alloc_site_stats;
+
+/*This struct holds the allocations of one file by their site, the allocations of a thread are counted in its current profile*/
+typedef struct alloc_profile {
+    long file;                                  /*The number of the file in the run, it tells the allocations of the file from older ones*/
+    alloc_site_stats sites[ALLOC_SITES_COUNT];  /*The counts of every site, by enum alloc_site*/
+} alloc_profile;
+
+/*This struct is a buffer of characters that grows as characters are appended to it*/
+typedef struct byte_buffer {
+    char *data;       /*The characters in the buffer, NULL while it is empty*/
+    size_t length;    /*The number of characters in the buffer*/
+    size_t capacity;  /*The number of characters the buffer can hold before it grows*/
+} byte_buffer;
+
+/*This struct is a block of memory of an arena, its bytes follow the struct*/
+typedef struct arena_block {
+    struct arena_block *next; /*The next block, the blocks are kept after a reset and used again*/
+    size_t size;    /*The number of bytes in the block*/
+    size_t used;    /*The number of bytes handed out from the block*/
+} arena_block;
+
+/*This struct is a bump allocator, the memory of one file is taken from it and given back at once*/
+typedef struct arena {
+    arena_block *first;     /*The first block, NULL before the first allocation*/
+    arena_block *current;   /*The block the allocations are taken from*/
+    size_t used;            /*The number of bytes handed out since the last reset*/
+    size_t reserved;        /*The number of bytes in all the blocks*/
+    unsigned long site_bytes[ALLOC_SITES_COUNT];    /*The bytes taken for every site since the last reset, while the allocations are profiled*/
+    alloc_profile *profile; /*The profile the bytes were counted in, NULL if none*/
+    long profile_file;      /*The file of that profile when the bytes were counted*/
+} arena;
+
 /*This struct is used to define a macro*/
 typedef struct node {
     char *macro_name; /*The name of the macro*/
-    char *macro_content; /*The content of the macro*/
+    char *macro_content; /*The lines of the macro, each one is followed by '\0'*/
+    size_t content_length; /*The number of characters in the content of the macro*/
     int macro_line; /*The line number where the macro was defined.*/
-    struct node *next; /*A pointer to the next node in the linked list*/
+    unsigned long hash; /*The hash of the macro name*/
 } node;
 
+/*This struct is an open addressing hash table of the macros, keyed on the macro name*/
+typedef struct macro_table {
+    node **slots;   /*The slots of the table, NULL when empty*/
+    int capacity;   /*The number of slots, always a power of 2*/
+    int count;      /*The number of macros in the table*/
+    arena *memory;  /*The arena that holds the slots and the macros*/
+} macro_table;
+
+/*This struct holds a line of an input file as a pointer into the content of the file and its length*/
+typedef struct line_slice {
+    const char *start; /*The first character of the line*/
+    size_t length;     /*The number of characters in the line, including the '\n' at its end*/
+} line_slice;
+
+/*This struct holds the content of an input file, mapped to memory or read into a buffer*/
+typedef struct input_file {
+    char *data;     /*The content of the file*/
+    size_t size;    /*The number of characters in the file*/
+    size_t pos;     /*The offset of the next line*/
+    int is_mapped;  /*1 if the content was mapped with mmap, 0 if it was read into a buffer*/
+    int is_borrowed; /*1 if the content belongs to the caller, it is not released with the input*/
+} input_file;
+
+/*This struct is used to pull the lines of a source file after the pre-assembler, one line at a time*/
+typedef struct line_source {
+    input_file input;       /*The content of the source (.as) file*/
+    byte_buffer *am_text;   /*The copy of the expanded lines (.am), NULL if it was not requested*/
+    macro_table *macros;    /*The macro table*/
+    arena *memory;          /*The arena of the file, it holds the macros, the labels and the memory images*/
+    char *macro_name;       /*The name of the macro being defined, NULL outside a valid definition*/
+    byte_buffer macro_content; /*The lines collected for the macro being defined*/
+    int macro_line;         /*The line number where the macro being defined starts*/
+    int in_macro_decl;      /*1 between a "macr" line and its "endmacr" line*/
+    char *expansion;        /*The next line of the macro call being expanded, NULL if there is none*/
+    char *expansion_end;    /*The end of the content of the macro being expanded*/
+    int source_line;        /*The current line number in the source file*/
+    int is_valid;           /*0 once an error was found in the source file*/
+    long max_line_length;   /*The longest line allowed, including its '\n', or 0 for no limit*/
+    byte_buffer line;       /*The last line that was handed out*/
+    assembly_stats *stats;  /*The statistics of the file, NULL if they are not kept*/
+} line_source;
+
+/*The kernels that copy the runs of characters of a line while its white-spaces are removed*/
+typedef enum normalize_kernel {
+    NORMALIZE_AUTO,     /*The fastest kernel the processor supports*/
+    NORMALIZE_SCALAR,   /*One character at a time, on any processor*/
+    NORMALIZE_SSE2,     /*16 characters at a time*/
+    NORMALIZE_AVX2      /*32 characters at a time*/
+} normalize_kernel;
+
+/*The kinds of the reserved words of the language*/
+typedef enum keyword_kind {
+    KEYWORD_NONE,           /*Not a reserved word*/
+    KEYWORD_OPCODE,         /*The name of an opcode*/
+    KEYWORD_INSTRUCTION,    /*The name of an instruction, starting with '.'*/
+    KEYWORD_REGISTER        /*The name of a register*/
+} keyword_kind;
+
+/*This struct is a slot of the perfect hash table of the reserved words*/
+typedef struct keyword {
+    const char *name;   /*The reserved word, NULL in an empty slot*/
+    keyword_kind kind;  /*The kind of the reserved word*/
+    int index;          /*The index of the opcode or the instruction in its table, or the number of the register*/
+} keyword;
+
+/*The kinds of the tokens of a line*/
+typedef enum token_kind {
+    TOKEN_LABEL_DEF,    /*The first word of the line when it ends with ':'*/
+    TOKEN_DIRECTIVE,    /*A word starting with '.' in the place of an instruction*/
+    TOKEN_MNEMONIC,     /*The name of an opcode*/
+    TOKEN_WORD,         /*Any other word in the place of an instruction or an opcode*/
+    TOKEN_IMMEDIATE,    /*An operand starting with '#'*/
+    TOKEN_INDIRECT,     /*An operand starting with '*'*/
+    TOKEN_REGISTER,     /*An operand starting with 'r'*/
+    TOKEN_NUMBER,       /*An operand that is a whole number*/
+    TOKEN_LABEL_REF,    /*Any other operand, a label if its name is valid*/
+    TOKEN_STRING,       /*The text after a .string instruction*/
+    TOKEN_COMMA         /*A comma between operands*/
+} token_kind;
+
+/*This struct holds a token of a line as a pointer into the line and its length*/
+typedef struct token {
+    token_kind kind;    /*The kind of the token*/
+    const char *start;  /*The first character of the token*/
+    size_t length;      /*The number of characters in the token*/
+    int value;          /*The index of an instruction or an opcode, the value of a number,
+                          or the value after the first character of an operand, -1 if there is none*/
+} token;
+
+/*This struct holds the tokens of a line, they are found once and used by both passes*/
+typedef struct line_tokens {
+    token *tokens;      /*The tokens of the line, in order*/
+    int count;          /*The number of tokens*/
+    int capacity;       /*The number of tokens the array can hold before it grows*/
+    int statement;      /*The index of the instruction or opcode token, -1 if the line has none*/
+    line_slice operands; /*The text of the operands as it was written*/
+} line_tokens;
+
+/*This struct holds the line of the source that a reported message names, by the place of the message in its buffer*/
+typedef struct message_line {
+    size_t start;   /*The number of characters in the buffer before the message*/
+    int line;       /*The line of the source*/
+} message_line;
+
+/*This struct holds the lines of the messages of one buffer that were reported with a line, in the order of the buffer*/
+typedef struct message_lines {
+    message_line *lines;    /*The lines of the messages*/
+    int count;              /*The number of messages with a line*/
+    int capacity;           /*The number of messages the array can hold before it grows*/
+} message_lines;
+
+/*This struct holds the messages of a file that is assembled next to other files, they are printed in its turn*/
+typedef struct diagnostics {
+    byte_buffer out;    /*The messages for stdout*/
+    byte_buffer err;    /*The messages for stderr*/
+    message_lines out_lines;    /*The lines of the messages for stdout*/
+    message_lines err_lines;    /*The lines of the messages for stderr*/
+} diagnostics;
+
+/*This struct holds one message of an assembly, a line of its diagnostics*/
+typedef struct assembly_message {
+    int is_error;       /*1 for a message to stderr, 0 for a message to stdout*/
+    int line;           /*The line of the source the message was reported with, 0 if it was reported without one*/
+    const char *text;   /*The text of the message, it points into the diagnostics of the result*/
+    size_t length;      /*The number of characters in the text, without its '\n'*/
+} assembly_message;
+
+/*This struct holds what an assembly of a source in memory produced, it can be used again for the next source*/
+typedef struct assembly_result {
+    byte_buffer outputs[CACHED_ENDINGS_COUNT];  /*The content of the output files, by enum output_index*/
+    int has_output[CACHED_ENDINGS_COUNT];       /*1 for every output file the assembly produced*/
+    diagnostics diag;           /*The messages, as they are printed*/
+    assembly_message *messages; /*The messages one by one, in the order of the buffers of diag*/
+    int message_count;          /*The number of messages*/
+    int message_capacity;       /*The number of messages the array can hold before it grows*/
+    int is_valid;               /*1 if the source was assembled without errors*/
+    assembly_stats stats;       /*The times of the stages and the counts, kept when the options ask for statistics*/
+} assembly_result;
+
 /*This struct is used to define a register*/
 typedef struct Register{
     char *name_of_register; /*The name of the register*/
     int reg_num; /*The number of the register.*/
 }Register;
 
-/*This struct is used to store information about data values*/
-typedef struct data_image {
-    int address; /*The address where the data value is stored*/
-    char* binary_value; /* The binary representation of the data value.*/
-    int line; /*The line number in the source file where this entry was processed.*/
-    struct data_image *next; /*A pointer to the next entry in the data image linked list.*/
-} data_image;
+/*This struct holds the instruction image or the data image, the words are stored one after the other
+  and the word of an address is found at the index address - base*/
+typedef struct memory_image {
+    unsigned short *words; /*The value of each word, UNRESOLVED_WORD while the address of its label is missing*/
+    int *lines;     /*The line number in the source file of each word, in a parallel array*/
+    int count;      /*The number of words in the image*/
+    int capacity;   /*The number of words the image can hold before it grows*/
+    int base;       /*The address of the first word*/
+    arena *memory;  /*The arena that holds the arrays*/
+    int site;       /*ALLOC_INSTRUCTION_WORDS or ALLOC_DATA_WORDS, for the allocation profiler*/
+} memory_image;
+
+/*This struct is an entry or an external of a binary object file, as it is stored in the file*/
+typedef struct object_symbol {
+    unsigned int name;      /*The offset of the name in the string pool of the file*/
+    unsigned int address;   /*The address of an entry label, or of a word that uses an external label*/
+} object_symbol;
+
+/*This struct points into a binary object file in memory, a mapped file is used as it is and nothing is copied*/
+typedef struct binary_object {
+    long IC;                        /*The instruction counter, the address after the last code word*/
+    long DC;                        /*The data counter, the number of data words*/
+    long base;                      /*The address of the first code word*/
+    const unsigned short *code;     /*The code words, IC - base of them*/
+    const unsigned short *data;     /*The data words, placed after the code*/
+    const object_symbol *entries;   /*The entry labels, in the order of the ".ent" file*/
+    long entry_count;               /*The number of entries*/
+    const object_symbol *externs;   /*The uses of external labels, in the order of the ".ext" file*/
+    long extern_count;              /*The number of uses of external labels*/
+    const char *pool;               /*The names, each one followed by '\0'*/
+    size_t pool_size;               /*The number of characters in the pool*/
+} binary_object;
+
+/*The kinds of the labels*/
+typedef enum symbol_kind {
+    SYMBOL_CODE,        /*A label of an instruction*/
+    SYMBOL_DATA,        /*A label of a .data or .string instruction, it is placed after the code*/
+    SYMBOL_EXTERNAL     /*A label declared by .extern, its address is found by the linker*/
+} symbol_kind;
 
 typedef struct label{
-    char *name_of_label;  /*The name of the label.*/
-    char * type_of_label; /* The type of the label*/
+    unsigned long hash;   /* The hash of the name of the label.*/
+    size_t name_offset;   /* The offset of the name in the name pool of the symbol table, it ends with '\0'.*/
+    size_t name_length;   /* The number of characters in the name of the label.*/
     int address_of_label; /* The address of the label in memory or code. */
-    struct label *next;   /* A pointer to the next label in the linked list.*/
+    symbol_kind kind;     /* The kind of the label.*/
 }label;
 
+/*This struct is an open addressing hash table of the labels, keyed on the label name*/
+typedef struct symbol_table{
+    int *slots;     /*The slots of the table, the index of a label or EMPTY_SLOT*/
+    int capacity;   /*The number of slots, always a power of 2*/
+    label *labels;  /*The labels in the order of definition, there is room for capacity / 2 of them*/
+    int count;      /*The number of labels in the table*/
+    char *names;    /*The pool of the names of the labels, one after the other*/
+    size_t names_length;    /*The number of characters in the pool*/
+    size_t names_capacity;  /*The number of characters the pool can hold before it grows*/
+    arena *memory;  /*The arena that holds the slots, the labels and the pool*/
+}symbol_table;
+
+/*This struct holds an operand that may be a label, the address of the label is filled in after the first pass*/
+typedef struct fixup {
+    const char *name;   /*The name of the operand, kept in the arena*/
+    size_t name_length; /*The number of characters in the name*/
+    int line;           /*The line of the operand*/
+    int slot;           /*The index of the word of the operand in the code image, -1 if it has none*/
+} fixup;
+
+/*This struct holds the label of an .entry line, it is written to the ".ent" file after the first pass*/
+typedef struct entry_request {
+    const char *name;   /*The name of the label, kept in the arena*/
+    size_t name_length; /*The number of characters in the name*/
+    int line;           /*The line of the .entry*/
+} entry_request;
+
+/*This struct holds what the first pass leaves for after all the labels are known, in the order of the lines*/
+typedef struct fixup_list {
+    fixup *fixups;      /*The label operands*/
+    int count;          /*The number of fixups*/
+    int capacity;       /*The number of fixups the array can hold before it grows*/
+    entry_request *entries; /*The .entry requests*/
+    int entry_count;    /*The number of .entry requests*/
+    int entry_capacity; /*The number of .entry requests the array can hold before it grows*/
+    arena *memory;      /*The arena that holds the arrays and the names*/
+} fixup_list;
+
+/*This struct holds a label of a chunk of lines, it is added to the symbol table when the chunks are merged*/
+typedef struct label_definition {
+    const char *name;   /*The name of the label without its ':', it points into the line*/
+    size_t name_length; /*The number of characters in the name*/
+    int address;        /*The address of the label from the start of the code or the data of the chunk*/
+    symbol_kind kind;   /*The kind of the label*/
+    int line;           /*The line of the definition*/
+} label_definition;
+
+/*This struct marks the end of the messages of a line, in messages that were kept for later*/
+typedef struct message_mark {
+    int line;       /*The line*/
+    size_t end;     /*The number of characters of the messages up to the end of the line*/
+} message_mark;
+
+/*This struct holds the first pass over a chunk of lines, the chunks of a file can be read at the same time*/
+typedef struct pass_chunk {
+    char **lines;           /*The lines of the chunk after the pre-assembler, NULL to pull them from the source*/
+    int first_line;         /*The number of the first line of the chunk*/
+    int line_count;         /*The number of lines in the chunk*/
+    int IC;                 /*The instruction counter*/
+    int DC;                 /*The data counter*/
+    memory_image code;      /*The words of the instructions of the chunk*/
+    memory_image data;      /*The words of the data of the chunk*/
+    symbol_table *symbols;  /*The symbol table, or NULL to keep the labels in definitions until the merge*/
+    label_definition *definitions;  /*The labels of the chunk, when they are kept for the merge*/
+    int definition_count;   /*The number of labels kept for the merge*/
+    int definition_capacity;    /*The number of labels the array can hold before it grows*/
+    fixup_list fixups;      /*The label operands and the .entry lines of the chunk*/
+    line_tokens tokens;     /*The tokens of the current line*/
+    diagnostics diag;       /*The messages of the chunk, when it runs next to other chunks*/
+    message_mark *marks;    /*The end of the messages of every line that has messages*/
+    int mark_count;         /*The number of marks*/
+    int mark_capacity;      /*The number of marks the array can hold before it grows*/
+    arena *memory;          /*The arena of the chunk, it holds its images, fixups, labels and marks*/
+    alloc_profile *profile; /*The allocation profile of the file, for the thread that reads the chunk*/
+    int is_valid;           /*0 once an error was found in the chunk*/
+} pass_chunk;
+
 typedef struct type_of_argument{
     char first_char;               /* The first character of the argument type.*/
     int num_of_addressing_method;  /*The number of addressing methods for this argument type*/
@@ -91,11 +498,4 @@ typedef struct addressing_method{
     int target_operand[4];   /*Array of target operand types supported by this addressing method.*/
 }addressing_method;
 
-typedef struct instruction_memory{
-    int address;      /*The memory address where the instruction is located.*/
-    int  line;        /*The line number in the source code where the instruction is defined.*/
-    char *binary_str; /* A string representing the binary encoding of the instruction.*/
-    struct instruction_memory * next; /*Pointer to the next instruction in the linked list.*/
-}instruction_memory;
-
 #endif
\ No newline at end of file
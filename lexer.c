@@ -0,0 +1,214 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+#include "globals.h"
+#include "lexer.h"
+#include "first_pass.h"
+#include "pre_assembler.h"
+
+void init_line_tokens(line_tokens *tokens) {
+	tokens->tokens = NULL;
+	tokens->count = 0;
+	tokens->capacity = 0;
+	tokens->statement = -1;
+	tokens->operands.start = "";
+	tokens->operands.length = 0;
+}
+
+/* returns the number of characters until the next white-space or the end of the line */
+size_t word_length(const char *str) {
+	size_t length = 0;
+	while (str[length] != '\0' && !isspace((unsigned char)str[length])) {
+		length++;
+	}
+	return length;
+}
+
+const char *skip_spaces(const char *str) {
+	while (isspace((unsigned char)*str)) {
+		str++;
+	}
+	return str;
+}
+
+void lex_line(const char *line, line_tokens *tokens) {
+	const char *word = skip_spaces(line);
+	size_t length = word_length(word);
+	token *statement;
+	keyword_kind kind;
+	int index;
+
+	tokens->count = 0;
+	tokens->statement = -1;
+	tokens->operands.start = "";
+	tokens->operands.length = 0;
+	if (length == 0) {
+		return;
+	}
+
+	if (word[length - 1] == ':') {
+		add_token(tokens, TOKEN_LABEL_DEF, word, length, -1);
+		word = skip_spaces(word + length);
+		length = word_length(word);
+		if (length == 0) {
+			return;
+		}
+	}
+
+	tokens->statement = tokens->count;
+	kind = find_keyword(word, length, &index);
+	if (*word == '.') {
+		add_token(tokens, TOKEN_DIRECTIVE, word, length, (kind == KEYWORD_INSTRUCTION) ? index : -1);
+	}
+	else if (kind == KEYWORD_OPCODE) {
+		add_token(tokens, TOKEN_MNEMONIC, word, length, index);
+	}
+	else {
+		add_token(tokens, TOKEN_WORD, word, length, -1);
+	}
+	statement = &tokens->tokens[tokens->statement];
+	word = skip_spaces(word + length);
+
+	if (statement->kind == TOKEN_DIRECTIVE && statement->value == STRING_INSTRUCTION) {
+		/* the string may hold white-spaces and commas, it ends with the line */
+		length = strcspn(word, "\n");
+		add_token(tokens, TOKEN_STRING, word, length, -1);
+	}
+	else {
+		length = word_length(word);
+		lex_operands(tokens, word, length);
+	}
+	tokens->operands.start = word;
+	tokens->operands.length = length;
+}
+
+void add_token(line_tokens *tokens, token_kind kind, const char *start, size_t length, int value) {
+	token *new_token;
+
+	if (tokens->count == tokens->capacity) {
+		tokens->capacity = (tokens->capacity == 0) ? TOKENS_INIT_SIZE : tokens->capacity * 2;
+		tokens->tokens = handle_realloc(tokens->tokens, tokens->capacity * sizeof(token), ALLOC_LINES);
+	}
+	new_token = &tokens->tokens[tokens->count++];
+	new_token->kind = kind;
+	new_token->start = start;
+	new_token->length = length;
+	new_token->value = value;
+}
+
+int number_value(const char *start, size_t length) {
+	char *end;
+	long value;
+
+	errno = 0;
+	value = strtol(start, &end, 10);
+	/* a number too large for an int keeps its sign and is clamped, so it never wraps into a value that fits;
+	 * a number that does not end with its slice is not one number, it is clamped as well */
+	if (end != start + length) {
+		return INT_MAX;
+	}
+	if (errno == ERANGE || value > INT_MAX || value < INT_MIN) {
+		return (value < 0) ? INT_MIN : INT_MAX;
+	}
+	return (int)value;
+}
+
+void lex_operands(line_tokens *tokens, const char *start, size_t length) {
+	const char *end = start + length;
+	const char *comma;
+	size_t operand_length;
+
+	while (start < end) {
+		comma = memchr(start, ',', end - start);
+		operand_length = (comma != NULL) ? (size_t)(comma - start) : (size_t)(end - start);
+
+		if (operand_length > 0) {
+			/* the kind of an operand is known from its first character, as in its addressing method */
+			if (is_integer_slice(start, operand_length)) {
+				add_token(tokens, TOKEN_NUMBER, start, operand_length, number_value(start, operand_length));
+			}
+			else if (*start == '#') {
+				add_token(tokens, TOKEN_IMMEDIATE, start, operand_length, argument_value(start + 1, operand_length - 1));
+			}
+			else if (*start == '*') {
+				add_token(tokens, TOKEN_INDIRECT, start, operand_length, argument_value(start + 1, operand_length - 1));
+			}
+			else if (*start == 'r') {
+				add_token(tokens, TOKEN_REGISTER, start, operand_length, argument_value(start + 1, operand_length - 1));
+			}
+			else {
+				add_token(tokens, TOKEN_LABEL_REF, start, operand_length, -1);
+			}
+		}
+		if (comma == NULL) {
+			break;
+		}
+		add_token(tokens, TOKEN_COMMA, comma, 1, -1);
+		start = comma + 1;
+	}
+}
+
+int check_operand_commas(line_tokens *tokens) {
+	int i;
+	int expect_comma = 0;
+
+	for (i = tokens->statement + 1; i < tokens->count; i++) {
+		/* the tokens must take turns, an operand and then a comma */
+		if ((tokens->tokens[i].kind == TOKEN_COMMA) != expect_comma) {
+			return 0;
+		}
+		expect_comma = !expect_comma;
+	}
+	/* the operands cannot end with a comma */
+	return (i == tokens->statement + 1 || expect_comma);
+}
+
+int count_operands(line_tokens *tokens) {
+	int i;
+	int count = 0;
+	for (i = tokens->statement + 1; i < tokens->count; i++) {
+		if (tokens->tokens[i].kind != TOKEN_COMMA) {
+			count++;
+		}
+	}
+	return count;
+}
+
+int is_integer_slice(const char *start, size_t length) {
+	size_t i = 0;
+
+	/* skip an optional sign */
+	if (length > 0 && (*start == '+' || *start == '-')) {
+		i++;
+	}
+	/* at least one digit must follow the sign */
+	if (i == length) {
+		return 0;
+	}
+	for (; i < length; i++) {
+		if (!isdigit((unsigned char)start[i])) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+int argument_value(const char *start, size_t length) {
+	int reg;
+	if (is_integer_slice(start, length)) {
+		return number_value(start, length);
+	}
+	reg = find_register(start, length);
+	if (reg != -1) {
+		return reg;
+	}
+	return -1;
+}
+
+void free_line_tokens(line_tokens *tokens) {
+	handle_free(tokens->tokens);
+	init_line_tokens(tokens);
+}
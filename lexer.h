@@ -0,0 +1,106 @@
+#ifndef LABRATORY_C_FINAL_PROJECT_LEXER_H
+#define LABRATORY_C_FINAL_PROJECT_LEXER_H
+
+#include "globals.h"
+
+/**
+ * @brief Initializes an empty token array.
+ *
+ * @param tokens The token array to initialize.
+ */
+void init_line_tokens(line_tokens *tokens);
+
+/**
+ * @brief Splits a line into its tokens.
+ *
+ * The line is read once, from left to right. The first word is a label definition if it ends with ':',
+ * the next word is the instruction or the opcode, and the word after it is split on commas into operands.
+ * The text after a .string instruction is kept as a single token. Words after the operands are ignored.
+ * The tokens point into the line, nothing is copied, so they are valid as long as the line is.
+ *
+ * @param line The line to split, after the pre-assembler.
+ * @param tokens The token array that receives the tokens, its previous tokens are dropped.
+ */
+void lex_line(const char *line, line_tokens *tokens);
+
+/**
+ * @brief Adds a token to the end of a token array, the array grows as needed.
+ *
+ * @param tokens The token array.
+ * @param kind The kind of the token.
+ * @param start The first character of the token.
+ * @param length The number of characters in the token.
+ * @param value The value of the token.
+ */
+void add_token(line_tokens *tokens, token_kind kind, const char *start, size_t length, int value);
+
+/**
+ * @brief Splits the operands of a line on commas and adds their tokens.
+ *
+ * A comma token is added for every comma, an empty operand between two commas adds no token.
+ *
+ * @param tokens The token array.
+ * @param start The first character of the operands.
+ * @param length The number of characters in the operands.
+ */
+void lex_operands(line_tokens *tokens, const char *start, size_t length);
+
+/**
+ * @brief Checks that the operands of a line are separated by single commas.
+ *
+ * The operands are valid if they do not start or end with a comma and no two commas follow each other.
+ * A line without operands is valid.
+ *
+ * @param tokens The tokens of the line.
+ * @return 1 if the commas are valid, 0 otherwise.
+ */
+int check_operand_commas(line_tokens *tokens);
+
+/**
+ * @brief Counts the operands of a line, without the commas.
+ *
+ * @param tokens The tokens of the line.
+ * @return The number of operands.
+ */
+int count_operands(line_tokens *tokens);
+
+/**
+ * @brief Checks if a slice of a line is a whole number, with an optional '+' or '-' sign.
+ *
+ * @param start The first character of the slice.
+ * @param length The number of characters in the slice.
+ * @return 1 if the slice is a whole number, 0 otherwise.
+ */
+int is_integer_slice(const char *start, size_t length);
+
+/**
+ * @brief Reads a number that is_integer_slice accepted.
+ *
+ * A number that does not fit in an int becomes INT_MAX, or INT_MIN if it is negative, so the checks
+ * of the range of a word reject it instead of a value that wrapped around.
+ *
+ * @param start The first character of the number, its sign or its first digit.
+ * @param length The number of characters in the number.
+ * @return The value of the number.
+ */
+int number_value(const char *start, size_t length);
+
+/**
+ * @brief Finds the value of the part of an operand after its first character.
+ *
+ * The value of a number is the number itself, and the value of a register is its number.
+ *
+ * @param start The first character after the first character of the operand.
+ * @param length The number of characters left in the operand.
+ * @return The value, or -1 if the part is neither a number nor a register.
+ */
+int argument_value(const char *start, size_t length);
+
+/**
+ * @brief Releases the memory of a token array.
+ *
+ * @param tokens The token array to free.
+ */
+void free_line_tokens(line_tokens *tokens);
+
+#endif
@@ -0,0 +1,110 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "globals.h"
+#include "libassembler.h"
+#include "pre_assembler.h"
+#include "first_pass.h"
+#include "report.h"
+#include "stats.h"
+
+void init_assembly_result(assembly_result *result) {
+	int i;
+
+	for (i = 0; i < CACHED_ENDINGS_COUNT; i++) {
+		init_buffer(&result->outputs[i]);
+		result->has_output[i] = 0;
+	}
+	init_diagnostics(&result->diag);
+	result->messages = NULL;
+	result->message_count = 0;
+	result->message_capacity = 0;
+	result->is_valid = 0;
+	init_assembly_stats(&result->stats);
+}
+
+/* empties a result, its buffers keep their memory for the next source */
+static void clear_assembly_result(assembly_result *result) {
+	int i;
+
+	for (i = 0; i < CACHED_ENDINGS_COUNT; i++) {
+		result->outputs[i].length = 0;
+		result->has_output[i] = 0;
+	}
+	result->diag.out.length = 0;
+	result->diag.err.length = 0;
+	result->diag.out_lines.count = 0;
+	result->diag.err_lines.count = 0;
+	result->message_count = 0;
+	result->is_valid = 0;
+	init_assembly_stats(&result->stats);
+}
+
+/* adds every line of a buffer of messages to the messages of a result, with the line it was reported with */
+static void split_messages(assembly_result *result, byte_buffer *buffer, int is_error) {
+	message_lines *lines = is_error ? &result->diag.err_lines : &result->diag.out_lines;
+	assembly_message *message;
+	size_t start = 0;
+	const char *end;
+	int next = 0;
+
+	while (start < buffer->length) {
+		if (result->message_count == result->message_capacity) {
+			result->message_capacity = (result->message_capacity == 0) ? FIXUPS_INIT_SIZE : result->message_capacity * 2;
+			result->messages = handle_realloc(result->messages, result->message_capacity * sizeof(assembly_message), ALLOC_MESSAGES);
+		}
+		end = memchr(buffer->data + start, '\n', buffer->length - start);
+		message = &result->messages[result->message_count++];
+		message->is_error = is_error;
+		message->text = buffer->data + start;
+		message->length = (end != NULL) ? (size_t)(end - message->text) : buffer->length - start;
+		/* the lines are kept in the order of the messages, the ones of a message without '\n' are skipped */
+		while (next < lines->count && lines->lines[next].start < start) {
+			next++;
+		}
+		message->line = 0;
+		if (next < lines->count && lines->lines[next].start <= start + message->length) {
+			message->line = lines->lines[next++].line;
+		}
+		start += message->length + 1;
+	}
+}
+
+int assemble_source(const char *text, size_t length, assembler_options *options, arena *memory, assembly_result *result) {
+	diagnostics *outer = captured_reports();
+	macro_table macros;
+	line_source source;
+
+	clear_assembly_result(result);
+	/* the messages of the passes are kept in the result, they are printed only by the caller */
+	capture_reports(&result->diag);
+	implement_macro(text, length, &source, &macros, options, memory, options->emit_am ? &result->outputs[OUTPUT_AM] : NULL);
+	if (options->stats != STATS_OFF) {
+		source.stats = &result->stats;
+		result->stats.bytes_read = (long)length;
+	}
+	result->is_valid = implement_first_pass(&source, options, result);
+	if (source.stats != NULL) {
+		result->stats.source_lines = source.source_line;
+		result->stats.macros = macros.count;
+	}
+	/* the .am file is kept only for a source without pre-assembler errors */
+	result->has_output[OUTPUT_AM] = options->emit_am && source.is_valid;
+	close_line_source(&source);
+	capture_reports(outer);
+
+	split_messages(result, &result->diag.out, 0);
+	split_messages(result, &result->diag.err, 1);
+	return result->is_valid;
+}
+
+void free_assembly_result(assembly_result *result) {
+	int i;
+
+	for (i = 0; i < CACHED_ENDINGS_COUNT; i++) {
+		free_buffer(&result->outputs[i]);
+	}
+	free_diagnostics(&result->diag);
+	handle_free(result->messages);
+	init_assembly_result(result);
+}
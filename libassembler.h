@@ -0,0 +1,41 @@
+#ifndef LABRATORY_C_FINAL_PROJECT_LIBASSEMBLER_H
+#define LABRATORY_C_FINAL_PROJECT_LIBASSEMBLER_H
+
+#include "globals.h"
+
+/**
+ * @brief Initializes an empty result of an assembly.
+ *
+ * @param result The result to initialize.
+ */
+void init_assembly_result(assembly_result *result);
+
+/**
+ * @brief Assembles a source that is held in memory, without reading or writing any file.
+ *
+ * The source runs through the pre-assembler and both passes as a ".as" file would. The content of the
+ * ".am" (with emit_am in the options), ".ob", ".ent", ".ext" and ".obb" (with emit_obb) files is left in the outputs of the result,
+ * and has_output tells which of them the assembler would have written. The messages are kept in the result as
+ * they would be printed, and one by one with the line they were reported with. The result is emptied first, so one result
+ * can take the sources one after the other and its buffers are allocated only while they grow.
+ *
+ * Nothing in the assembly is shared, sources of different arenas and results can be assembled at the same time.
+ *
+ * @param text The content of the source, it does not have to end with '\0'.
+ * @param length The number of characters in the source.
+ * @param options The options of the assembler: emit_am, emit_obb, max_line_length, pass_threads and stats are used.
+ *                With stats, the times of the stages and the counts are kept in the stats of the result.
+ * @param memory The arena that holds the macros, the labels and the images. It can be reset once the function returns.
+ * @param result The result that receives the output files and the messages.
+ * @return 1 if the source was assembled without errors, 0 otherwise.
+ */
+int assemble_source(const char *text, size_t length, assembler_options *options, arena *memory, assembly_result *result);
+
+/**
+ * @brief Releases the buffers and the messages of a result, and leaves it empty.
+ *
+ * @param result The result to free.
+ */
+void free_assembly_result(assembly_result *result);
+
+#endif
@@ -0,0 +1,198 @@
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include "globals.h"
+#include "normalize.h"
+
+/* The vector kernels need the GCC target attributes and the x86 intrinsics, on other
+ * compilers and processors only the scalar kernel is built. */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define NORMALIZE_X86
+#include <immintrin.h>
+#endif
+
+/* Copies the characters at the start of the line up to the first special character,
+ * and returns their number. It may write up to len characters to dest. */
+typedef size_t (*run_copier)(const char *line, size_t len, char *dest);
+
+static run_copier copy_run = NULL;
+static normalize_kernel kernel_in_use = NORMALIZE_AUTO;
+static pthread_once_t kernel_once = PTHREAD_ONCE_INIT;
+
+/* Number of characters of a run that are copied one at a time before the vector kernels start,
+ * most runs (numbers, registers and short labels) end before it */
+#define SHORT_RUN_LENGTH 16
+
+/* the characters that end a run: the white-spaces, '\n' (between '\t' and '\r') and ',' */
+static int is_special(char c) {
+	return (c >= '\t' && c <= '\r') || c == ' ' || c == ',';
+}
+
+static int is_blank(char c) {
+	return c != '\n' && c != ',' && is_special(c);
+}
+
+static size_t copy_run_scalar(const char *line, size_t len, char *dest) {
+	size_t i = 0;
+	while (i < len && !is_special(line[i])) {
+		dest[i] = line[i];
+		i++;
+	}
+	return i;
+}
+
+#ifdef NORMALIZE_X86
+__attribute__((target("sse2")))
+static size_t copy_run_sse2(const char *line, size_t len, char *dest) {
+	__m128i before_tab, after_cr, space, comma;
+	__m128i chars, special;
+	unsigned int mask;
+	size_t i = copy_run_scalar(line, (len < SHORT_RUN_LENGTH) ? len : SHORT_RUN_LENGTH, dest);
+
+	if (i < SHORT_RUN_LENGTH) {
+		return i;
+	}
+	/* the constants are set only for a long run, they take many instructions in a build without optimization */
+	before_tab = _mm_set1_epi8('\t' - 1);
+	after_cr = _mm_set1_epi8('\r' + 1);
+	space = _mm_set1_epi8(' ');
+	comma = _mm_set1_epi8(',');
+	while (i + 16 <= len) {
+		chars = _mm_loadu_si128((const __m128i *)(line + i));
+		/* the whole block is stored, the characters after the run are overwritten later */
+		_mm_storeu_si128((__m128i *)(dest + i), chars);
+		special = _mm_or_si128(_mm_and_si128(_mm_cmpgt_epi8(chars, before_tab), _mm_cmplt_epi8(chars, after_cr)),
+			_mm_or_si128(_mm_cmpeq_epi8(chars, space), _mm_cmpeq_epi8(chars, comma)));
+		mask = (unsigned int)_mm_movemask_epi8(special);
+		if (mask != 0) {
+			return i + (size_t)__builtin_ctz(mask);
+		}
+		i += 16;
+	}
+	return i + copy_run_scalar(line + i, len - i, dest + i);
+}
+
+__attribute__((target("avx2")))
+static size_t copy_run_avx2(const char *line, size_t len, char *dest) {
+	__m256i before_tab, after_cr, space, comma;
+	__m256i chars, special;
+	unsigned int mask;
+	size_t i = copy_run_scalar(line, (len < SHORT_RUN_LENGTH) ? len : SHORT_RUN_LENGTH, dest);
+
+	if (i < SHORT_RUN_LENGTH) {
+		return i;
+	}
+	/* set only for a long run, as in copy_run_sse2 */
+	before_tab = _mm256_set1_epi8('\t' - 1);
+	after_cr = _mm256_set1_epi8('\r' + 1);
+	space = _mm256_set1_epi8(' ');
+	comma = _mm256_set1_epi8(',');
+	while (i + 32 <= len) {
+		chars = _mm256_loadu_si256((const __m256i *)(line + i));
+		/* the whole block is stored, the characters after the run are overwritten later */
+		_mm256_storeu_si256((__m256i *)(dest + i), chars);
+		special = _mm256_or_si256(_mm256_and_si256(_mm256_cmpgt_epi8(chars, before_tab), _mm256_cmpgt_epi8(after_cr, chars)),
+			_mm256_or_si256(_mm256_cmpeq_epi8(chars, space), _mm256_cmpeq_epi8(chars, comma)));
+		mask = (unsigned int)_mm256_movemask_epi8(special);
+		if (mask != 0) {
+			return i + (size_t)__builtin_ctz(mask);
+		}
+		i += 32;
+	}
+	/* the rest of the line is left to the scalar kernel, calling the SSE2 kernel here
+	 * would mix AVX and SSE instructions, which is slow on many processors */
+	return i + copy_run_scalar(line + i, len - i, dest + i);
+}
+#endif
+
+normalize_kernel select_normalize_kernel(normalize_kernel requested) {
+	normalize_kernel best = NORMALIZE_SCALAR;
+
+#ifdef NORMALIZE_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("sse2")) {
+		best = NORMALIZE_SSE2;
+		if (__builtin_cpu_supports("avx2")) {
+			best = NORMALIZE_AVX2;
+		}
+	}
+#endif
+	if (requested == NORMALIZE_AUTO || requested > best) {
+		requested = best;
+	}
+	kernel_in_use = requested;
+	copy_run = copy_run_scalar;
+#ifdef NORMALIZE_X86
+	if (requested == NORMALIZE_SSE2) {
+		copy_run = copy_run_sse2;
+	}
+	else if (requested == NORMALIZE_AVX2) {
+		copy_run = copy_run_avx2;
+	}
+#endif
+	return kernel_in_use;
+}
+
+const char *normalize_kernel_name(normalize_kernel kernel) {
+	switch (kernel) {
+	case NORMALIZE_SSE2:
+		return "sse2";
+	case NORMALIZE_AVX2:
+		return "avx2";
+	default:
+		return "scalar";
+	}
+}
+
+/* chooses the fastest kernel, unless one was chosen before */
+static void select_default_kernel(void) {
+	if (copy_run == NULL) {
+		select_normalize_kernel(NORMALIZE_AUTO);
+	}
+}
+
+void remove_extra_spaces_str(const char *line, size_t len, char *dest) {
+	size_t i = 0, j = 0, run;
+	int pending_space = 0;
+	int join_commas;
+	char c;
+
+	/* the threads that normalize lines at the same time choose the kernel once */
+	pthread_once(&kernel_once, select_default_kernel);
+	/* a comment line is left empty */
+	if (len > 0 && *line == ';') {
+		strcpy(dest, "\n");
+		return;
+	}
+	/* eliminating white-spaces in the beginning of the line */
+	while (i < len && is_blank(line[i])) {
+		i++;
+	}
+	/* the spaces next to the commas are kept when the line starts with a comma */
+	join_commas = !(i < len && line[i] == ',');
+
+	/* the output is never ahead of the input, so a kernel can write up to the end of the line in dest */
+	while (i < len) {
+		if (!pending_space) {
+			run = copy_run(line + i, len - i, dest + j);
+			i += run;
+			j += run;
+			if (i == len) {
+				break;
+			}
+		}
+		c = line[i++];
+		if (is_blank(c)) {
+			pending_space = 1;
+			continue;
+		}
+		/* one space for the skipped white-spaces, unless they end the line or touch a comma */
+		if (pending_space && c != '\n' && !(join_commas && (c == ',' || dest[j - 1] == ','))) {
+			dest[j++] = ' ';
+		}
+		pending_space = 0;
+		dest[j++] = c;
+	}
+	dest[j] = '\0';
+}
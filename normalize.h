@@ -0,0 +1,43 @@
+#ifndef LABRATORY_C_FINAL_PROJECT_NORMALIZE_H
+#define LABRATORY_C_FINAL_PROJECT_NORMALIZE_H
+
+#include <stddef.h>
+#include "globals.h"
+
+/**
+ * @brief Copies a line without the extra unnecessary white-spaces.
+ *
+ * The line is read once, from left to right. The white-spaces at its start and end are dropped,
+ * every other run of white-spaces becomes a single space, and the spaces next to a comma are dropped,
+ * unless the line starts with a comma. A comment line, starting with ';', becomes an empty line.
+ * The runs of characters between the white-spaces and the commas are copied with the vector
+ * instructions of the processor when it has them.
+ *
+ * @param line The characters of the line, not necessarily null terminated.
+ * @param len The number of characters in the line.
+ * @param dest The buffer that receives the line, it must have room for len + 2 characters.
+ */
+void remove_extra_spaces_str(const char *line, size_t len, char *dest);
+
+/**
+ * @brief Chooses the kernel that copies the runs of characters of a line.
+ *
+ * The kernel is chosen once, on the first call to remove_extra_spaces_str from any thread, if it was
+ * not chosen before. Another kernel must be chosen before the threads that normalize lines start.
+ * A kernel the processor does not support is replaced by the best one it supports, all of them
+ * produce the same lines.
+ *
+ * @param requested The kernel to use, or NORMALIZE_AUTO for the fastest one the processor supports.
+ * @return The kernel that is used from now on.
+ */
+normalize_kernel select_normalize_kernel(normalize_kernel requested);
+
+/**
+ * @brief Returns the name of a kernel, for reports.
+ *
+ * @param kernel The kernel.
+ * @return Its name: "scalar", "sse2" or "avx2".
+ */
+const char *normalize_kernel_name(normalize_kernel kernel);
+
+#endif
@@ -0,0 +1,197 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "globals.h"
+#include "binary_object.h"
+#include "pre_assembler.h"
+#include "file_reader.h"
+
+/* Converts the object files of the assembler between the text files (".ob", ".ent" and ".ext") and the
+ * binary object file (".obb"), in both directions, and checks that a round trip gives the same files. */
+
+/* The text object files, in the order of the buffers of binary_object_to_text */
+enum text_file { TEXT_OB, TEXT_ENT, TEXT_EXT, TEXT_FILES_COUNT };
+
+static char *TEXT_ENDINGS[TEXT_FILES_COUNT] = { ".ob", ".ent", ".ext" };
+
+static int write_file(char *file_name, byte_buffer *content) {
+	FILE *fp = fopen(file_name, "wb");
+	int ok = (fp != NULL && fwrite(content->data, 1, content->length, fp) == content->length);
+
+	if (fp != NULL && fclose(fp) != 0) {
+		ok = 0;
+	}
+	if (!ok) {
+		fprintf(stderr, "Failed to write file: %s\n", file_name);
+	}
+	return ok;
+}
+
+/* maps the text object files of a source, the ".ent" and ".ext" files may be missing */
+static int open_text_files(char *name, input_file *inputs) {
+	char *file_name;
+	int i, ok = 1;
+
+	for (i = 0; i < TEXT_FILES_COUNT; i++) {
+		file_name = add_new_file(name, TEXT_ENDINGS[i]);
+		if (!open_input(file_name, &inputs[i])) {
+			if (i == TEXT_OB) {
+				fprintf(stderr, "Error opening file: %s\n", file_name);
+				ok = 0;
+			}
+			inputs[i].data = NULL;
+			inputs[i].size = 0;
+			inputs[i].is_mapped = 0;
+			inputs[i].is_borrowed = 1;
+		}
+		handle_free(file_name);
+	}
+	return ok;
+}
+
+static void close_text_files(input_file *inputs) {
+	int i;
+
+	for (i = 0; i < TEXT_FILES_COUNT; i++) {
+		close_input(&inputs[i]);
+	}
+}
+
+static int text_to_binary(char *name, input_file *inputs, byte_buffer *binary) {
+	if (!text_to_binary_object(inputs[TEXT_OB].data, inputs[TEXT_OB].size, inputs[TEXT_ENT].data, inputs[TEXT_ENT].size,
+		inputs[TEXT_EXT].data, inputs[TEXT_EXT].size, binary)) {
+		fprintf(stderr, "%s: the text object files are not in the format of the assembler\n", name);
+		return 0;
+	}
+	return 1;
+}
+
+/* writes the ".obb" file of the text object files */
+static int convert_to_binary(char *name) {
+	input_file inputs[TEXT_FILES_COUNT];
+	byte_buffer binary;
+	char *file_name;
+	int ok;
+
+	init_buffer(&binary);
+	ok = open_text_files(name, inputs) && text_to_binary(name, inputs, &binary);
+	if (ok) {
+		file_name = add_new_file(name, ".obb");
+		ok = write_file(file_name, &binary);
+		handle_free(file_name);
+	}
+	close_text_files(inputs);
+	free_buffer(&binary);
+	return ok;
+}
+
+/* writes the text object files of the ".obb" file, an empty ".ent" or ".ext" file is removed as the assembler does */
+static int convert_to_text(char *name) {
+	input_file input;
+	binary_object object;
+	byte_buffer texts[TEXT_FILES_COUNT];
+	char *file_name;
+	int i, ok = 1;
+
+	file_name = add_new_file(name, ".obb");
+	if (!open_input(file_name, &input)) {
+		fprintf(stderr, "Error opening file: %s\n", file_name);
+		handle_free(file_name);
+		return 0;
+	}
+	if (!map_binary_object(input.data, input.size, &object)) {
+		fprintf(stderr, "%s: not a binary object file\n", file_name);
+		close_input(&input);
+		handle_free(file_name);
+		return 0;
+	}
+	handle_free(file_name);
+	for (i = 0; i < TEXT_FILES_COUNT; i++) {
+		init_buffer(&texts[i]);
+	}
+	binary_object_to_text(&object, &texts[TEXT_OB], &texts[TEXT_ENT], &texts[TEXT_EXT]);
+	for (i = 0; i < TEXT_FILES_COUNT; i++) {
+		file_name = add_new_file(name, TEXT_ENDINGS[i]);
+		if (i == TEXT_OB || texts[i].length > 0) {
+			ok = write_file(file_name, &texts[i]) && ok;
+		}
+		else {
+			remove(file_name);
+		}
+		handle_free(file_name);
+		free_buffer(&texts[i]);
+	}
+	close_input(&input);
+	return ok;
+}
+
+/* converts the text object files to binary and back, and compares both with the files on the disk */
+static int check_round_trip(char *name) {
+	input_file inputs[TEXT_FILES_COUNT], obb;
+	binary_object object;
+	byte_buffer binary, texts[TEXT_FILES_COUNT];
+	char *file_name;
+	int i, ok;
+
+	init_buffer(&binary);
+	for (i = 0; i < TEXT_FILES_COUNT; i++) {
+		init_buffer(&texts[i]);
+	}
+	ok = open_text_files(name, inputs) && text_to_binary(name, inputs, &binary);
+	if (ok && !map_binary_object(binary.data, binary.length, &object)) {
+		fprintf(stderr, "%s: the converted binary object file cannot be mapped\n", name);
+		ok = 0;
+	}
+	if (ok) {
+		binary_object_to_text(&object, &texts[TEXT_OB], &texts[TEXT_ENT], &texts[TEXT_EXT]);
+		for (i = 0; i < TEXT_FILES_COUNT; i++) {
+			if (texts[i].length != inputs[i].size || (texts[i].length > 0 && memcmp(texts[i].data, inputs[i].data, texts[i].length) != 0)) {
+				fprintf(stderr, "%s: the %s file differs after a round trip through the binary object file\n", name, TEXT_ENDINGS[i]);
+				ok = 0;
+			}
+		}
+	}
+	/* the ".obb" file of the assembler has to be the same as the converted one */
+	file_name = add_new_file(name, ".obb");
+	if (ok && open_input(file_name, &obb)) {
+		if (obb.size != binary.length || memcmp(obb.data, binary.data, binary.length) != 0) {
+			fprintf(stderr, "%s: differs from the conversion of the text object files\n", file_name);
+			ok = 0;
+		}
+		close_input(&obb);
+	}
+	handle_free(file_name);
+	if (ok) {
+		printf("%s: round trip ok, %ld code words, %ld data words, %ld entries, %ld externals\n", name,
+			object.IC - object.base, object.DC, object.entry_count, object.extern_count);
+	}
+	close_text_files(inputs);
+	for (i = 0; i < TEXT_FILES_COUNT; i++) {
+		free_buffer(&texts[i]);
+	}
+	free_buffer(&binary);
+	return ok;
+}
+
+int main(int argc, char *argv[]) {
+	int (*convert)(char *) = NULL;
+	int i, ok = 1;
+
+	if (argc > 1 && strcmp(argv[1], "--to-binary") == 0) {
+		convert = convert_to_binary;
+	}
+	else if (argc > 1 && strcmp(argv[1], "--to-text") == 0) {
+		convert = convert_to_text;
+	}
+	else if (argc > 1 && strcmp(argv[1], "--check") == 0) {
+		convert = check_round_trip;
+	}
+	if (convert == NULL || argc < 3) {
+		fprintf(stderr, "usage: %s --to-binary|--to-text|--check FILE... (the names of the files without their extension)\n", argv[0]);
+		return 1;
+	}
+	for (i = 2; i < argc; i++) {
+		ok = convert(argv[i]) && ok;
+	}
+	return ok ? 0 : 1;
+}
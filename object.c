@@ -0,0 +1,72 @@
+#include <stdio.h>
+#include <string.h>
+#include "globals.h"
+#include "object.h"
+#include "pre_assembler.h"
+
+/* the first line: three spaces, two numbers of up to 11 characters, a space and '\n' */
+#define OBJECT_HEADER_MAX 32
+
+/* a line of a word: an address of up to 10 digits, a space, 5 octal digits and '\n' */
+#define OBJECT_LINE_MAX 17
+
+/* writes an address with at least 4 digits, padded with zeros like "%04u" */
+static char *put_address(char *out, unsigned int address) {
+	char digits[12];
+	int count = 0;
+
+	do {
+		digits[count++] = (char)('0' + address % 10);
+		address /= 10;
+	} while (address > 0);
+	while (count < 4) {
+		digits[count++] = '0';
+	}
+	while (count > 0) {
+		*out++ = digits[--count];
+	}
+	return out;
+}
+
+/* writes a line of a word, its value is 5 octal digits like "%05o" */
+static char *put_word(char *out, int address, unsigned short word) {
+	int shift;
+
+	out = put_address(out, (unsigned int)address);
+	*out++ = ' ';
+	if (word == UNRESOLVED_WORD) {
+		memcpy(out, "00001", 5);
+		out += 5;
+	}
+	else {
+		for (shift = 12; shift >= 0; shift -= 3) {
+			*out++ = (char)('0' + ((word >> shift) & 7));
+		}
+	}
+	*out++ = '\n';
+	return out;
+}
+
+size_t object_size_bound(memory_image *code, memory_image *data) {
+	return OBJECT_HEADER_MAX + (size_t)(code->count + data->count) * OBJECT_LINE_MAX;
+}
+
+size_t render_object(memory_image *code, memory_image *data, int IC, int DC, char *out) {
+	char *end = out;
+	int i;
+
+	end += sprintf(end, "   %d %d\n", IC - IC_INIT_VALUE, DC);
+	for (i = 0; i < code->count; i++) {
+		end = put_word(end, code->base + i, code->words[i]);
+	}
+	/* the data is placed after the code */
+	for (i = 0; i < data->count; i++) {
+		end = put_word(end, IC + data->base + i, data->words[i]);
+	}
+	return (size_t)(end - out);
+}
+
+void append_object(memory_image *code, memory_image *data, int IC, int DC, byte_buffer *out) {
+	reserve_buffer(out, out->length + object_size_bound(code, data));
+	out->length += render_object(code, data, IC, DC, out->data + out->length);
+}
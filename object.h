@@ -0,0 +1,44 @@
+#ifndef LABRATORY_C_FINAL_PROJECT_OBJECT_H
+#define LABRATORY_C_FINAL_PROJECT_OBJECT_H
+
+#include "globals.h"
+
+/**
+ * @brief Returns the most characters the object file of two images can take.
+ *
+ * @param code The instruction image.
+ * @param data The data image.
+ * @return The size of a buffer that can hold the whole object file.
+ */
+size_t object_size_bound(memory_image *code, memory_image *data);
+
+/**
+ * @brief Writes the object file of two images into a buffer, as text.
+ *
+ * The first line holds the number of code words and of data words, and every word follows on its own line
+ * with its address (at least 4 decimal digits) and its value (5 octal digits). The data is placed after the code.
+ * A word whose label address is missing is written as 00001.
+ *
+ * @param code The instruction image.
+ * @param data The data image.
+ * @param IC The instruction counter after the first pass, the address of the first data word.
+ * @param DC The data counter after the first pass.
+ * @param out The buffer, with room for object_size_bound characters.
+ * @return The number of characters written.
+ */
+size_t render_object(memory_image *code, memory_image *data, int IC, int DC, char *out);
+
+/**
+ * @brief Appends the ".ob" file of two images to a buffer.
+ *
+ * The buffer grows once to object_size_bound characters and the file is rendered straight into it.
+ *
+ * @param code The instruction image.
+ * @param data The data image.
+ * @param IC The instruction counter after the first pass.
+ * @param DC The data counter after the first pass.
+ * @param out The buffer that receives the ".ob" file.
+ */
+void append_object(memory_image *code, memory_image *data, int IC, int DC, byte_buffer *out);
+
+#endif
@@ -3,54 +3,31 @@
 #include <string.h>
 #include "globals.h"
 #include "pre_assembler.h"
-
-int implement_macro(char file_name[],node **head) { 
-    
-    char *new_file1, *new_file2, *final_file, *temp_file_name1, *temp_file_name2;
-    new_file1 = remove_extra_spaces_file(file_name);
-    if (new_file1 == NULL) {
-        return 0;
-    }
-
-    
-
-    if (!add_macro(new_file1, head)) {
-        free_list(*head);
-        remove(new_file1);
-        free(new_file1);
-        return 0;
-    }
-
-    new_file2 = remove_mcros_decl(new_file1);
-    if (new_file2 == NULL) {
-        free_list(*head);
-        remove(new_file1);
-        free(new_file1);
-        return 0;
-    }
-
-    free(new_file1);
-
-    final_file = replace_all_mcros(new_file2, *head);
-    if (final_file == NULL) {
-        free_list(*head);
-        remove(new_file2);
-        free(new_file2);
-        return 0;
-    }
-   
-   
-    temp_file_name1 = add_new_file(file_name, ".t01");
-    temp_file_name2 = add_new_file(file_name, ".t02");
-    remove(temp_file_name1);
-    remove(temp_file_name2);
-
-    free(temp_file_name1);
-    free(temp_file_name2);
- 
-    free(new_file2);
-    free(final_file);
-    free_list(*head);
-
-    return 1;
-}
\ No newline at end of file
+#include "reader.h"
+
+void implement_macro(const char *text, size_t length, line_source *source, macro_table *macros, assembler_options *options, arena *memory, byte_buffer *am_text) {
+    open_input_text(text, length, &source->input);
+    source->am_text = am_text;
+    source->memory = memory;
+    source->macros = macros;
+    init_macro_table(macros, memory);
+    source->macro_name = NULL;
+    init_buffer(&source->macro_content);
+    init_buffer(&source->line);
+    reserve_buffer(&source->line, BUFFER_INIT_SIZE);
+    source->max_line_length = options->max_line_length;
+    source->macro_line = 0;
+    source->in_macro_decl = 0;
+    source->expansion = NULL;
+    source->source_line = 0;
+    source->is_valid = 1;
+    source->stats = NULL;
+}
+
+void close_line_source(line_source *source) {
+    close_input_text(&source->input);
+    source->am_text = NULL;
+    source->macro_name = NULL;
+    free_buffer(&source->macro_content);
+    free_buffer(&source->line);
+}
@@ -2,49 +2,87 @@
 #include <stdbool.h>
 
 /**
- * @brief Implements macro substitution in a given file.
+ * @brief Starts the pre-assembler on a source in memory.
+ *
+ * The pre-assembler does not rewrite the source. The source is read by the first pass through
+ * next_line, which removes extra spaces, skips macro declarations and expands macro calls on the fly.
+ * If a buffer is given, the expanded lines are also copied to it, as the content of the ".am" file.
+ *
+ * @param text The content of the source (.as) file, it must stay unchanged until the line source is closed.
+ * @param length The number of characters in the source.
+ * @param source The line source to initialize.
+ * @param macros The macro table where the macros will be saved.
+ * @param options The options of the assembler: the limit on the length of a line.
+ * @param memory The arena of the file, it holds the macros and later the labels and the memory images.
+ * @param am_text The buffer that receives the expanded lines, or NULL if they are not kept.
+ */
+void implement_macro(const char *text, size_t length, line_source *source, macro_table *macros, assembler_options *options, arena *memory, byte_buffer *am_text);
+
+
+/**
+ * @brief Closes a line source started by implement_macro.
  *
- * This function performs the following steps to process macros in the file:
- * 1. Removes extra spaces from the file.
- * 2. Adds macro definitions to a linked list.
- * 3. Removes macro declarations from the file.
- * 4. Replaces macro occurrences with their definitions.
- * 5. Cleans up temporary files and memory.
+ * The macros are left in the arena of the file, which is reset once the file is done.
  *
- * @param file_name The name of the input file to process.
- * @return int Returns 1 if the macro implementation is successful, otherwise returns 0.
+ * @param source The line source to close.
  */
-int implement_macro(char file_name[],node **head);
+void close_line_source(line_source *source);
 
 
 /**
- * This function removes all extra unnecessary white spaces from the file
- * @param file_name string of the input file name
- * @return string the name of the new file after white spaces removed
+ * @brief Reads the next line of the source after the pre-assembler.
+ *
+ * This function takes the lines of the mapped source file one by one, removes extra white-spaces, replaces
+ * the lines of macro declarations with empty lines and returns the content of a macro instead of its call.
+ * Errors in macro declarations are printed and mark the source as not valid.
+ *
+ * @param source The line source to read from.
+ * @return A pointer to the line, which is valid until the next call and must not be changed,
+ *         or NULL at the end of the file or if a line is longer than the limit in the options. The lines of an expanded macro
+ *         point into the content of the macro.
  */
-char* remove_extra_spaces_file(char file_name[]);
+char *next_line(line_source *source);
 
 
 /**
- * This function removes extra unnecessary white-spaces from a string
- * @param str string to change
+ * @brief Checks if a line starts a macro declaration.
+ *
+ * @param line The line after the extra spaces were removed.
+ * @return int Returns 1 if the first word of the line is "macr", otherwise returns 0.
  */
-void remove_extra_spaces_str(char *str);
+int is_macro_decl(char *line);
 
 
 /**
- * This function checks of a character is a ' ' or '\t'
- * @param c character to check
- * @return 1 if the character is either ' ' or '\t', 0 if not
+ * @brief Checks if only white-spaces are left in a line.
+ *
+ * @param str The rest of the line.
+ * @return int Returns 1 if there are no more words in the line, otherwise returns 0.
  */
-int is_space_or_tab(char c);
+int is_end_of_words(const char *str);
 
 
 /**
- * This function removes white-spaces next to a comma
- * @param str string to change
+ * @brief Handles a line that belongs to a macro declaration.
+ *
+ * On a "macr" line the macro name is checked and a new macro is started. The lines after it are
+ * appended to the content of the macro, each one followed by '\0', and the "endmacr" line adds
+ * the macro to the macro table.
+ *
+ * @param source The line source that is being read.
+ * @param line The line after the extra spaces were removed.
+ */
+void handle_macro_decl_line(line_source *source, char *line);
+
+
+/**
+ * @brief Checks if a line is a macro call and starts its expansion.
+ *
+ * @param source The line source that is being read.
+ * @param line The line after the extra spaces were removed.
+ * @return int Returns 1 if the line is a call of a macro defined above it, otherwise returns 0.
  */
-void remove_spaces_next_to_comma(char *str);
+int start_macro_call(line_source *source, char *line);
 
 
 /**
@@ -71,198 +109,179 @@ int is_valid_macro_name(char *as_file );
 
 
 /**
- * @brief Checks if a string matches a known instruction.
+ * @brief Classifies a name as an opcode, an instruction, a register or none of them.
  *
- * This function compares the given string to a list of known instructions. If a match is found,
- * the function returns 1. If no match is found or if the input string is NULL, the function returns 0.
- *
- * @param str A pointer to the string to be checked.
- * @return 1 if the string matches a known instruction, or 0 if the string is not a valid instruction or is NULL.
+ * @param name The name to look for, it does not have to end with '\0'.
+ * @param length The number of characters in the name.
+ * @param index Receives the index of the opcode or the instruction, or the number of the register.
+ * @return The kind of the reserved word, or KEYWORD_NONE if the name is not reserved.
  */
-int instr_detection(char *str);
+keyword_kind find_keyword(const char *name, size_t length, int *index);
 
 
 /**
- * @brief Checks if a string matches a known opcode.
- *
- * This function compares the given string to a list of known opcodes. If a match is found,
- * the function returns 1. If no match is found or if the input string is NULL, the function returns 0.
+ * @brief Finds the instruction with a given name.
  *
- * @param str A pointer to the string to be checked.
- * @return 1 if the string matches a known opcode, or 0 if the string is not a valid opcode or is NULL.
+ * @param name The name to look for, it does not have to end with '\0'.
+ * @param length The number of characters in the name.
+ * @return The index of the instruction, or -1 if there is none.
  */
-int opcode_detection(char *str);
+int find_instruction(const char *name, size_t length);
 
 
 /**
- * @brief Detects if a string corresponds to a known register and returns its number.
- *
- * This function checks if the provided string matches one of the known register names.
- * If the string matches a register, the function returns the register number. It returns
- * `0` if the string does not correspond to a valid register.
- *
- * The function compares the input string with a list of known registers. If a match is found,
- * the register number associated with the matched register is returned. If no match is found,
- * the function returns `0`.
+ * @brief Finds the opcode with a given name.
  *
- * @param str The string to be checked.
- * @return The number of the register if a match is found, `0` otherwise.
+ * @param name The name to look for, it does not have to end with '\0'.
+ * @param length The number of characters in the name.
+ * @return The index of the opcode, or -1 if there is none.
  */
-int reg_detection(char *str);
-
-/**
- * @brief Checks if a string contains more than one token when split by spaces.
- *
- * This function examines a string to determine if it contains more than one token when split
- * by spaces. It returns `1` if an extra token is found (i.e., more than one token), and `0` if
- * only one token is present or if the string is empty.
- *
- * The function allocates memory to create a copy of the input string for processing. If memory 
- * allocation fails, it prints an error message and terminates the program.
- *
- * @param str The string to be checked.
- * @return `1` if more than one token is found, `0` otherwise.
- */
-int extra_char_detection(char *str);
+int find_opcode(const char *name, size_t length);
 
 
 /**
- * @brief Checks if a given string ends with a colon (`:`), indicating it might be a label.
+ * @brief Finds the register with a given name.
  *
- * This function examines the last character of a string to determine if it is a colon (`:`).
- * If the string is empty, the function returns `false`. Otherwise, it returns `true` if the
- * last character is a colon, and `false` otherwise.
- *
- * @param str The string to be checked.
- * @return `true` if the string ends with a colon, `false` otherwise.
+ * @param name The name to look for, it does not have to end with '\0'.
+ * @param length The number of characters in the name.
+ * @return The number of the register, or -1 if there is none.
  */
-bool endsWithColon(const char *str);
+int find_register(const char *name, size_t length);
 
 /**
  * This function allocates new memory and handles the errors that might occur
  * @param size the amount of memory to allocate
+ * @param site what the memory is for, by enum alloc_site, it is counted there when the allocations are profiled
  * @return a void pointer of the allocated memory, or NULL if the allocation failed
  */
-void *handle_malloc(size_t size);
+void *handle_malloc(size_t size, int site);
 
 
 /**
- * @brief Creates a new node with the given macro name, content, and line number.
- *
- * This function allocates memory for a new node, initializes its fields with the provided
- * macro name, content, and line number, and returns a pointer to the newly created node.
- *
- * @param name The name of the macro to be stored in the node.
- * @param content The content associated with the macro.
- * @param line_num The line number where the macro is defined.
- * @return A pointer to the newly created node, or NULL if memory allocation fails.
+ * This function reallocates memory and handles the errors that might occur
+ * @param ptr the memory to reallocate, or NULL
+ * @param size the new amount of memory
+ * @param site what the memory is for, by enum alloc_site
+ * @return a void pointer of the reallocated memory
  */
-node *make_node(char *name, char *content, int line_num);
+void *handle_realloc(void *ptr, size_t size, int site);
 
 
 /**
- * @brief Searches for a macro name in a linked list and checks if it's already defined.
- *
- * This function recursively searches through a linked list to find if a given macro name
- * is already present and defined within a line that contains the keyword "macr".
- * If found, the function sets the `found` flag to 1 and returns a pointer to the node.
- * If the macro name is not found, the function returns a pointer to the last node in the list.
- *
- * @param head A pointer to the head node of the linked list.
- * @param name The name of the macro to search for in the list.
- * @param line The current line being processed, used to check for the keyword "macr".
- * @param found A pointer to an integer flag that is set to 1 if the macro name is found.
- * @return A pointer to the node where the macro name is found, or the last node in the list if not found.
+ * This function frees memory from handle_malloc or handle_realloc, so the profiler knows it is no longer live
+ * @param ptr the memory to free, or NULL
  */
-node *search_list(node *head, char *name,char *line, int *found);
+void handle_free(void *ptr);
 
 
 /**
- * @brief Adds a node to a linked list.
+ * @brief Initializes an empty growable buffer.
  *
- * This function adds a new node of a macro to the end of a linked list
- * @param head a pointer to head of a linked list where the macros were saved
- * @param name a string with the name of the new macro
- * @param content a string with the content of the new macro
- * @param line_num the line number in the source file where the macro was defined
- * @param temp a pointer to the last node in the linked list (or NULL if the list is empty).
+ * @param buffer The buffer to initialize.
  */
-void add_macro_to_list(node **head, char *name, char *content, int line_num,node *temp);
+void init_buffer(byte_buffer *buffer);
+
 
 /**
- * @brief Frees a node in the linked list.
+ * @brief Appends characters to the end of a growable buffer.
  *
- * This function frees the memory allocated for a node in the linked list of macros.
- * It releases the memory for the macro's name, the macro's content, and the node itself.
+ * The capacity of the buffer is doubled whenever it is too small, so an append costs
+ * constant time on average and there is no limit to the size of the buffer.
  *
- * @param node1 Pointer to the node to be freed.
+ * @param buffer The buffer.
+ * @param str The characters to append.
+ * @param len The number of characters to append.
  */
-void free_node(node *node1);
+void append_to_buffer(byte_buffer *buffer, const char *str, size_t len);
+
 
 /**
- * @brief Frees all nodes in a linked list.
+ * @brief Makes sure that a growable buffer can hold a number of characters.
  *
- * This function iterates through a linked list and frees the memory
- * allocated for each node and its contents.
- *
- * @param head Pointer to the head of the linked list to be freed.
+ * @param buffer The buffer.
+ * @param capacity The number of characters the buffer must be able to hold.
  */
-void free_list(node *head);
+void reserve_buffer(byte_buffer *buffer, size_t capacity);
 
 
 /**
- * @brief Adds macros from a file to a linked list.
+ * @brief Frees the characters of a growable buffer and leaves it empty.
  *
- * This function reads a file line by line, identifies macros defined in the file, 
- * and adds them to a linked list. 
+ * @param buffer The buffer to free.
+ */
+void free_buffer(byte_buffer *buffer);
+
+
+/**
+ * @brief Calculates the FNV-1a hash of a name.
  *
- * @param file_name The name of the file to read macros from.
- * @param head A pointer to the head of the linked list where the macros will be added.
- * @return Returns 1 if macros were added successfully, or -1 if there was an error opening the file.
+ * @param name The characters of the name, not necessarily null terminated.
+ * @param len The number of characters in the name.
+ * @return The hash of the name.
  */
-int add_macro(char *file_name, node **head);
+unsigned long hash_name(const char *name, size_t len);
 
 
 /**
- * @brief Removes macro declarations from a file.
+ * @brief Creates a new node with the given macro name, content, and line number.
  *
- * This function processes an input file line by line, removes any lines 
- * that are part of a macro declaration (from "macr" to "endmacr"), and writes 
- * the remaining content to a new file with a ".t02" extension.
+ * This function takes the memory for a new node from an arena, initializes its fields with the provided
+ * macro name, content, and line number, and returns a pointer to the newly created node.
  *
- * @param file_name The name of the input file to process.
- * @return A pointer to a string containing the name of the new file without macro declarations, or NULL if an error occurs.
+ * @param memory The arena of the file.
+ * @param name The name of the macro to be stored in the node.
+ * @param content The content associated with the macro.
+ * @param line_num The line number where the macro is defined.
+ * @return A pointer to the newly created node.
  */
-char *remove_mcros_decl(char file_name[]);
+node *make_node(arena *memory, char *name, char *content, int line_num);
 
 
 /**
- * @brief Replaces all macro occurrences in a file with their corresponding content.
+ * @brief Initializes an empty macro table.
  *
- * This function reads an input file line by line, checks each line for a macro name,
- * and replaces the macro with its content if found. The resulting content is written
- * to a new file with a ".am" extension.
+ * The slots and the macros are kept in an arena, they are released when the arena is reset.
  *
- * @param file_name The name of the input file to process.
- * @param head A pointer to the head of the linked list containing macro names and their content.
- * @return A pointer to a string containing the name of the new file with macros replaced, or NULL if an error occurs.
+ * @param table The macro table to initialize.
+ * @param memory The arena of the file.
  */
-char * replace_all_mcros(char *file_name, node *head);
+void init_macro_table(macro_table *table, arena *memory);
+
+
 /**
- * @brief Checks if the string is valid.
+ * @brief Searches for a macro by its exact name.
+ *
+ * The name is hashed once and the table is probed from the slot of the hash until an empty slot,
+ * so the search takes constant time regardless of the number of macros.
  *
- * This function checks whether the string `str` is considered valid
- * based on the following criteria:
- * 1. If the string is empty ( it contains no characters), it is considered valid.
- * 2. If the string contains only whitespace characters (spaces, tabs, etc.), it is considered valid.
- * 3. If the string contains any non-whitespace characters, it is considered invalid.
+ * @param table The macro table.
+ * @param name The characters of the name, not necessarily null terminated.
+ * @param len The number of characters in the name.
+ * @return A pointer to the macro node, or NULL if there is no macro with this name.
+ */
+node *search_macro(macro_table *table, const char *name, size_t len);
+
+
+/**
+ * @brief Puts a node in the first free slot after the slot of its hash.
  *
- * @param str A pointer to the string to be checked.
- * @return int Returns 1 if the string is valid (empty or contains only whitespace),
- *             and 0 if the string is invalid (contains any non-whitespace characters).
+ * @param table The macro table, it must have a free slot.
+ * @param new_node The node to insert.
  */
-int is_rest_of_line_valid(char *str);
+void insert_macro_slot(macro_table *table, node *new_node);
+
 
+/**
+ * @brief Adds a macro to the macro table.
+ *
+ * The table is doubled when it becomes more than half full.
+ *
+ * @param table The macro table.
+ * @param name a string with the name of the new macro, kept in the arena of the table
+ * @param content a buffer with the lines of the new macro, they are copied to the arena and the buffer is left empty
+ * @param line_num the line number in the source file where the macro was defined
+ */
+void add_macro_to_table(macro_table *table, char *name, byte_buffer *content, int line_num);
 
 
-void printlist(node *head);
+void printlist(macro_table *table);
@@ -4,148 +4,195 @@
 #include <errno.h>
 #include "globals.h"
 #include "pre_assembler.h"
+#include "reader.h"
+#include "normalize.h"
+#include "arena.h"
+#include "report.h"
+#include "stats.h"
+
+/* the work of next_line, without the statistics */
+static char* pull_line(line_source* source) {
+	char* str = source->line.data;
+	line_slice raw;
+	long start;
+
+	while (1) {
+		/* a macro call is being expanded, hand out its lines and then one empty line */
+		if (source->expansion != NULL) {
+			if (source->expansion != source->expansion_end) {
+				/* the line is handed out from the macro content without copying it */
+				str = source->expansion;
+				source->expansion += strlen(str) + 1;
+			}
+			else {
+				strcpy(str, "\n");
+				source->expansion = NULL;
+			}
+			break;
+		}
 
-char* remove_extra_spaces_file(char file_name[]) {
-
-	char* new_file_name;
-	char str[BIG_NUMBER_CONST];
-	int num_line = 0;
-	FILE* orig_file, * temp_file;
-
-	orig_file = fopen(file_name, "r");
-
-	if (orig_file == NULL) {
-		printf("Error opening original file\n");
-		return NULL;
-	}
-
-	new_file_name = add_new_file(file_name, ".t01");
-	if (new_file_name == NULL) {
-		fclose(orig_file);
-		printf("Error creating new file name\n");
-		return NULL;
-	}
-
-	temp_file = fopen(new_file_name, "w");
-	if (temp_file == NULL) {
-		fclose(orig_file);
-		printf("Error opening temporary file\n");
-		return NULL;
-	}
+		if (!read_line(&source->input, &raw)) {
+			if (source->in_macro_decl) {
+				report_error_at(source->macro_line, "Missing endmacr for the macro in line %d\n", source->macro_line);
+				source->is_valid = 0;
+			}
+			/* the .am copy is complete after the first reading */
+			source->am_text = NULL;
+			return NULL;
+		}
+		source->source_line++;
 
-	while (fgets(str, BIG_NUMBER_CONST, orig_file)) {
-		num_line++;
-		if (strlen(str) > MAX_LINE_LENGTH) {
-			printf("Line %d too long\n", num_line);
-			fclose(orig_file);
-			fclose(temp_file);
-			free(new_file_name);
+		if (source->max_line_length > 0 && (long)raw.length > source->max_line_length) {
+			report_at(source->source_line, "Line %d too long\n", source->source_line);
+			source->is_valid = 0;
 			return NULL;
 		}
-		else if (*str == ';') {
-			*str = '\n';
-			*(str + 1) = '\0';
+		/* the line buffer grows to the longest line, the normalized line is never longer */
+		reserve_buffer(&source->line, raw.length + 2);
+		str = source->line.data;
+		if (source->stats != NULL) {
+			start = stats_clock();
+			remove_extra_spaces_str(raw.start, raw.length, str);
+			source->stats->nanoseconds[STATS_NORMALIZE] += stats_clock() - start;
 		}
 		else {
-			remove_extra_spaces_str(str);
+			remove_extra_spaces_str(raw.start, raw.length, str);
+		}
+
+		if (source->in_macro_decl || is_macro_decl(str)) {
+			/* the lines of a macro declaration are left empty in the output */
+			handle_macro_decl_line(source, str);
+			strcpy(str, "\n");
+			break;
+		}
+
+		if (!start_macro_call(source, str)) {
+			break;
+		}
+		if (source->stats != NULL) {
+			source->stats->macro_calls++;
 		}
-		fputs(str, temp_file);
 	}
 
-	fclose(orig_file);
-	fclose(temp_file);
-	return new_file_name;
+	if (source->am_text != NULL) {
+		append_to_buffer(source->am_text, str, strlen(str));
+	}
+	return str;
 }
 
-int add_macro(char* file_name, node** head) {
-	char rest_of_line[MAX_LINE_LENGTH];
-	char line[MAX_LINE_LENGTH];
-	char* macro_name = NULL;
-	char macro_content[MAX_LINE_LENGTH * 100] = "";
-	int is_macro = 0;
-	int line_number = 0;
-	int mcro_line;
-	int found = 0;
-	node* temp;
-	int isvalid = 1;
-	char temp_name[MAX_LINE_LENGTH];
-
-	FILE* file = fopen(file_name, "r");
-	if (file == NULL) {
-		perror("Error opening file");
-		return -1;
+char* next_line(line_source* source) {
+	char* str;
+	long start;
+
+	/* the clock is read only when the statistics are kept */
+	if (source->stats == NULL) {
+		return pull_line(source);
 	}
+	start = stats_clock();
+	str = pull_line(source);
+	source->stats->nanoseconds[STATS_PRE_ASSEMBLER] += stats_clock() - start;
+	if (str != NULL) {
+		source->stats->expanded_lines++;
+	}
+	return str;
+}
 
-	while (fgets(line, sizeof(line), file)) {
-		line_number++;
-		found = 0;
-		temp = NULL;
-		if (strncmp(line, "macr ", 5) == 0) {
-			/* add search in the list */
-			mcro_line = line_number;
+int is_macro_decl(char* line) {
+	return (strncmp(line, "macr", 4) == 0 && (line[4] == ' ' || line[4] == '\n' || line[4] == '\0'));
+}
 
-			rest_of_line[0] = '\0';
-            
-            sscanf(line + 5, "%s %[^\n]", temp_name, rest_of_line);
+/* returns 1 if nothing but white-spaces is left in the line */
+int is_end_of_words(const char* str) {
+	while (*str == ' ' || *str == '\t') {
+		str++;
+	}
+	return (*str == '\n' || *str == '\0');
+}
 
-			temp = search_list(*head, temp_name, line, &found);
+void handle_macro_decl_line(line_source* source, char* line) {
+	char* name;
+	size_t name_len, word_len;
 
-			if (found) {
-				isvalid = 0;
-				continue;
-			}
-			if (is_valid_macro_name(temp_name)) {
-				if(!is_rest_of_line_valid(rest_of_line)){
-                    fprintf(stderr, "Extra characters in line %d\n", line_number);
-					isvalid = 0;
-                }
-				is_macro = 1;
-				macro_content[0] = '\0';
-				macro_name = handle_malloc((strlen(temp_name) + 1) * sizeof(char));
-				strcpy(macro_name, temp_name);
-			}
-			else {
+	if (!source->in_macro_decl) {
+		source->in_macro_decl = 1;
+		source->macro_line = source->source_line;
+		name = line + 4;
+		while (*name == ' ') {
+			name++;
+		}
+		name_len = strcspn(name, " \t\n");
 
-				fprintf(stderr, "Invalid macro name at line %d: %s\n", line_number, temp_name);
-				isvalid = 0;
-				continue;
-			}
+		if (name_len > 0 && search_macro(source->macros, name, name_len) != NULL) {
+			report_at(source->source_line, "Node %.*s already exists in the list\n", (int)name_len, name);
+			source->is_valid = 0;
+			return;
+		}
+		source->macro_name = arena_strndup(source->memory, name, name_len, ALLOC_MACROS);
+		if (name_len == 0 || !is_valid_macro_name(source->macro_name)) {
+			report_error_at(source->source_line, "Invalid macro name at line %d: %s\n", source->source_line, source->macro_name);
+			source->is_valid = 0;
+			source->macro_name = NULL;
+			return;
 		}
-		else if (is_macro && strncmp(line, "endmacr", 7) == 0) {
-			rest_of_line[0] = '\0';
-        
-            sscanf(line + 7, "%s", rest_of_line);
-            if(!is_rest_of_line_valid(rest_of_line)){
-                fprintf(stderr, "Extra characters in line %d\n", line_number);
-				isvalid = 0;
-            }
-			add_macro_to_list(head, macro_name, macro_content, mcro_line, temp);
-
-			is_macro = 0;
-			macro_name = NULL;
+		if (!is_end_of_words(name + name_len)) {
+			report_error_at(source->source_line, "Extra characters in line %d\n", source->source_line);
+			source->is_valid = 0;
 		}
-		else if (is_macro) {
+		return;
+	}
 
-			strcat(macro_content, line);
+	word_len = strcspn(line, " \t\n");
+	if (word_len != 7 || strncmp(line, "endmacr", 7) != 0) {
+		if (source->macro_name != NULL) {
+			append_to_buffer(&source->macro_content, line, strlen(line) + 1);
 		}
+		return;
 	}
 
-	if (macro_name != NULL) {
-		free(macro_name);
+	source->in_macro_decl = 0;
+	if (source->macro_name == NULL) {
+		return;
+	}
+	if (!is_end_of_words(line + word_len)) {
+		report_error_at(source->source_line, "Extra characters in line %d\n", source->source_line);
+		source->is_valid = 0;
 	}
-	
-	fclose(file);
-	if(!isvalid){
+	add_macro_to_table(source->macros, source->macro_name, &source->macro_content, source->macro_line);
+	source->macro_name = NULL;
+}
+
+int start_macro_call(line_source* source, char* line) {
+	node* macro;
+	size_t len = strcspn(line, "\n");
+
+	/* a macro call is a line with a single word */
+	if (len == 0 || memchr(line, ' ', len) != NULL) {
 		return 0;
 	}
-	return 1;
+	macro = search_macro(source->macros, line, len);
+	/* only macros defined above this line are expanded */
+	if (macro != NULL && macro->macro_line < source->source_line) {
+		source->expansion = macro->macro_content;
+		source->expansion_end = macro->macro_content + macro->content_length;
+		return 1;
+	}
+	return 0;
 }
-void printlist(node* head) {
-	while (head)
+
+void printlist(macro_table* table) {
+	int i;
+	char* content;
+	for (i = 0; i < table->capacity; i++)
 	{
-		printf("the name of macr: %s\n", head->macro_name);
-		printf("the content of macr: %s\n", head->macro_content);
-		head = head->next;
+		if (table->slots[i] != NULL) {
+			printf("the name of macr: %s\n", table->slots[i]->macro_name);
+			printf("the content of macr:\n");
+			content = table->slots[i]->macro_content;
+			while (content != table->slots[i]->macro_content + table->slots[i]->content_length) {
+				printf("%s", content);
+				content += strlen(content) + 1;
+			}
+		}
 	}
 
-}
\ No newline at end of file
+}
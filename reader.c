@@ -0,0 +1,36 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "globals.h"
+#include "reader.h"
+#include "pre_assembler.h"
+
+void open_input_text(const char *text, size_t size, input_file *input) {
+	/* the lines are only read, the content is never written through the input */
+	input->data = (char *)text;
+	input->size = size;
+	input->pos = 0;
+	input->is_mapped = 0;
+	input->is_borrowed = 1;
+}
+
+int read_line(input_file *input, line_slice *line) {
+	const char *start, *end;
+	size_t left = input->size - input->pos;
+
+	if (left == 0) {
+		return 0;
+	}
+	start = input->data + input->pos;
+	end = memchr(start, '\n', left);
+	line->start = start;
+	line->length = (end != NULL) ? (size_t)(end - start + 1) : left;
+	input->pos += line->length;
+	return 1;
+}
+
+void close_input_text(input_file *input) {
+	input->data = NULL;
+	input->size = 0;
+	input->pos = 0;
+}
@@ -0,0 +1,36 @@
+#ifndef LABRATORY_C_FINAL_PROJECT_READER_H
+#define LABRATORY_C_FINAL_PROJECT_READER_H
+
+#include "globals.h"
+
+/**
+ * @brief Reads the lines of a text that is already in memory, like the content of an input file.
+ *
+ * The text is not copied, it must stay unchanged until the input is closed, and it is not released with it.
+ *
+ * @param text The text, it does not have to end with '\0'.
+ * @param size The number of characters in the text.
+ * @param input The input file to initialize.
+ */
+void open_input_text(const char *text, size_t size, input_file *input);
+
+/**
+ * @brief Hands out the next line of an input file.
+ *
+ * The line is not copied, the slice points into the content of the file and its length
+ * includes the '\n' at its end, if there is one.
+ *
+ * @param input The input file.
+ * @param line The slice that receives the line.
+ * @return 1 if a line was found, 0 at the end of the input.
+ */
+int read_line(input_file *input, line_slice *line);
+
+/**
+ * @brief Stops reading the lines of a text, the text itself is left to its owner.
+ *
+ * @param input The input file to close.
+ */
+void close_input_text(input_file *input);
+
+#endif
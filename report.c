@@ -0,0 +1,211 @@
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <pthread.h>
+#include "globals.h"
+#include "report.h"
+#include "pre_assembler.h"
+
+/* Size of the buffer that a message is formatted in first, longer messages are formatted again */
+#define REPORT_LINE_SIZE 256
+
+static pthread_key_t capture_key;
+static pthread_once_t capture_once = PTHREAD_ONCE_INIT;
+
+static void create_capture_key(void) {
+	pthread_key_create(&capture_key, NULL);
+}
+
+static diagnostics *current_capture(void) {
+	pthread_once(&capture_once, create_capture_key);
+	return pthread_getspecific(capture_key);
+}
+
+diagnostics *captured_reports(void) {
+	return current_capture();
+}
+
+void capture_reports(diagnostics *diag) {
+	pthread_once(&capture_once, create_capture_key);
+	pthread_setspecific(capture_key, diag);
+}
+
+/* Appends a formatted message to a buffer if it fits in a line, and returns 0.
+ * A longer message only reserves room in the buffer, its length is returned and it is
+ * formatted again by the caller, since the arguments can be read only once. */
+static size_t format_into(byte_buffer *buffer, const char *format, va_list args) {
+	char line[REPORT_LINE_SIZE];
+	int length = vsnprintf(line, sizeof(line), format, args);
+
+	if (length < 0) {
+		return 0;
+	}
+	if ((size_t)length < sizeof(line)) {
+		append_to_buffer(buffer, line, (size_t)length);
+		return 0;
+	}
+	reserve_buffer(buffer, buffer->length + (size_t)length + 1);
+	return (size_t)length;
+}
+
+/* keeps the line of a message that starts at a place of its buffer */
+static void add_message_line(message_lines *lines, size_t start, int line) {
+	if (lines->count == lines->capacity) {
+		lines->capacity = (lines->capacity == 0) ? FIXUPS_INIT_SIZE : lines->capacity * 2;
+		lines->lines = handle_realloc(lines->lines, lines->capacity * sizeof(message_line), ALLOC_MESSAGES);
+	}
+	lines->lines[lines->count].start = start;
+	lines->lines[lines->count].line = line;
+	lines->count++;
+}
+
+/* returns the first line of a message that starts at a place or after it, or the count if there is none */
+static int first_message_line(message_lines *lines, size_t start) {
+	int low = 0, high = lines->count, middle;
+
+	while (low < high) {
+		middle = low + (high - low) / 2;
+		if (lines->lines[middle].start < start) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+	return low;
+}
+
+/* Prints a message, or adds it to the diagnostics of the thread with its line. Returns the length of a
+ * message that did not fit in a line, the caller formats it again into the room that was reserved. */
+static size_t begin_report(diagnostics *diag, int is_error, int line, const char *format, va_list args) {
+	if (diag == NULL) {
+		vfprintf(is_error ? stderr : stdout, format, args);
+		return 0;
+	}
+	if (line > 0) {
+		if (is_error) {
+			add_message_line(&diag->err_lines, diag->err.length, line);
+		}
+		else {
+			add_message_line(&diag->out_lines, diag->out.length, line);
+		}
+	}
+	return format_into(is_error ? &diag->err : &diag->out, format, args);
+}
+
+static void finish_report(byte_buffer *buffer, size_t length, const char *format, va_list args) {
+	vsnprintf(buffer->data + buffer->length, length + 1, format, args);
+	buffer->length += length;
+}
+
+void report(const char *format, ...) {
+	diagnostics *diag = current_capture();
+	va_list args;
+	size_t length;
+
+	va_start(args, format);
+	length = begin_report(diag, 0, 0, format, args);
+	va_end(args);
+	if (length > 0) {
+		va_start(args, format);
+		finish_report(&diag->out, length, format, args);
+		va_end(args);
+	}
+}
+
+void report_at(int line, const char *format, ...) {
+	diagnostics *diag = current_capture();
+	va_list args;
+	size_t length;
+
+	va_start(args, format);
+	length = begin_report(diag, 0, line, format, args);
+	va_end(args);
+	if (length > 0) {
+		va_start(args, format);
+		finish_report(&diag->out, length, format, args);
+		va_end(args);
+	}
+}
+
+void report_error(const char *format, ...) {
+	diagnostics *diag = current_capture();
+	va_list args;
+	size_t length;
+
+	va_start(args, format);
+	length = begin_report(diag, 1, 0, format, args);
+	va_end(args);
+	if (length > 0) {
+		va_start(args, format);
+		finish_report(&diag->err, length, format, args);
+		va_end(args);
+	}
+}
+
+void report_error_at(int line, const char *format, ...) {
+	diagnostics *diag = current_capture();
+	va_list args;
+	size_t length;
+
+	va_start(args, format);
+	length = begin_report(diag, 1, line, format, args);
+	va_end(args);
+	if (length > 0) {
+		va_start(args, format);
+		finish_report(&diag->err, length, format, args);
+		va_end(args);
+	}
+}
+
+void report_kept(diagnostics *kept, int is_error, size_t start, size_t end) {
+	diagnostics *diag = current_capture();
+	byte_buffer *buffer = is_error ? &kept->err : &kept->out;
+	message_lines *lines = is_error ? &kept->err_lines : &kept->out_lines;
+	message_lines *moved;
+	byte_buffer *into;
+	int i;
+
+	if (end <= start) {
+		return;
+	}
+	if (diag == NULL) {
+		fwrite(buffer->data + start, 1, end - start, is_error ? stderr : stdout);
+		return;
+	}
+	/* the lines of the messages move with them, to their place in the buffer of the thread */
+	into = is_error ? &diag->err : &diag->out;
+	moved = is_error ? &diag->err_lines : &diag->out_lines;
+	for (i = first_message_line(lines, start); i < lines->count && lines->lines[i].start < end; i++) {
+		add_message_line(moved, into->length + (lines->lines[i].start - start), lines->lines[i].line);
+	}
+	append_to_buffer(into, buffer->data + start, end - start);
+}
+
+void init_diagnostics(diagnostics *diag) {
+	init_buffer(&diag->out);
+	init_buffer(&diag->err);
+	diag->out_lines.lines = NULL;
+	diag->out_lines.count = 0;
+	diag->out_lines.capacity = 0;
+	diag->err_lines = diag->out_lines;
+}
+
+void flush_diagnostics(diagnostics *diag) {
+	if (diag->out.length > 0) {
+		fwrite(diag->out.data, 1, diag->out.length, stdout);
+	}
+	if (diag->err.length > 0) {
+		fflush(stdout);
+		fwrite(diag->err.data, 1, diag->err.length, stderr);
+	}
+}
+
+void free_diagnostics(diagnostics *diag) {
+	free_buffer(&diag->out);
+	free_buffer(&diag->err);
+	handle_free(diag->out_lines.lines);
+	handle_free(diag->err_lines.lines);
+	init_diagnostics(diag);
+}
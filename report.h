@@ -0,0 +1,90 @@
+#ifndef LABRATORY_C_FINAL_PROJECT_REPORT_H
+#define LABRATORY_C_FINAL_PROJECT_REPORT_H
+
+#include "globals.h"
+
+/**
+ * @brief Prints a message about the file being assembled, like printf.
+ *
+ * If the calling thread captures its messages, the message is added to its diagnostics instead.
+ *
+ * @param format The format of the message, as in printf.
+ */
+void report(const char *format, ...);
+
+/**
+ * @brief Prints a message about a line of the source, like printf.
+ *
+ * If the calling thread captures its messages, the message is added to its diagnostics with the line,
+ * so a caller of the library gets the line without reading it from the text.
+ *
+ * @param line The line of the source the message is about, 0 for none.
+ * @param format The format of the message, as in printf.
+ */
+void report_at(int line, const char *format, ...);
+
+/**
+ * @brief Prints an error message about the file being assembled to stderr, like fprintf(stderr, ...).
+ *
+ * If the calling thread captures its messages, the message is added to its diagnostics instead.
+ *
+ * @param format The format of the message, as in printf.
+ */
+void report_error(const char *format, ...);
+
+/**
+ * @brief Prints an error message about a line of the source to stderr, like report_at.
+ *
+ * @param line The line of the source the message is about, 0 for none.
+ * @param format The format of the message, as in printf.
+ */
+void report_error_at(int line, const char *format, ...);
+
+/**
+ * @brief Reports again a part of messages that were kept in diagnostics, with the lines they were reported with.
+ *
+ * @param kept The diagnostics that hold the messages.
+ * @param is_error 1 for the messages of stderr, 0 for the messages of stdout.
+ * @param start The place of the first character of the part in the buffer.
+ * @param end The place after the last character of the part.
+ */
+void report_kept(diagnostics *kept, int is_error, size_t start, size_t end);
+
+/**
+ * @brief Sends the messages of the calling thread to a diagnostics buffer, or back to stdout and stderr.
+ *
+ * Each thread has its own setting, so the messages of files assembled at the same time do not mix.
+ *
+ * @param diag The diagnostics that receive the messages, or NULL to print them.
+ */
+void capture_reports(diagnostics *diag);
+
+/**
+ * @brief Returns the diagnostics that receive the messages of the calling thread.
+ *
+ * @return The diagnostics, or NULL if the messages are printed.
+ */
+diagnostics *captured_reports(void);
+
+/**
+ * @brief Initializes empty diagnostics.
+ *
+ * @param diag The diagnostics to initialize.
+ */
+void init_diagnostics(diagnostics *diag);
+
+/**
+ * @brief Prints the messages of diagnostics, the messages to stdout first and then the errors to stderr.
+ *
+ * @param diag The diagnostics.
+ */
+void flush_diagnostics(diagnostics *diag);
+
+/**
+ * @brief Releases the buffers of diagnostics.
+ *
+ * @param diag The diagnostics to free.
+ */
+void free_diagnostics(diagnostics *diag);
+
+#endif
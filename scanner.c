@@ -5,6 +5,9 @@
 #include <ctype.h>
 #include "globals.h"
 #include "first_pass.h"
+#include "pre_assembler.h"
+#include "lexer.h"
+#include "report.h"
 char* INSTRUCTION[] = { ".data",".string",".extern",".entry" };
 Register REGISTERS[] = {
 	{"r0",1},
@@ -36,197 +39,176 @@ op_code OPCODES[] = {/*insert -1 when should be null and -2 when should be empty
 		{"stop" ,15, 0,{-2,-2,-2,-2},{-2,-2,-2,-2}}
 };
 
-type_of_argument arr_type_of_arg[] = {
-	{'#',0},
-	{'*',2},
-	{'r',3}
+/* The reserved words by their slot, keyword_slot() puts each one in a slot of its own.
+ * The slot depends only on the first two characters and the length, the multipliers were
+ * found by trying small numbers until no two reserved words shared a slot. */
+keyword KEYWORDS[KEYWORD_SLOTS] = {
+	{"rts", KEYWORD_OPCODE, 14},
+	{NULL, KEYWORD_NONE, -1},
+	{NULL, KEYWORD_NONE, -1},
+	{".string", KEYWORD_INSTRUCTION, 1},
+	{NULL, KEYWORD_NONE, -1},
+	{NULL, KEYWORD_NONE, -1},
+	{"sub", KEYWORD_OPCODE, 3},
+	{NULL, KEYWORD_NONE, -1},
+	{NULL, KEYWORD_NONE, -1},
+	{NULL, KEYWORD_NONE, -1},
+	{NULL, KEYWORD_NONE, -1},
+	{"stop", KEYWORD_OPCODE, 15},
+	{NULL, KEYWORD_NONE, -1},
+	{"inc", KEYWORD_OPCODE, 7},
+	{NULL, KEYWORD_NONE, -1},
+	{NULL, KEYWORD_NONE, -1},
+	{NULL, KEYWORD_NONE, -1},
+	{"jmp", KEYWORD_OPCODE, 9},
+	{NULL, KEYWORD_NONE, -1},
+	{"lea", KEYWORD_OPCODE, 4},
+	{NULL, KEYWORD_NONE, -1},
+	{NULL, KEYWORD_NONE, -1},
+	{NULL, KEYWORD_NONE, -1},
+	{"jsr", KEYWORD_OPCODE, 13},
+	{NULL, KEYWORD_NONE, -1},
+	{NULL, KEYWORD_NONE, -1},
+	{NULL, KEYWORD_NONE, -1},
+	{"add", KEYWORD_OPCODE, 2},
+	{NULL, KEYWORD_NONE, -1},
+	{NULL, KEYWORD_NONE, -1},
+	{NULL, KEYWORD_NONE, -1},
+	{NULL, KEYWORD_NONE, -1},
+	{NULL, KEYWORD_NONE, -1},
+	{NULL, KEYWORD_NONE, -1},
+	{"mov", KEYWORD_OPCODE, 0},
+	{NULL, KEYWORD_NONE, -1},
+	{NULL, KEYWORD_NONE, -1},
+	{NULL, KEYWORD_NONE, -1},
+	{NULL, KEYWORD_NONE, -1},
+	{"not", KEYWORD_OPCODE, 6},
+	{".data", KEYWORD_INSTRUCTION, 0},
+	{NULL, KEYWORD_NONE, -1},
+	{"bne", KEYWORD_OPCODE, 10},
+	{"dec", KEYWORD_OPCODE, 8},
+	{NULL, KEYWORD_NONE, -1},
+	{"clr", KEYWORD_OPCODE, 5},
+	{"cmp", KEYWORD_OPCODE, 1},
+	{".entry", KEYWORD_INSTRUCTION, 3},
+	{NULL, KEYWORD_NONE, -1},
+	{"red", KEYWORD_OPCODE, 11},
+	{NULL, KEYWORD_NONE, -1},
+	{NULL, KEYWORD_NONE, -1},
+	{"prn", KEYWORD_OPCODE, 12},
+	{".extern", KEYWORD_INSTRUCTION, 2},
+	{"r0", KEYWORD_REGISTER, 0},
+	{"r1", KEYWORD_REGISTER, 1},
+	{"r2", KEYWORD_REGISTER, 2},
+	{"r3", KEYWORD_REGISTER, 3},
+	{"r4", KEYWORD_REGISTER, 4},
+	{"r5", KEYWORD_REGISTER, 5},
+	{"r6", KEYWORD_REGISTER, 6},
+	{"r7", KEYWORD_REGISTER, 7},
+	{NULL, KEYWORD_NONE, -1},
+	{NULL, KEYWORD_NONE, -1}
 };
 
-int instr_detection(char* str) {
-	int i;
+unsigned int keyword_slot(const char* name, size_t length) {
+	return (5u * (unsigned char)name[0] + (unsigned char)name[1] + 6u * (unsigned int)length) & (KEYWORD_SLOTS - 1);
+}
 
-	/* Return 0 if the string is NULL */
-	if (str == NULL) {
-		return 0;
-	}
+keyword_kind find_keyword(const char* name, size_t length, int* index) {
+	const keyword* slot;
 
-	/* Iterate through the list of known instructions and compare the string with each instruction in the list */
-	for (i = 0; i < INSTRUCTIONS_COUNT; i++) {
-		if (strcmp(str, INSTRUCTION[i]) == 0) {
-			return 1; /* Return 1 if the string matches an instruction */
-		}
+	if (length < KEYWORD_MIN_LENGTH || length > KEYWORD_MAX_LENGTH) {
+		return KEYWORD_NONE;
+	}
+	/* one probe, the only reserved word that can match is the one in the slot */
+	slot = &KEYWORDS[keyword_slot(name, length)];
+	if (slot->name == NULL || strncmp(slot->name, name, length) != 0 || slot->name[length] != '\0') {
+		return KEYWORD_NONE;
 	}
-	return 0; /* Return 0 if the string is not a valid instruction */
+	*index = slot->index;
+	return slot->kind;
 }
 
-int instr_data_detection(char *str,char* first_word, char* rest_of_line, int* DC, int line, data_image** data_image_head) {
-    /* Return 0 if the string is NULL */
-    if (first_word == NULL) {
-        return 0;
-    }
-    if (strcmp(first_word, ".data") == 0) {
-        check_valid_data(rest_of_line, DC, line, data_image_head);
-        return 1;
-    }
-    else if (strcmp(first_word, ".string") == 0) {
-        char *start_of_string = strstr(str, ".string");
-
-        if (start_of_string) {
-
-            start_of_string += strlen(".string"); /* Move the pointer to the end of the .string keyword */
+int find_instruction(const char* name, size_t length) {
+	int index;
+	return (find_keyword(name, length, &index) == KEYWORD_INSTRUCTION) ? index : -1;
+}
 
-            while (*start_of_string == ' ' || *start_of_string == '\t') { /* Skip over any spaces or tabs following .string */
-                start_of_string++;
-            }
-            strcpy(rest_of_line, start_of_string); /* Copy the rest of the line after .string into rest_of_line */
+int instr_data_detection(line_tokens* tokens, int* DC, int line, memory_image* data, int* fits) {
+    token* instruction = &tokens->tokens[tokens->statement];
 
-            rest_of_line[strcspn(rest_of_line, "\n")] = '\0'; /* Remove the newline character from rest_of_line */
-        }
-        check_valid_string(rest_of_line, DC, line, data_image_head);
+    if (instruction->value == DATA_INSTRUCTION) {
+        *fits = check_valid_data(tokens, DC, line, data);
+        return 1;
+    }
+    else if (instruction->value == STRING_INSTRUCTION) {
+        /* the lexer kept the rest of the line after .string as one token */
+        check_valid_string(tokens->operands.start, tokens->operands.length, DC, line, data);
         return 1;
     }
 
     return 0;
 }
-int opcode_detection(char* str) {
-	int i;
-
-	/* Return 0 if the string is NULL */
-	if (str == NULL) {
-		return 0;
-	}
 
-	/* Iterate through the list of known opcode and compare the string with each opcode in the list */
-	for (i = 0; i < OPCODES_COUNT; i++) {
-		if (!strcmp(str, OPCODES[i].name_of_opcode)) {
-			return 1; /* Return 1 if the string matches an opcode */
-		}
-	}
-	return 0; /* Return 0 if the string is not a valid opcode */
+int find_opcode(const char* name, size_t length) {
+	int index;
+	return (find_keyword(name, length, &index) == KEYWORD_OPCODE) ? index : -1;
 }
 
-int reg_detection(char* str) {
-	int i;
-	/* Return 0 if the string is NULL */
-	if (str == NULL) {
-		return 0;
-	}
-
-	/* Iterate through the list of known register and compare the string with each register in the list */
-	for (i = 0; i < REG_COUNT; i++) {
-		if (!strcmp(str, REGISTERS[i].name_of_register)) {
-			return REGISTERS[i].reg_num; /* Return the number of reg (but +1 to avoid return false for r0) */
-		}
-	}
-	return 0; /* Return 0 if the string is not a valid register */
-}
-
-bool endsWithColon(const char* str) {/*check if the string in the begining of the line is label*/
-	int len = strlen(str);
-	if (len == 0) {
-		return false; /* String is empty*/
-	}
-	return str[len - 1] == ':';
+int find_register(const char* name, size_t length) {
+	int index;
+	return (find_keyword(name, length, &index) == KEYWORD_REGISTER) ? index : -1;
 }
 
-int extra_char_detection(char* str) {
-	char* token;
-	/* Allocate memory for the copy of the string*/
-	char* rest_of_line = (char*)malloc((strlen(str) + 1) * sizeof(char));
-	if (rest_of_line == NULL) {
-		fprintf(stderr, "Memory allocation failed\n");
-		exit(1);
-	}
-
-	/* Copy the original string to avoid modifying it*/
-	strcpy(rest_of_line, str);
-
-	/*Use strtok to tokenize the string*/
-	token = strtok(rest_of_line, " ");
-	if (token == NULL) {
-		free(rest_of_line);
-		return 0; /* No tokens found */
-	}
-
-	/* Check if there's another token after the first*/
-	token = strtok(NULL, " ");
-	if (token != NULL) {
-		free(rest_of_line);
-		return 1; /* Extra character found*/
-	}
-
-	free(rest_of_line);
-	return 0; /*No extra character*/
-}
-/* if the string start with point its should be instruction */
-int is_instruction(char* str) {
-	return(*str == '.');
-}
+int valid_num_argument(line_tokens* tokens, int* num_of_opcode, int line) {
+	op_code* opcode = &OPCODES[tokens->tokens[tokens->statement].value];
 
-int valid_num_argument(char* str, char* rest_of_line, int* num_of_opcode) {
-	int i;
-	int count = 0;
-	char* ptr;
-	if (!check_valid_data_comma(rest_of_line)) {
-		printf("invalid comma");
+	if (!check_operand_commas(tokens)) {
+		report_at(line, "invalid comma");
 		return 0;
 	}
-	else {
-		if (rest_of_line[0] != '\0'){
-			ptr = rest_of_line;
-			while (*ptr != '\0') {
-				if (*ptr == ',') {
-					count++;
-				}
-				ptr++;
-			}
-		count++;
-		}	
-		
-	}
-	for (i = 0; i < OPCODES_COUNT; i++) {
-		if (strcmp(str, OPCODES[i].name_of_opcode) == 0 && OPCODES[i].arg_num == count) {
-			*num_of_opcode = OPCODES[i].num_of_opcode;
-			return 1; /* Return 1 if the string matches an opcode */
-		}
+	if (opcode->arg_num == count_operands(tokens)) {
+		*num_of_opcode = opcode->num_of_opcode;
+		return 1; /* Return 1 if the number of operands matches the opcode */
 	}
 	return 0;
 }
 
-int parsing_arg(char* name_of_opcode, char* arguments, char* first_word_to_binary, char* second_word_to_binary, char* third_word_to_binary,
-                 int* fieldBitSize1, int* fieldBitSize2, int* fieldBitSize3,int *detected_label_on_first_pass) {
+int parsing_arg(line_tokens* tokens, int* words, int* word_count, int *detected_label_on_first_pass, int line) {
     int num_arg_target = 0, num_arg_source = 0;
 	
     int type_of_source_arg = -3, type_of_target_arg = -3; /* Invalid by default */
     int num_of_opcode; 
-    char target_arg[50] = {0};
-    char source_arg[50] = {0};
+    int first = tokens->statement + 1;
+    token* source_arg = NULL;
+    token* target_arg = NULL;
 
-    if (arguments[0] == '\0') {
+    if (tokens->count == first) {
         type_of_source_arg = -2;/*-2 if its empty argument*/
         type_of_target_arg = -2;
-        *second_word_to_binary = '\0';
-        *third_word_to_binary = '\0';
     } 
-	else {
-        char* comma_ptr = strchr(arguments, ',');
-        if (comma_ptr != NULL) { /* Two arguments case */
-            strncpy(source_arg, arguments, comma_ptr - arguments);
-            strcpy(target_arg, comma_ptr + 1);
-        } else { /* Single argument case, just target exist */
-            strcpy(target_arg, arguments);
-			type_of_source_arg = -2;
-        }
+	else if (tokens->count == first + 1) { /* Single argument case, just target exist */
+        target_arg = &tokens->tokens[first];
+		type_of_source_arg = -2;
+	}
+	else { /* Two arguments case, with a comma between them */
+        source_arg = &tokens->tokens[first];
+        target_arg = &tokens->tokens[first + 2];
 	}
-    identifyAddressingMode(source_arg, target_arg, &type_of_source_arg, &type_of_target_arg);
+
+    if (source_arg != NULL) {
+        type_of_source_arg = identifyAddressingMode(source_arg);
+    }
+    if (target_arg != NULL) {
+        type_of_target_arg = identifyAddressingMode(target_arg);
+    }
 
         if (type_of_source_arg != -3 && type_of_source_arg != -2) {/*if its valid type*/
-            num_arg_source = detection_argument(source_arg + 1); /* Without the first character */
+            num_arg_source = source_arg->value; /* The value after the first character */
             
         }
 
         if (type_of_target_arg != -3 && type_of_target_arg != -2) {
-            num_arg_target = detection_argument(target_arg + 1); /* Without the first character */
+            num_arg_target = target_arg->value;
           
         }
 
@@ -248,160 +230,86 @@ int parsing_arg(char* name_of_opcode, char* arguments, char* first_word_to_binar
 		}
     
 
-    if (validateParameters(name_of_opcode, &num_of_opcode, type_of_target_arg, type_of_source_arg)) {
-        
-sprintf(first_word_to_binary, "%d,%d,%d", num_of_opcode, type_of_source_arg, type_of_target_arg);
-*fieldBitSize1 = 4;
-
-
-if (type_of_source_arg == -2) {
-   
-    if (type_of_target_arg == 0) {
-        
-        sprintf(second_word_to_binary, "%d", num_arg_target);
-        *fieldBitSize2 = 12;
-    } else if (type_of_target_arg > 1) {
-       
-        sprintf(second_word_to_binary, "0,0,0,%d", num_arg_target);
-        *fieldBitSize2 = 3;
-    } else if (type_of_target_arg == 1) {
-        
-        strcpy(second_word_to_binary, "");
-        *fieldBitSize2 = 0;
-    } else if(type_of_target_arg == -2){
-		sprintf(second_word_to_binary, "NULL");/*both empty*/
-    	*fieldBitSize3 = 0;
-	}
-   
-    sprintf(third_word_to_binary, "NULL");
-    *fieldBitSize3 = 0;
-} else {
- 
-     if (type_of_source_arg == 0) {
-        sprintf(second_word_to_binary, "%d", num_arg_source);
-        *fieldBitSize2 = 12;
-    } else if (type_of_source_arg > 1) {
-        sprintf(second_word_to_binary, "0,0,%d,0", num_arg_source);
-        *fieldBitSize2 = 3;
-    } else if (type_of_source_arg == 1) {
-        strcpy(second_word_to_binary, "");
-        *fieldBitSize2 = 0;
+    /* an immediate is not cut to the bits of its word */
+    if (type_of_source_arg == 0 && !operand_fits(num_arg_source)) {
+        report_at(line, "The immediate %.*s does not fit in an operand\n", (int)source_arg->length - 1, source_arg->start + 1);
+        return 0;
     }
-
-    if (type_of_target_arg == 0) {
-        sprintf(third_word_to_binary, "%d", num_arg_target);
-        *fieldBitSize3 = 12;
-    } else if (type_of_target_arg > 1) {
-        sprintf(third_word_to_binary, "0,0,0,%d", num_arg_target);
-        *fieldBitSize3 = 3;
-    } else if (type_of_target_arg == 1) {
-        strcpy(third_word_to_binary, ""); 
-        *fieldBitSize3 = 0;
+    if (type_of_target_arg == 0 && !operand_fits(num_arg_target)) {
+        report_at(line, "The immediate %.*s does not fit in an operand\n", (int)target_arg->length - 1, target_arg->start + 1);
+        return 0;
     }
-}
 
-if (type_of_source_arg > 1 && type_of_target_arg > 1) {
-    sprintf(second_word_to_binary, "0,0,%d,%d", num_arg_source, num_arg_target);
-    *fieldBitSize2 = 3;
-    
-    sprintf(third_word_to_binary, "NULL");
-    *fieldBitSize3 = 0;
-}
+    if (validateParameters(tokens->tokens[tokens->statement].value, &num_of_opcode, type_of_target_arg, type_of_source_arg)) {
+        words[0] = encode_first_word(num_of_opcode, type_of_source_arg, type_of_target_arg);
+        *word_count = 1;
 
-		return 1;
+        if (type_of_source_arg > 1 && type_of_target_arg > 1) {
+            /* two registers share one word */
+            words[(*word_count)++] = encode_register_word(num_arg_source, num_arg_target);
+            return 1;
+        }
+        if (type_of_source_arg != -2) {
+            words[(*word_count)++] = encode_argument_word(type_of_source_arg, num_arg_source, SOURCE_REGISTER_SHIFT);
+        }
+        if (type_of_target_arg != -2) {
+            words[(*word_count)++] = encode_argument_word(type_of_target_arg, num_arg_target, TARGET_REGISTER_SHIFT);
+        }
+        return 1;
     }
 	return 0;
 }
 
-void identifyAddressingMode(char* source_arg, char* target_arg, int* type_of_source_arg, int* type_of_target_arg) {
-    int i;
-    char first_char_of_source = *source_arg;
-    char first_char_of_target = *target_arg;
-
-    /* Determine source and target argument types */
-    for (i = 0; i < 3; i++) {
-        if (arr_type_of_arg[i].first_char == first_char_of_source) {
-            *type_of_source_arg = arr_type_of_arg[i].num_of_addressing_method;
-        }
-        if (arr_type_of_arg[i].first_char == first_char_of_target) {
-            *type_of_target_arg = arr_type_of_arg[i].num_of_addressing_method;
-        }
+int encode_argument_word(int addressing_mode, int value, int register_shift) {
+    if (addressing_mode == 0) {
+        return encode_operand_word(value, ARE_ABSOLUTE);
     }
-    if ((*type_of_source_arg == -3) && is_valid_label(source_arg)) {/*if the argument not null but not found ,check if could be label*/
-        *type_of_source_arg = 1;
+    if (addressing_mode > 1) {
+        return ((value & REGISTER_MASK) << register_shift) | ARE_ABSOLUTE;
     }
-    if ((*type_of_target_arg == -3) && is_valid_label(target_arg)) {
-        *type_of_target_arg = 1;
-    }
-    
+    /* the address of a label is known only in the second pass */
+    return UNRESOLVED_WORD;
 }
 
-
-int detection_argument(char* argument) {
-	if (is_valid_integer(argument)) {
-		return atoi(argument);
-	}
-	else if (reg_detection(argument)) {
-		return reg_detection(argument) - 1;
-	}
-	return -1;
+int identifyAddressingMode(token* argument) {
+    /* The addressing method is known from the first character of the argument */
+    switch (argument->kind) {
+    case TOKEN_IMMEDIATE:
+        return 0;
+    case TOKEN_INDIRECT:
+        return 2;
+    case TOKEN_REGISTER:
+        return 3;
+    default:
+        /* if the argument not null but not found, check if could be label */
+        return is_valid_label(argument->start, argument->length) ? 1 : -3;
+    }
 }
 
-int validateParameters(char* name_of_opcode, int* num_of_opcode, int type_of_target_arg, int type_of_source_arg) {
-	int i, j, k;
+int validateParameters(int opcode, int* num_of_opcode, int type_of_target_arg, int type_of_source_arg) {
+	int j, k;
 	int valid_source = 0, valid_target = 0;
-	for (i = 0; i < OPCODES_COUNT; i++) {
-		if (strcmp(name_of_opcode, OPCODES[i].name_of_opcode) == 0) {
-			*num_of_opcode = OPCODES[i].num_of_opcode;
-			for (j = 0; j < 4; j++) {
-				/* Check for valid target type */
-				if (type_of_target_arg == OPCODES[i].target_type[j]) {
-					valid_target = 1;
-					for (k = 0; k < 4; k++) {
-						/* Check for valid source type */
-						if (type_of_source_arg == OPCODES[i].source_type[k]) {
-							valid_source = 1;
-						}
-					}
+	*num_of_opcode = OPCODES[opcode].num_of_opcode;
+	for (j = 0; j < 4; j++) {
+		/* Check for valid target type */
+		if (type_of_target_arg == OPCODES[opcode].target_type[j]) {
+			valid_target = 1;
+			for (k = 0; k < 4; k++) {
+				/* Check for valid source type */
+				if (type_of_source_arg == OPCODES[opcode].source_type[k]) {
+					valid_source = 1;
 				}
 			}
 		}
 	}
 	return (valid_source && valid_target);
 }
-bool check_operand_start(char *operand) {
-    int i;
-    for (i = 0; i < 3; i++) {
-        if (operand[0] == arr_type_of_arg[i].first_char) {
-            return true;  
-        }
-    }
-    return false;  
-}
-
-int is_rest_of_line_valid(char *str) {  
-    
-    if (*str == '\0') {
-        return 1;  /*valid*/ 
-    }
-
-    while (*str) {
-
-        if (!isspace(*str)) {
-            return 0;/*not valid*/
-        }
-        str++;
-    }
-
-    return 1;  /*valid*/   
-}
-
-bool is_alphanumeric_string(const char* str) {
-    while (*str) {
-        if (!isalnum((unsigned char)*str)) {
+bool is_alphanumeric_slice(const char* str, size_t length) {
+    size_t i;
+    for (i = 0; i < length; i++) {
+        if (!isalnum((unsigned char)str[i])) {
             return false;  /*Found a non-alphanumeric character*/ 
         }
-        str++;
     }
     return true;  /*All characters are alphanumeric*/ 
 }
@@ -5,83 +5,61 @@
 /**
  * @brief Performs the second pass of the assembler process on the given file.
  *
- * This function reads an assembly source file, processes each line to handle labels, instructions, and entries,
- * and writes external labels to an external file and entry labels to an entry file. It also updates the instruction
- * and data images based on label addresses.
+ * This function resolves what the first pass recorded: it fills the addresses of the label operands
+ * in the instruction image, and appends the uses of external labels to the content of the ".ext" file and
+ * the entry labels to the content of the ".ent" file. The source is not read again.
  *
- * @param file_name Name of the source file to be processed.
- * @param label_head Pointer to the head of the linked list of labels.
- * @param list_head Pointer to the head of the linked list of instruction memory.
- * @param data_image_head Pointer to the head of the linked list of data images.
- * @return 1 if the second pass was successful, 0 otherwise.
+ * @param fixups The label operands and the .entry requests found by the first pass.
+ * @param symbols The symbol table.
+ * @param code The instruction image.
+ * @param ent_text The buffer that receives the ".ent" file.
+ * @param ext_text The buffer that receives the ".ext" file.
+ * @return 1 if every label operand was filled, 0 if the address of a label does not fit in its operand.
  */
-int implement_second_pass(char file_name[],label** label_head,instruction_memory **list_head,data_image **data_image_head);
+int implement_second_pass(fixup_list *fixups,symbol_table *symbols,memory_image *code,byte_buffer *ent_text,byte_buffer *ext_text);
 
 
 /**
- * @brief Processes each operand in a line to check for labels, convert their addresses to binary, and handle them accordingly.
+ * @brief Fills the addresses of the labels of the fixups in the instruction image.
  *
- * This function parses each operand in `rest_of_line`, checks if it's a label, and processes it based on the label's type.
- * If the label is external, its address is written to an external file `ext_p`. For other labels, the binary address is inserted
- * into the instruction and data images.
+ * This function goes over the fixups in the order of the lines and searches for their names in the symbol table.
+ * A label that is found fills the slot of its fixup, and if it is external the address of the slot is appended
+ * to the content of the ".ext" file. An operand that is not a label leaves its word unresolved, and a label
+ * whose address does not fit in an operand word is reported and leaves it unresolved too.
  *
- * @param ext_p Pointer to the file stream for external labels.
- * @param rest_of_line The line containing operands, which may include labels.
- * @param line The current line number being processed.
- * @param label_head Pointer to the head of the linked list of labels.
- * @param list_head Pointer to the head of the linked list of instruction memory.
- * @param data_image_head Pointer to the head of the linked list of data images.
+ * @param ext_text The buffer that receives the ".ext" file.
+ * @param fixups The fixups recorded by the first pass.
+ * @param symbols The symbol table.
+ * @param code The instruction image.
+ * @return 1 if every address fits in its operand, 0 otherwise.
  */
-void chek_for_label_argument(FILE *ext_p, char * rest_of_line,int line,label** label_head,instruction_memory **list_head,data_image **data_image_head);
+int resolve_fixups(byte_buffer *ext_text, fixup_list *fixups, symbol_table *symbols, memory_image *code);
 
 /**
- * @brief Checks if the given operand starts with one of the characters defined in the array.
+ * @brief Writes the encoded address of a label to the word of its operand.
  *
- * This function verifies if the first character of the operand matches any of the predefined characters
- * in the `arr_type_of_arg` array. It is used to determine the type of addressing mode based on the operand's prefix.
+ * The slot was taken when the word was stored in the first pass, so no word is searched for.
  *
- * @param operand The operand string to be checked.
- * @return `true` if the operand starts with one of the predefined characters; `false` otherwise.
+ * @param code The instruction image.
+ * @param slot The index of the word in the image, or -1 if the operand has no word.
+ * @param word The word with the label's address and its A/R/E field.
+ * @return The address of the word that was filled, or 0 if the operand has no word.
  */
-bool check_operand_start(char *operand);
-
-
-/**
- * @brief Inserts the binary address of a label into the instruction memory at a specific line.
- *
- * This function searches through the `instruction_memory` linked list for a node with the given line number.
- * If the node is found and its `binary_str` is empty, it updates the `binary_str` with the provided `address_label_binary`.
- *
- * @param head Pointer to the head of the `instruction_memory` linked list.
- * @param data_image_head Pointer to the head of the `data_image` linked list (not used in this function).
- * @param address_label_binary The binary representation of the label's address to be inserted.
- * @param line The line number where the label address should be inserted.
- */
-void insert_label_address(instruction_memory *head,data_image *data_image_head,char *address_label_binary,int line);
+int fill_slot(memory_image *code, int slot, int word);
 
 
 /**
  * @brief Checks if a label is valid for use as an entry and returns its address if valid.
  *
- * This function searches for a label in the linked list of labels to verify its existence and type. 
- * If the label is found and its type is not ".external", the function returns its address. 
- * If the label is not found or its type is ".external", an error message is printed.
+ * This function searches for a label in the symbol table to verify its existence and type. 
+ * If the label is found, the function returns its address, and a label of kind SYMBOL_EXTERNAL is reported. 
+ * If the label is not found, an error message is printed.
  *
- * @param name_of_label The name of the label to check.
- * @param label_head Pointer to the head of the `label` linked list.
+ * @param name_of_label The name of the label to check, it does not have to end with '\0'.
+ * @param length The number of characters in the name.
+ * @param symbols The symbol table.
+ * @param line The number of the .entry line, for the errors it reports.
  * 
  * @return The address of the label if it is valid for use as an entry; 0 otherwise.
  */
-int check_valid_entry(char* name_of_label, label* label_head);
-
-/**
- * @brief Finds the address of an instruction in memory based on its line number.
- *
- * This function searches through the `instruction_memory` linked list for a node with the specified line number.
- * If the node is found and its `binary_str` matches a specific binary pattern ("000000000000001"), the function returns the address of that instruction.
- *
- * @param head Pointer to the head of the `instruction_memory` linked list.
- * @param line The line number of the instruction whose address is to be found.
- * @return The address of the instruction if found, otherwise 0.
- */
-int find_address(instruction_memory *head,int line);
+int check_valid_entry(const char* name_of_label, size_t length, symbol_table* symbols, int line);
@@ -6,103 +6,55 @@
 #include "first_pass.h"
 #include "second_pass.h"
 #include "pre_assembler.h"
+#include "report.h"
 
 
-void chek_for_label_argument(FILE *ext_p, char * rest_of_line, int line, label** label_head,instruction_memory **list_head,data_image **data_image_head ) {
+int resolve_fixups(byte_buffer *ext_text, fixup_list *fixups, symbol_table *symbols, memory_image *code) {
     label  *label;
-    
+    fixup *current;
     int address;
-    int found;
-    char *token;
-    
-    
-    char address_label[MAX_LINE_LENGTH]; 
-    char address_label_binary[MAX_LINE_LENGTH];
-    char rest_of_line_copy[MAX_LINE_LENGTH] = {0};
-
-
-    strncpy(rest_of_line_copy, rest_of_line, MAX_LINE_LENGTH);
-    
-    token = strtok(rest_of_line_copy, ",");
-    
-    while (token != NULL) {
-        
-        if (!check_operand_start(token)) { 
-            label = search_label_on_list(*label_head, token, &found);
-            if (label) {
-                sprintf(address_label, "%d", label->address_of_label);
-                sprintf(address_label_binary, "%d", label->address_of_label);
-               
-                if (strcmp(".external", label->type_of_label) == 0) {
-                    
-                    convert_str_to_binary(12, address_label_binary, "001");
-                    
-                    insert_label_address(*list_head,*data_image_head, address_label_binary,line);
-                    address = find_address( *list_head,line);
-                        
-                        fprintf(ext_p, "%s          %d\n",label->name_of_label, address);
-                    
-                } else {
-                    
-                    convert_str_to_binary(12, address_label_binary, "010");
-                    
-                    insert_label_address(*list_head,*data_image_head, address_label_binary,line);
-                }
-           
+    int i, is_valid = 1;
+    char line[MAX_LABEL_LENGTH + 32];
+
+    for (i = 0; i < fixups->count; i++) {
+        current = &fixups->fixups[i];
+        label = search_label(symbols, current->name, current->name_length);
+        /* an operand that is not a label leaves its word unresolved */
+        if (label) {
+            if (label->kind == SYMBOL_EXTERNAL) {
+                address = fill_slot(code, current->slot, encode_operand_word(label->address_of_label, ARE_EXTERNAL));
+                append_to_buffer(ext_text, line, (size_t)sprintf(line, "%s          %d\n", label_name(symbols, label), address));
+            } else if (operand_fits(label->address_of_label)) {
+                fill_slot(code, current->slot, encode_operand_word(label->address_of_label, ARE_RELOCATABLE));
+            } else {
+                report_at(current->line, "The address %d of the label %s in line %d does not fit in an operand\n",
+                    label->address_of_label, label_name(symbols, label), current->line);
+                is_valid = 0;
+            }
         }
-        
     }
-    token = strtok(NULL, ","); 
-}
+    return is_valid;
 }
 
-void insert_label_address(instruction_memory *head,data_image *data_image_head,char *address_label_binary,int line) {
-    
-    instruction_memory *current1 = head;
-    
-    while (current1 != NULL) {
-        
-       if (current1->line == line && current1->binary_str[0]=='\0'){
-        
-            current1->binary_str = duplicate(address_label_binary);
-            return;
-       }
-        current1 = current1->next;
-    }  
-
+int fill_slot(memory_image *code, int slot, int word) {
+    if (slot == -1) {
+        return 0;
+    }
+    code->words[slot] = (unsigned short)word;
+    return code->base + slot;
 }
 
-int check_valid_entry(char* name_of_label, label* label_head) {
-	label* lbl = find_label_by_name(name_of_label, label_head);
+int check_valid_entry(const char* name_of_label, size_t length, symbol_table* symbols, int line) {
+	label* lbl = search_label(symbols, name_of_label, length);
 	if (lbl != NULL) {
-        if(strcmp(lbl->type_of_label,".external") == 0){
-            printf("A label cannot be defined as external and entry in the same file\n");
+        if(lbl->kind == SYMBOL_EXTERNAL){
+            report_at(line, "A label cannot be defined as external and entry in the same file\n");
         }
 
 		return lbl->address_of_label;/*return the address*/
 	}
 	else {
-		printf("Label %s not found in current file and can't defined as entry\n", name_of_label);
+		report_at(line, "Label %.*s not found in current file and can't defined as entry\n", (int)length, name_of_label);
 		return 0;
 	}
 }
-
-
-
-int find_address(instruction_memory *head,int line) {
-    
-    instruction_memory *current1 = head;
-    
-    
-    while (current1 != NULL) {
-        
-       if (current1->line == line && !strcmp(current1->binary_str,"000000000000001")){/*if there differenc extern?*/
-        return current1->address;
-            
-       }
-        current1 = current1->next;
-    } 
-    return 0; 
-
-}
-
@@ -0,0 +1,639 @@
+#define _XOPEN_SOURCE 700
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+#include "globals.h"
+#include "server.h"
+#include "batch.h"
+#include "report.h"
+#include "pre_assembler.h"
+#include "first_pass.h"
+#include "cache.h"
+
+extern char *CACHED_ENDINGS[];
+
+/* The answer to a request is a list of records, a tag for the stream, the length of the text, '\n' and the text */
+#define RECORD_OUT 'o'
+#define RECORD_ERR 'e'
+
+/* The time to wait for more changes after a file in a watched directory was written, in milliseconds */
+#define WATCH_SETTLE_MS 50
+
+/* A file of a request, with the state of its source when the request came */
+typedef struct requested_file {
+	warm_file *file;
+	char *given_name;   /* the name as the request gave it, the messages of the file are sent with it */
+	struct stat st;
+	int found;      /* 1 if the source exists */
+	int changed;    /* 1 if the source changed since the file was assembled */
+	int order;      /* the place of the file in the request */
+} requested_file;
+
+void init_server(assembler_server *server, assembler_options *options, char *options_key, result_cache *cache) {
+	char dir[4096];
+
+	int i;
+
+	server->capacity = SERVER_FILES_INIT_SIZE;
+	server->slots = handle_malloc(server->capacity * sizeof(int), ALLOC_TABLES);
+	for (i = 0; i < server->capacity; i++) {
+		server->slots[i] = EMPTY_SLOT;
+	}
+	/* the table is at most half full, so the files need half as many places as the slots */
+	server->files = handle_malloc((server->capacity / 2) * sizeof(warm_file *), ALLOC_TABLES);
+	server->count = 0;
+	init_batch_worker(&server->worker, 0, options, options_key, cache);
+	server->dir = duplicate((getcwd(dir, sizeof(dir)) != NULL) ? dir : ".");
+	server->requests = 0;
+	server->total_usec = 0;
+	server->max_usec = 0;
+}
+
+static long elapsed_usec(struct timespec *start) {
+	struct timespec end;
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	return (long)(end.tv_sec - start->tv_sec) * 1000000L + (end.tv_nsec - start->tv_nsec) / 1000;
+}
+
+/* writes all the characters, a write may take only some of them */
+static int write_all(int fd, const char *data, size_t length) {
+	ssize_t written;
+	while (length > 0) {
+		written = write(fd, data, length);
+		if (written < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return 0;
+		}
+		data += written;
+		length -= (size_t)written;
+	}
+	return 1;
+}
+
+static void send_record(int fd, char tag, byte_buffer *text) {
+	char header[32];
+	if (text->length > 0) {
+		sprintf(header, "%c %lu\n", tag, (unsigned long)text->length);
+		if (write_all(fd, header, strlen(header))) {
+			write_all(fd, text->data, text->length);
+		}
+	}
+}
+
+/* sends the messages of a file to a connection, or prints them */
+static void send_diagnostics(int fd, diagnostics *diag) {
+	if (fd == -1) {
+		flush_diagnostics(diag);
+		fflush(stdout);
+		return;
+	}
+	send_record(fd, RECORD_OUT, &diag->out);
+	send_record(fd, RECORD_ERR, &diag->err);
+}
+
+/* copies the messages with every use of the absolute name of a file replaced by the name the request gave */
+static void rename_messages(byte_buffer *renamed, byte_buffer *text, char *name, char *given_name) {
+	size_t length = strlen(name), start = 0, i;
+
+	for (i = 0; i + length <= text->length; i++) {
+		if (memcmp(text->data + i, name, length) == 0) {
+			append_to_buffer(renamed, text->data + start, i - start);
+			append_to_buffer(renamed, given_name, strlen(given_name));
+			start = i + length;
+			i = start - 1;
+		}
+	}
+	if (start < text->length) {
+		append_to_buffer(renamed, text->data + start, text->length - start);
+	}
+}
+
+/* sends the kept messages of a file as if it was assembled by the name of the request */
+static void send_file_diagnostics(int fd, warm_file *file, char *given_name) {
+	diagnostics renamed;
+
+	if (strcmp(file->name, given_name) == 0) {
+		send_diagnostics(fd, &file->diag);
+		return;
+	}
+	init_diagnostics(&renamed);
+	rename_messages(&renamed.out, &file->diag.out, file->name, given_name);
+	rename_messages(&renamed.err, &file->diag.err, file->name, given_name);
+	send_diagnostics(fd, &renamed);
+	free_diagnostics(&renamed);
+}
+
+/* reads a whole file into a buffer, returns 0 if it cannot be opened */
+static int load_file(char *name, byte_buffer *buffer) {
+	char chunk[BUFFER_INIT_SIZE * 16];
+	size_t count;
+	FILE *fp = fopen(name, "rb");
+
+	buffer->length = 0;
+	if (fp == NULL) {
+		return 0;
+	}
+	while ((count = fread(chunk, 1, sizeof(chunk), fp)) > 0) {
+		append_to_buffer(buffer, chunk, count);
+	}
+	fclose(fp);
+	return 1;
+}
+
+static void save_file(char *name, byte_buffer *buffer) {
+	FILE *fp = fopen(name, "wb");
+	if (fp == NULL) {
+		return;
+	}
+	fwrite(buffer->data, 1, buffer->length, fp);
+	fclose(fp);
+}
+
+/* puts a file of the table in the first empty slot after the slot of its hash */
+static void insert_warm_slot(assembler_server *server, int index) {
+	int mask = server->capacity - 1;
+	int i = (int)(server->files[index]->hash & mask);
+
+	while (server->slots[i] != EMPTY_SLOT) {
+		i = (i + 1) & mask;
+	}
+	server->slots[i] = index;
+}
+
+/* finds the file of a request by its absolute path, or adds it */
+static warm_file *find_warm_file(assembler_server *server, char *dir, char *name) {
+	unsigned long hash;
+	warm_file *file;
+	char *key;
+	int mask, i;
+
+	key = canonical_path((dir != NULL) ? dir : server->dir, name);
+	hash = hash_name(key, strlen(key));
+	/* linear probing until an empty slot, the paths are compared only when the hashes are equal */
+	mask = server->capacity - 1;
+	for (i = (int)(hash & mask); server->slots[i] != EMPTY_SLOT; i = (i + 1) & mask) {
+		file = server->files[server->slots[i]];
+		if (file->hash == hash && strcmp(file->name, key) == 0) {
+			handle_free(key);
+			return file;
+		}
+	}
+	/* keep the table at most half full */
+	if ((server->count + 1) * 2 > server->capacity) {
+		server->capacity *= 2;
+		handle_free(server->slots);
+		server->slots = handle_malloc(server->capacity * sizeof(int), ALLOC_TABLES);
+		for (i = 0; i < server->capacity; i++) {
+			server->slots[i] = EMPTY_SLOT;
+		}
+		server->files = handle_realloc(server->files, (server->capacity / 2) * sizeof(warm_file *), ALLOC_TABLES);
+		for (i = 0; i < server->count; i++) {
+			insert_warm_slot(server, i);
+		}
+	}
+	file = handle_malloc(sizeof(warm_file), ALLOC_TABLES);
+	server->files[server->count] = file;
+	file->name = key;
+	file->hash = hash;
+	file->size = -1; /* never assembled */
+	file->mtime = 0;
+	file->mtime_nsec = 0;
+	init_diagnostics(&file->diag);
+	for (i = 0; i < CACHED_ENDINGS_COUNT; i++) {
+		init_buffer(&file->outputs[i]);
+		file->has_output[i] = 0;
+	}
+	insert_warm_slot(server, server->count++);
+	return file;
+}
+
+/* a file is assembled again unless its source has the same size and modification time as the last time */
+static int source_changed(warm_file *file, requested_file *request) {
+	return !request->found || file->size == -1 || file->size != (long)request->st.st_size ||
+		file->mtime != (long)request->st.st_mtim.tv_sec || file->mtime_nsec != (long)request->st.st_mtim.tv_nsec;
+}
+
+static void assemble_warm_file(assembler_server *server, warm_file *file, requested_file *request) {
+	assembly_result *result = &server->worker.result;
+	char *output;
+	int i, assembled;
+
+	/* the file is assembled by its absolute path, the messages are renamed for every request */
+	free_diagnostics(&file->diag);
+	init_diagnostics(&file->diag);
+	capture_reports(&file->diag);
+	assembled = assemble_file(file->name, &server->worker);
+	capture_reports(NULL);
+
+	/* the output files are kept, so they can be written again if they are removed */
+	for (i = 0; i < CACHED_ENDINGS_COUNT; i++) {
+		if (assembled) {
+			file->outputs[i].length = 0;
+			file->has_output[i] = result->has_output[i];
+			if (result->has_output[i] && result->outputs[i].length > 0) {
+				append_to_buffer(&file->outputs[i], result->outputs[i].data, result->outputs[i].length);
+			}
+		}
+		else {
+			/* the files were restored from the cache, or kept from before when the source could not be read */
+			output = add_new_file(file->name, CACHED_ENDINGS[i]);
+			file->has_output[i] = load_file(output, &file->outputs[i]);
+			handle_free(output);
+		}
+	}
+	/* the state of the source before the assembly, a change during it is found by the next request */
+	file->size = request->found ? (long)request->st.st_size : -1;
+	file->mtime = (long)request->st.st_mtim.tv_sec;
+	file->mtime_nsec = (long)request->st.st_mtim.tv_nsec;
+}
+
+static void restore_outputs(warm_file *file) {
+	struct stat st;
+	char *output;
+	int i;
+
+	for (i = 0; i < CACHED_ENDINGS_COUNT; i++) {
+		if (file->has_output[i]) {
+			output = add_new_file(file->name, CACHED_ENDINGS[i]);
+			if (stat(output, &st) != 0) {
+				save_file(output, &file->outputs[i]);
+			}
+			handle_free(output);
+		}
+	}
+}
+
+/* the changed files first, the most recently modified first, and then the others in the order of the request */
+static int compare_requested_files(const void *a, const void *b) {
+	const requested_file *first = a, *second = b;
+
+	if (first->changed != second->changed) {
+		return second->changed - first->changed;
+	}
+	if (first->changed && first->st.st_mtim.tv_sec != second->st.st_mtim.tv_sec) {
+		return (first->st.st_mtim.tv_sec > second->st.st_mtim.tv_sec) ? -1 : 1;
+	}
+	if (first->changed && first->st.st_mtim.tv_nsec != second->st.st_mtim.tv_nsec) {
+		return (first->st.st_mtim.tv_nsec > second->st.st_mtim.tv_nsec) ? -1 : 1;
+	}
+	return first->order - second->order;
+}
+
+int serve_files(assembler_server *server, char *dir, char **names, int count, int fd) {
+	requested_file *requests;
+	char *as_file;
+	int assembled = 0;
+	int i;
+
+	if (count == 0) {
+		return 0;
+	}
+	requests = handle_malloc(count * sizeof(requested_file), ALLOC_TABLES);
+	for (i = 0; i < count; i++) {
+		requests[i].file = find_warm_file(server, dir, names[i]);
+		requests[i].given_name = names[i];
+		as_file = add_new_file(requests[i].file->name, ".as");
+		requests[i].found = (stat(as_file, &requests[i].st) == 0);
+		if (!requests[i].found) {
+			memset(&requests[i].st, 0, sizeof(struct stat));
+		}
+		requests[i].changed = source_changed(requests[i].file, &requests[i]);
+		requests[i].order = i;
+		handle_free(as_file);
+	}
+	qsort(requests, count, sizeof(requested_file), compare_requested_files);
+
+	for (i = 0; i < count; i++) {
+		/* a file named twice is assembled once, the second time it is unchanged */
+		if (source_changed(requests[i].file, &requests[i])) {
+			assemble_warm_file(server, requests[i].file, &requests[i]);
+			assembled++;
+		}
+		else {
+			restore_outputs(requests[i].file);
+		}
+		send_file_diagnostics(fd, requests[i].file, requests[i].given_name);
+	}
+	handle_free(requests);
+	return assembled;
+}
+
+/* reads a request and answers it, returns 0 if it asks the server to stop */
+static int serve_request(assembler_server *server, int fd) {
+	struct timespec start;
+	byte_buffer request, stats;
+	char chunk[BUFFER_INIT_SIZE * 16];
+	char **names;
+	char *line, *end;
+	ssize_t count;
+	long usec;
+	char *dir = NULL;
+	int name_count = 0, running = 1, assembled = 0;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	init_buffer(&request);
+	while ((count = read(fd, chunk, sizeof(chunk))) != 0) {
+		if (count < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			break;
+		}
+		append_to_buffer(&request, chunk, (size_t)count);
+	}
+	append_to_buffer(&request, "\n", 2);
+
+	/* a name on every line, there are at most as many names as characters */
+	names = handle_malloc(request.length * sizeof(char *), ALLOC_TABLES);
+	for (line = request.data; *line != '\0'; line = end + 1) {
+		end = strchr(line, '\n');
+		*end = '\0';
+		if (strcmp(line, "!shutdown") == 0) {
+			running = 0;
+		}
+		else if (strncmp(line, "!cwd ", 5) == 0) {
+			dir = line + 5;
+		}
+		else if (*line != '\0') {
+			names[name_count++] = line;
+		}
+	}
+	/* the files are assembled in the directory of the client, so the messages and the output files are the same as there */
+	if (dir != NULL && chdir(dir) != 0) {
+		init_buffer(&stats);
+		sprintf(chunk, "Failed to enter the directory: %.*s\n", (int)(sizeof(chunk) / 2), dir);
+		append_to_buffer(&stats, chunk, strlen(chunk));
+		send_record(fd, RECORD_OUT, &stats);
+		free_buffer(&stats);
+	}
+	else {
+		assembled = serve_files(server, dir, names, name_count, fd);
+	}
+	if (dir != NULL && chdir(server->dir) != 0) {
+		printf("Failed to enter the directory: %s\n", server->dir);
+	}
+
+	usec = elapsed_usec(&start);
+	server->requests++;
+	server->total_usec += usec;
+	if (usec > server->max_usec) {
+		server->max_usec = usec;
+	}
+	printf("Request: %d files, %d assembled, %ld us\n", name_count, assembled, usec);
+	if (!running) {
+		init_buffer(&stats);
+		sprintf(chunk, "Requests: %ld, mean latency: %ld us, max latency: %ld us\n", server->requests,
+			server->total_usec / server->requests, server->max_usec);
+		append_to_buffer(&stats, chunk, strlen(chunk));
+		send_record(fd, RECORD_OUT, &stats);
+		free_buffer(&stats);
+	}
+	fflush(stdout);
+	handle_free(names);
+	free_buffer(&request);
+	return running;
+}
+
+#ifdef __linux__
+/* assembles the ".as" files that were written in the watched directories, the events are read until they settle */
+static void serve_watch_events(assembler_server *server, int watch_fd, int *wds, char **dirs, int dir_count) {
+	char events[4096];
+	struct pollfd pfd;
+	struct inotify_event *event;
+	char **names = NULL;
+	char *name;
+	size_t length;
+	ssize_t count;
+	int name_count = 0, name_capacity = 0;
+	int i, j;
+
+	pfd.fd = watch_fd;
+	pfd.events = POLLIN;
+	do {
+		count = read(watch_fd, events, sizeof(events));
+		for (i = 0; count > 0 && i < count; i += (int)(sizeof(struct inotify_event) + event->len)) {
+			event = (struct inotify_event *)(events + i);
+			length = (event->len > 0) ? strlen(event->name) : 0;
+			if (length <= 3 || strcmp(event->name + length - 3, ".as") != 0) {
+				continue;
+			}
+			for (j = 0; j < dir_count && wds[j] != event->wd; j++)
+				;
+			if (j == dir_count) {
+				continue;
+			}
+			name = handle_malloc(strlen(dirs[j]) + length + 2, ALLOC_FILE_NAMES);
+			sprintf(name, "%s/%.*s", dirs[j], (int)(length - 3), event->name);
+			for (j = 0; j < name_count && strcmp(names[j], name) != 0; j++)
+				;
+			if (j < name_count) {
+				handle_free(name);
+				continue;
+			}
+			if (name_count == name_capacity) {
+				name_capacity = (name_capacity == 0) ? SERVER_FILES_INIT_SIZE : name_capacity * 2;
+				names = handle_realloc(names, name_capacity * sizeof(char *), ALLOC_TABLES);
+			}
+			names[name_count++] = name;
+		}
+	} while (poll(&pfd, 1, WATCH_SETTLE_MS) > 0);
+
+	serve_files(server, NULL, names, name_count, -1);
+	for (i = 0; i < name_count; i++) {
+		handle_free(names[i]);
+	}
+	handle_free(names);
+}
+#endif
+
+int serve(assembler_server *server, char *socket_path, char **dirs, int dir_count) {
+	struct sockaddr_un addr;
+	struct pollfd fds[2];
+	int nfds = 1;
+	int listener, connection;
+	int running = 1;
+	int wds[MAX_WATCHED_DIRS];
+	char *watched[MAX_WATCHED_DIRS];
+	int i;
+
+	if (strlen(socket_path) >= sizeof(addr.sun_path)) {
+		printf("The socket path is too long: %s\n", socket_path);
+		return 0;
+	}
+	listener = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (listener < 0) {
+		printf("Failed to open a socket\n");
+		return 0;
+	}
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strcpy(addr.sun_path, socket_path);
+	unlink(socket_path); /* the socket of a server that did not stop */
+	if (bind(listener, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(listener, SOMAXCONN) != 0) {
+		printf("Failed to listen on the socket: %s\n", socket_path);
+		close(listener);
+		return 0;
+	}
+	/* a client that leaves early must not stop the server */
+	signal(SIGPIPE, SIG_IGN);
+	fds[0].fd = listener;
+	fds[0].events = POLLIN;
+
+	if (dir_count > 0) {
+#ifdef __linux__
+		fds[1].fd = inotify_init();
+		fds[1].events = POLLIN;
+		for (i = 0; i < dir_count; i++) {
+			/* the files are named by absolute paths, as in the requests */
+			watched[i] = realpath(dirs[i], NULL);
+			wds[i] = (watched[i] != NULL) ? inotify_add_watch(fds[1].fd, watched[i], IN_CLOSE_WRITE | IN_MOVED_TO) : -1;
+			if (wds[i] < 0) {
+				printf("Failed to watch the directory: %s\n", dirs[i]);
+			}
+		}
+		nfds = 2;
+#else
+		printf("Watching directories is not supported on this system\n");
+#endif
+	}
+	printf("Listening on %s\n", socket_path);
+	fflush(stdout);
+
+	while (running) {
+		if (poll(fds, nfds, -1) < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			break;
+		}
+#ifdef __linux__
+		if (nfds == 2 && (fds[1].revents & POLLIN)) {
+			serve_watch_events(server, fds[1].fd, wds, watched, dir_count);
+		}
+#endif
+		if (fds[0].revents & POLLIN) {
+			connection = accept(listener, NULL, NULL);
+			if (connection >= 0) {
+				running = serve_request(server, connection);
+				close(connection);
+			}
+		}
+	}
+	if (nfds == 2) {
+		close(fds[1].fd);
+		for (i = 0; i < dir_count; i++) {
+			free(watched[i]);
+		}
+	}
+	close(listener);
+	unlink(socket_path);
+	return 1;
+}
+
+/* prints the records of an answer that are complete, and returns the number of characters they took */
+static size_t print_records(char *data, size_t length) {
+	size_t used = 0, text_length;
+	char *newline;
+
+	while ((newline = memchr(data + used, '\n', length - used)) != NULL) {
+		text_length = strtoul(data + used + 2, NULL, 10);
+		if ((size_t)(newline + 1 - data) + text_length > length) {
+			break;
+		}
+		fwrite(newline + 1, 1, text_length, (data[used] == RECORD_ERR) ? stderr : stdout);
+		used = (size_t)(newline + 1 - data) + text_length;
+	}
+	return used;
+}
+
+int run_client(char *socket_path, char **names, int count, int stop_server) {
+	struct sockaddr_un addr;
+	byte_buffer answer;
+	char chunk[BUFFER_INIT_SIZE * 16];
+	char cwd[4096];
+	size_t used;
+	ssize_t received;
+	int fd, i;
+
+	if (strlen(socket_path) >= sizeof(addr.sun_path) || getcwd(cwd, sizeof(cwd)) == NULL) {
+		printf("Failed to connect to the server: %s\n", socket_path);
+		return 0;
+	}
+	fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strcpy(addr.sun_path, socket_path);
+	if (fd < 0 || connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+		printf("Failed to connect to the server: %s\n", socket_path);
+		if (fd >= 0) {
+			close(fd);
+		}
+		return 0;
+	}
+	/* the server has a directory of its own, so the names are sent with the directory of the client */
+	write_all(fd, "!cwd ", 5);
+	write_all(fd, cwd, strlen(cwd));
+	write_all(fd, "\n", 1);
+	for (i = 0; i < count; i++) {
+		write_all(fd, names[i], strlen(names[i]));
+		write_all(fd, "\n", 1);
+	}
+	if (stop_server) {
+		write_all(fd, "!shutdown\n", 10);
+	}
+	shutdown(fd, SHUT_WR);
+
+	/* the messages of every file are printed as soon as they arrive */
+	init_buffer(&answer);
+	while ((received = read(fd, chunk, sizeof(chunk))) != 0) {
+		if (received < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			break;
+		}
+		append_to_buffer(&answer, chunk, (size_t)received);
+		used = print_records(answer.data, answer.length);
+		memmove(answer.data, answer.data + used, answer.length - used);
+		answer.length -= used;
+		fflush(stdout);
+	}
+	close(fd);
+	free_buffer(&answer);
+	return 1;
+}
+
+void free_server(assembler_server *server) {
+	int i, j;
+
+	if (server->requests > 0) {
+		printf("Requests: %ld, mean latency: %ld us, max latency: %ld us\n", server->requests,
+			server->total_usec / server->requests, server->max_usec);
+	}
+	for (i = 0; i < server->count; i++) {
+		handle_free(server->files[i]->name);
+		free_diagnostics(&server->files[i]->diag);
+		for (j = 0; j < CACHED_ENDINGS_COUNT; j++) {
+			free_buffer(&server->files[i]->outputs[j]);
+		}
+		handle_free(server->files[i]);
+	}
+	handle_free(server->files);
+	handle_free(server->slots);
+	handle_free(server->dir);
+	free_batch_worker(&server->worker);
+}
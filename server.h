@@ -0,0 +1,96 @@
+#ifndef LABRATORY_C_FINAL_PROJECT_SERVER_H
+#define LABRATORY_C_FINAL_PROJECT_SERVER_H
+
+#include "globals.h"
+#include "batch.h"
+
+/* The number of files the server remembers before its table grows */
+#define SERVER_FILES_INIT_SIZE 64
+
+/* The number of directories that can be watched for changes */
+#define MAX_WATCHED_DIRS 16
+
+/*This struct holds what the server keeps of a file between requests*/
+typedef struct warm_file {
+    char *name;         /*The absolute path of the file without its extension, the same for every name of the file*/
+    unsigned long hash; /*The hash of the name*/
+    long size;          /*The size of the ".as" file when it was assembled*/
+    long mtime;         /*The time the ".as" file was modified, in seconds*/
+    long mtime_nsec;    /*The nanoseconds of the time the ".as" file was modified*/
+    diagnostics diag;   /*The messages of the last assembly, they name the file by its absolute path*/
+    byte_buffer outputs[CACHED_ENDINGS_COUNT];  /*The output files of the last assembly*/
+    int has_output[CACHED_ENDINGS_COUNT];       /*1 for every output file the last assembly wrote*/
+} warm_file;
+
+/*This struct holds the state of a long running assembler, it is kept warm between requests.
+  The files are an open addressing hash table keyed on their absolute path*/
+typedef struct assembler_server {
+    int *slots;         /*The slots of the table, the index of a file or EMPTY_SLOT*/
+    int capacity;       /*The number of slots, always a power of 2*/
+    warm_file **files;  /*The files in the order they were added, there is room for capacity / 2 of them.
+                          Every file is allocated on its own, so it does not move when the table grows*/
+    int count;          /*The number of files*/
+    batch_worker worker;    /*The arena, the options and the cache, used for every file*/
+    char *dir;          /*The directory the server was started in, it returns to it after every request*/
+    long requests;      /*The number of requests served*/
+    long total_usec;    /*The total time of the requests in microseconds*/
+    long max_usec;      /*The time of the slowest request in microseconds*/
+} assembler_server;
+
+/**
+ * @brief Initializes a server with no files.
+ *
+ * @param server The server to initialize.
+ * @param options The options of the assembler, used for every request.
+ * @param options_key The options that are part of the cache key.
+ * @param cache The result cache, or NULL if it is not used.
+ */
+void init_server(assembler_server *server, assembler_options *options, char *options_key, result_cache *cache);
+
+/**
+ * @brief Serves requests on a Unix socket, and reassembles the files of watched directories when they are saved.
+ *
+ * A request is a "!cwd" line with the directory of the client, and then a file name on every line,
+ * without the extension. The files whose source changed since they
+ * were assembled are assembled again, the most recently modified first, and the others are answered from memory.
+ * The messages of every file are sent back as soon as it is done. A "!shutdown" line stops the server.
+ *
+ * @param server The server.
+ * @param socket_path The path of the socket.
+ * @param dirs The directories to watch, their ".as" files are assembled when they are written.
+ * @param dir_count The number of directories to watch.
+ * @return 1 when the server was stopped by a request, 0 if the socket could not be opened.
+ */
+int serve(assembler_server *server, char *socket_path, char **dirs, int dir_count);
+
+/**
+ * @brief Answers the files of a request, assembling only the files whose source changed.
+ *
+ * @param server The server.
+ * @param dir The directory of the request, the current directory, or NULL if the names are absolute.
+ * @param names The names of the files without their extensions.
+ * @param count The number of files.
+ * @param fd The connection that receives the messages, or -1 to print them.
+ * @return The number of files that were assembled.
+ */
+int serve_files(assembler_server *server, char *dir, char **names, int count, int fd);
+
+/**
+ * @brief Sends files to a server and prints its answer, as if the files were assembled here.
+ *
+ * @param socket_path The path of the socket of the server.
+ * @param names The names of the files without their extensions.
+ * @param count The number of files.
+ * @param stop_server 1 to stop the server after the files.
+ * @return 1 if the server answered, 0 otherwise.
+ */
+int run_client(char *socket_path, char **names, int count, int stop_server);
+
+/**
+ * @brief Prints the latency of the requests of a server and releases it.
+ *
+ * @param server The server.
+ */
+void free_server(assembler_server *server);
+
+#endif
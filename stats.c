@@ -0,0 +1,52 @@
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "globals.h"
+#include "stats.h"
+#include "report.h"
+
+static const char *STATS_STAGE_NAMES[STATS_STAGES_COUNT] = {
+	"read", "pre_assembler", "normalize", "first_pass", "second_pass", "object", "write"
+};
+
+long stats_clock(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (long)now.tv_sec * 1000000000L + now.tv_nsec;
+}
+
+void init_assembly_stats(assembly_stats *stats) {
+	memset(stats, 0, sizeof(assembly_stats));
+}
+
+void report_stats(char *file_name, assembly_stats *stats, int format) {
+	long total = 0;
+	int i;
+
+	/* the normalization is counted in the time of the pre-assembler */
+	for (i = 0; i < STATS_STAGES_COUNT; i++) {
+		total += (i != STATS_NORMALIZE) ? stats->nanoseconds[i] : 0;
+	}
+	if (format == STATS_JSON) {
+		report("{\"file\": \"%s\", \"microseconds\": {", file_name);
+		for (i = 0; i < STATS_STAGES_COUNT; i++) {
+			report("\"%s\": %ld, ", STATS_STAGE_NAMES[i], stats->nanoseconds[i] / 1000);
+		}
+		report("\"total\": %ld}, \"source_lines\": %ld, \"expanded_lines\": %ld, \"macros\": %ld, \"macro_calls\": %ld, "
+			"\"labels\": %ld, \"instruction_words\": %ld, \"data_words\": %ld, \"fixups\": %ld, \"entries\": %ld, "
+			"\"bytes_read\": %ld, \"bytes_written\": %ld}\n", total / 1000, stats->source_lines, stats->expanded_lines,
+			stats->macros, stats->macro_calls, stats->labels, stats->instruction_words, stats->data_words, stats->fixups,
+			stats->entries, stats->bytes_read, stats->bytes_written);
+		return;
+	}
+	report("Stats for %s:\n", file_name);
+	for (i = 0; i < STATS_STAGES_COUNT; i++) {
+		report("  %-14s %10.3f ms%s\n", STATS_STAGE_NAMES[i], stats->nanoseconds[i] / 1e6, (i == STATS_NORMALIZE) ? " (in pre_assembler)" : "");
+	}
+	report("  %-14s %10.3f ms\n", "total", total / 1e6);
+	report("  lines: %ld source, %ld expanded; macros: %ld, %ld calls; labels: %ld; fixups: %ld; entries: %ld\n",
+		stats->source_lines, stats->expanded_lines, stats->macros, stats->macro_calls, stats->labels, stats->fixups, stats->entries);
+	report("  words: %ld instruction, %ld data; bytes: %ld read, %ld written\n",
+		stats->instruction_words, stats->data_words, stats->bytes_read, stats->bytes_written);
+}
@@ -0,0 +1,32 @@
+#ifndef LABRATORY_C_FINAL_PROJECT_STATS_H
+#define LABRATORY_C_FINAL_PROJECT_STATS_H
+
+#include "globals.h"
+
+/**
+ * @brief Returns the time of a monotonic clock, for the statistics.
+ *
+ * @return The time in nanoseconds from an arbitrary start.
+ */
+long stats_clock(void);
+
+/**
+ * @brief Sets the times and the counts of statistics to zero.
+ *
+ * @param stats The statistics to initialize.
+ */
+void init_assembly_stats(assembly_stats *stats);
+
+/**
+ * @brief Prints the statistics of a file through report, so they are kept with the other messages of the file.
+ *
+ * The text format shows the time of every stage in milliseconds and the counts on two lines,
+ * the JSON format is a single line with the times in microseconds.
+ *
+ * @param file_name The name of the source file.
+ * @param stats The statistics.
+ * @param format STATS_TEXT or STATS_JSON.
+ */
+void report_stats(char *file_name, assembly_stats *stats, int format);
+
+#endif
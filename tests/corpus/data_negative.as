@@ -0,0 +1,2 @@
+MAIN: stop
+.data -40000
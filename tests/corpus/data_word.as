@@ -0,0 +1,2 @@
+MAIN: stop
+X: .data 40000
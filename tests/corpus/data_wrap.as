@@ -0,0 +1,2 @@
+MAIN: stop
+X: .data 1, 4294967296
@@ -0,0 +1,16 @@
+MAIN: mov #4095, r1
+prn #-2048
+prn #2047
+prn #0
+cmp *r7, #-5
+add r0, *r2
+lea MAIN, r3
+jmp *r4
+sub #+12, r5
+.data 16383, -16384, 32767, -1, 0
+.string "az"
+X: .data 7
+stop
+.extern EXT
+jsr EXT
+mov EXT, MAIN
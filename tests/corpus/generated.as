@@ -0,0 +1,1000 @@
+; lines=1000 labels=125 forward=50 externals=16 macros=9 calls=20 macro-body=3 entries=7 data=100x8 string=50x16
+.extern X0
+.extern X1
+.extern X2
+.extern X3
+.extern X4
+.extern X5
+.extern X6
+.extern X7
+.extern X8
+.extern X9
+.extern X10
+.extern X11
+.extern X12
+.extern X13
+.extern X14
+.extern X15
+macr m0
+ add #98, r4
+ add #58, r4
+ add #41, r3
+endmacr
+macr m1
+ add #82, r2
+ add #1, r1
+ add #71, r5
+endmacr
+macr m2
+ add #26, r6
+ add #66, r5
+ add #58, r1
+endmacr
+macr m3
+ add #24, r6
+ add #35, r4
+ add #30, r7
+endmacr
+macr m4
+ add #24, r5
+ add #1, r7
+ add #74, r2
+endmacr
+macr m5
+ add #98, r5
+ add #14, r2
+ add #79, r4
+endmacr
+macr m6
+ add #4, r3
+ add #28, r0
+ add #38, r7
+endmacr
+macr m7
+ add #49, r4
+ add #70, r6
+ add #84, r6
+endmacr
+macr m8
+ add #89, r2
+ add #71, r1
+ add #11, r5
+endmacr
+.entry L0
+.entry L17
+.entry L35
+.entry L53
+.entry L71
+.entry L89
+.entry L107
+m3
+L0: .data -86, -146, 495, -64, 162, 297, 434, -295
+.string "cqnomgtotqeetkso"
+jsr X0
+cmp #771, L50
+inc r3
+mov r0, r5
+L1: mov r4, r1
+jmp *r1
+.data -315, 369, -245, 309, 45, 2, -356, 444
+mov L0, r2
+cmp #101, r4
+jmp *r4
+inc r7
+L2: mov r6, r2
+inc r1
+mov L0, r7
+cmp #191, L0
+.data 7, -129, -404, -289, 312, -255, -421, 257
+.string "ghxotkharqnrphkt"
+jmp L17
+mov r3, r0
+L3: inc r2
+inc r7
+cmp #634, r3
+jmp L2
+mov r6, r4
+.data 261, 465, -403, 295, 242, 352, 293, 6
+cmp #631, r6
+L4: mov L2, r0
+mov L2, r0
+jmp *r4
+cmp #595, L2
+inc r2
+mov L3, r0
+inc r1
+jmp L3
+L5: .data 486, -108, 273, 136, 407, -453, 55, -308
+.string "jddllmspymvtlkpk"
+inc r7
+cmp #693, L56
+cmp #916, r2
+cmp #867, r6
+cmp #925, L3
+L6: jmp *r3
+mov L2, r0
+m5
+.data -123, -128, -157, -114, 186, -208, 417, -372
+inc r1
+mov r0, r0
+inc r2
+mov L4, r7
+L7: jmp *r4
+mov L0, r4
+jmp L6
+.data 325, 115, -333, -110, 26, 431, 375, 221
+.string "lijkpodotlgrhnmt"
+jmp L81
+jsr X1
+L8: inc r1
+jmp L7
+cmp #766, r3
+cmp #348, r1
+jmp *r6
+inc r6
+.data 169, -281, -239, 198, -165, 364, -497, 262
+cmp #717, L4
+L9: cmp #546, L3
+mov L4, r1
+inc r3
+jmp *r7
+jmp *r4
+cmp #959, r7
+cmp #549, r7
+L10: .data 117, -286, 35, -273, 281, 13, 342, 178
+.string "wgmzsxzpuooebwad"
+cmp #89, L11
+inc r0
+inc r0
+inc r3
+mov r2, r7
+L11: mov r4, r3
+cmp #268, r5
+.data -460, 456, 411, -108, 32, 413, 196, -275
+cmp #709, r2
+cmp #488, L4
+cmp #686, r4
+cmp #550, r3
+cmp #854, r6
+L12: jmp L5
+inc r0
+jmp L10
+jmp L11
+m4
+.data 283, -170, 270, -299, 303, -15, 256, -185
+.string "gnatpuloxctwtavq"
+L13: mov L74, r4
+inc r3
+jmp *r4
+inc r0
+inc r0
+cmp #998, L11
+.data -388, -13, -266, -24, -35, 244, -498, 118
+inc r1
+L14: cmp #187, L4
+mov r5, r1
+cmp #623, r2
+inc r7
+jmp L10
+cmp #258, L10
+inc r3
+L15: .data -265, 489, -481, 24, -179, -335, -95, 92
+.string "hzliswuuandduxak"
+jmp L86
+inc r3
+inc r7
+jsr X2
+inc r0
+inc r7
+L16: cmp #975, L3
+jmp *r2
+.data 456, 337, -29, 416, -181, 407, 55, 299
+jmp *r3
+mov L7, r6
+jmp *r6
+jmp *r0
+L17: inc r4
+inc r6
+jmp *r3
+mov r5, r0
+.data 230, -339, 60, 295, -115, 219, 5, -397
+.string "tzckbkkxeotdpehx"
+inc r2
+inc r4
+L18: cmp #387, L124
+inc r3
+inc r6
+jmp L4
+mov L15, r0
+m4
+.data 68, 72, 148, 400, -458, -454, -429, -347
+L19: mov L17, r7
+jmp *r6
+mov L11, r6
+inc r3
+cmp #562, L18
+jmp L17
+mov L7, r2
+L20: .data -470, -427, -451, -498, -298, 487, 186, 268
+.string "xowfiiyrglkugusf"
+inc r1
+jmp L51
+inc r7
+inc r3
+inc r7
+cmp #916, r7
+L21: jmp *r3
+mov r4, r7
+.data -309, 102, 137, 131, -123, -360, 136, 274
+mov L18, r4
+inc r6
+cmp #318, L13
+mov L17, r7
+L22: inc r1
+inc r7
+inc r2
+mov L10, r1
+.data -32, -129, 80, -225, 442, -46, 329, 460
+.string "rmexntstpxsaxbpa"
+mov L42, r7
+jmp *r5
+L23: jmp *r7
+mov r1, r0
+jmp *r7
+jsr X3
+jmp L4
+.data 254, 391, 395, 86, -436, 398, 388, 255
+cmp #336, L13
+L24: jmp L2
+mov L13, r3
+jmp L0
+inc r1
+jmp L9
+mov L7, r3
+jmp *r1
+mov r2, r7
+m2
+L25: .data -58, -356, 270, -150, -412, -445, -500, -51
+.string "fvytennajokerdkp"
+jmp L110
+inc r1
+cmp #800, L16
+cmp #719, r5
+L26: jmp *r4
+inc r3
+.data 288, 266, 47, -114, 82, 183, -365, 424
+cmp #242, L11
+mov r4, r4
+jmp *r6
+jmp L13
+cmp #219, L15
+L27: jmp *r6
+mov L9, r3
+cmp #957, r7
+.data 322, -168, 316, 338, -420, 437, -333, -462
+.string "etranqzyxtadorao"
+mov L91, r7
+jmp *r4
+L28: cmp #119, r0
+mov L18, r1
+inc r2
+inc r3
+mov L17, r1
+inc r1
+.data -430, -444, 493, 141, -137, -269, -360, -400
+L29: mov r4, r5
+mov L3, r7
+cmp #532, L28
+cmp #794, L14
+mov L24, r1
+jmp *r3
+cmp #196, L18
+jmp L19
+L30: .data -385, 393, -289, 453, -259, 150, -112, -47
+.string "bdaoparyxpxeltzr"
+jmp L109
+cmp #19, r2
+jmp L7
+mov r5, r1
+inc r6
+L31: mov L2, r4
+mov r6, r7
+m8
+.data -461, 204, 386, -105, -14, -99, -234, 191
+jsr X4
+jmp L27
+cmp #188, L21
+mov r5, r3
+L32: jmp *r0
+mov r7, r5
+cmp #321, r4
+cmp #99, r3
+.data 274, 41, -139, 286, -180, -395, -181, 342
+.string "wdyjcuvnuwjjabdm"
+inc r1
+L33: mov L54, r0
+jmp *r3
+inc r5
+mov L26, r0
+mov r2, r7
+mov r7, r2
+.data 348, 200, 214, -253, -317, -426, 492, 278
+inc r2
+L34: inc r0
+cmp #586, L2
+cmp #169, r2
+jmp *r5
+jmp *r5
+jmp *r5
+inc r2
+L35: .data -395, 47, -382, -175, -428, 488, 418, -406
+.string "ukmolzshperywuku"
+cmp #979, L56
+mov L3, r4
+jmp *r1
+cmp #353, r2
+jmp L30
+cmp #734, L18
+L36: mov L23, r1
+.data 214, -334, 196, -465, 76, -230, 313, 136
+cmp #534, r0
+jmp L12
+mov r6, r4
+mov L15, r0
+jmp L27
+L37: mov r7, r6
+cmp #556, L26
+mov r6, r2
+jmp *r4
+m4
+.data -181, 270, 242, 350, -234, -379, 239, 457
+.string "yqpbfzkwmnorztvk"
+cmp #545, L118
+L38: inc r2
+inc r7
+jmp *r6
+cmp #416, r0
+mov L31, r5
+.data 434, -240, 1, 51, 23, -231, -422, -276
+mov L34, r1
+L39: jsr X5
+mov L7, r0
+cmp #469, r2
+jmp L20
+jmp L9
+cmp #350, L28
+jmp L0
+L40: .data -341, 42, 12, -59, -90, -374, -281, 245
+.string "ujscnlanaeyudrfe"
+jmp L63
+cmp #225, L1
+inc r0
+inc r6
+cmp #745, L4
+mov L17, r2
+L41: jmp L19
+cmp #821, r3
+.data -201, 422, 295, -150, -370, 19, 419, -125
+mov r6, r2
+mov L5, r3
+cmp #614, L3
+inc r5
+L42: jmp *r1
+mov L18, r5
+inc r3
+inc r6
+.data 302, -484, -457, -282, 349, 384, -301, 491
+.string "hktlcfrjzofhhtlg"
+mov L86, r7
+cmp #535, L12
+L43: mov r1, r4
+mov r4, r5
+inc r1
+jmp *r2
+cmp #753, r0
+m3
+.data 61, 197, -467, -328, 12, -110, -213, 402
+L44: cmp #542, r7
+cmp #533, L43
+inc r0
+inc r5
+mov r0, r5
+cmp #125, r5
+cmp #493, L6
+jmp L38
+L45: .data 87, 423, -485, -31, -282, -206, 191, -103
+.string "votqubrvklzgkjyc"
+inc r1
+cmp #551, L96
+inc r6
+jmp L16
+mov L7, r3
+L46: cmp #589, L27
+jmp *r5
+.data -388, 479, 448, -198, -418, 493, 16, 293
+mov L40, r1
+mov r0, r2
+cmp #649, r5
+jmp *r0
+jsr X6
+L47: jmp *r5
+mov r1, r5
+inc r6
+.data -209, 38, 394, -292, 92, 215, 88, -396
+.string "jqpjbongvbpnxmuj"
+inc r3
+mov L84, r2
+L48: cmp #624, r2
+cmp #913, L25
+inc r4
+cmp #952, r0
+jmp L23
+cmp #562, L4
+.data 308, 120, 67, 437, 124, 246, 106, -30
+L49: mov r1, r6
+mov r6, r3
+inc r4
+jmp *r6
+mov L48, r2
+mov r1, r7
+cmp #245, L35
+jmp *r0
+m2
+L50: .data 405, 0, 395, 431, -204, 217, -249, -137
+.string "ummkrppwrshbwfac"
+mov L118, r7
+cmp #736, L17
+jmp *r1
+jmp *r5
+L51: inc r1
+cmp #292, r4
+.data 323, -151, -82, -129, 296, 237, -197, 164
+inc r4
+mov r1, r7
+cmp #703, L14
+mov L20, r7
+inc r2
+L52: jmp L9
+mov L34, r4
+cmp #298, L6
+cmp #248, r6
+.data 404, 230, -394, -153, -129, 384, -398, 485
+.string "idecdbpralvjaiee"
+jmp L68
+L53: jmp L47
+cmp #467, r2
+mov r3, r0
+jmp *r6
+mov L18, r7
+inc r4
+.data -239, 129, -256, -99, 192, 57, -340, -399
+inc r4
+L54: inc r6
+jmp L33
+mov r3, r6
+jmp *r5
+jmp L31
+jsr X7
+mov L39, r5
+L55: .data -464, 327, -273, 139, 223, 366, 304, 41
+.string "wvkxvmrnemdronor"
+mov L90, r0
+mov r7, r4
+inc r1
+jmp L3
+inc r5
+inc r4
+L56: cmp #66, r0
+m3
+.data -44, -442, 103, 413, -9, 207, 160, -225
+jmp L29
+cmp #307, r4
+inc r6
+cmp #71, L12
+L57: jmp L18
+jmp L50
+inc r5
+jmp *r5
+.data -96, -253, -472, -203, -21, 16, 485, 426
+.string "tstjflqqlsndpotm"
+mov L104, r2
+L58: inc r0
+cmp #374, r4
+jmp L29
+jmp L2
+mov r6, r6
+jmp *r2
+.data 181, -455, 280, 216, 106, 190, -92, -225
+jmp L53
+L59: mov L36, r3
+jmp L27
+mov L6, r5
+mov L40, r4
+cmp #648, L20
+mov r5, r5
+jmp *r0
+L60: .data -208, 374, 320, 359, 478, 390, 243, 56
+.string "vuwvsfxpragkgpen"
+jmp L67
+mov L5, r0
+mov L13, r6
+cmp #739, r2
+jmp *r3
+cmp #950, r7
+L61: cmp #902, r5
+inc r1
+.data 414, -273, 315, 248, 56, -307, -260, -362
+jmp *r6
+jmp L58
+jmp *r4
+jmp *r0
+L62: inc r0
+jmp L43
+cmp #720, L10
+inc r1
+m2
+.data -398, 87, 12, -214, 146, -245, -237, 383
+.string "zejpmvtqwcuharft"
+jsr X8
+L63: cmp #631, L114
+mov L34, r5
+cmp #975, r3
+inc r0
+cmp #323, L2
+.data -133, -388, -131, 69, 218, 288, -477, 2
+mov r2, r7
+L64: mov L47, r5
+jmp L39
+cmp #677, L37
+inc r1
+inc r1
+mov r3, r1
+jmp *r5
+cmp #223, L59
+L65: .data 20, 498, -129, 325, -400, 184, 45, 108
+.string "gwghpaduvggtxupc"
+jmp L119
+inc r1
+mov L57, r5
+jmp *r0
+cmp #467, r5
+L66: mov L54, r0
+inc r1
+.data -302, 12, 382, 267, 286, -411, -39, -160
+mov L64, r3
+cmp #502, r0
+cmp #626, L34
+cmp #691, r5
+inc r5
+L67: cmp #927, r4
+mov L60, r3
+cmp #849, r5
+.data 259, -430, -196, -430, -44, -206, -5, 301
+.string "ncqukkkjriyxvfgk"
+mov L109, r3
+cmp #215, r6
+L68: inc r2
+inc r0
+mov L60, r1
+mov L6, r7
+cmp #876, r5
+cmp #156, L55
+m4
+L69: .data -39, 166, -462, -211, 104, -140, -353, -17
+inc r1
+cmp #731, r0
+jmp *r3
+jmp L40
+inc r4
+cmp #553, L41
+mov L42, r4
+L70: .data -94, 396, 365, -285, -9, -162, -132, -54
+.string "jsksmowpuyuswygm"
+jsr X9
+jmp L124
+mov r5, r1
+inc r7
+inc r6
+L71: cmp #616, r7
+mov L27, r0
+.data -420, 336, -191, 272, -462, 143, -314, -470
+cmp #225, r1
+cmp #498, r0
+jmp *r5
+cmp #925, r5
+jmp *r3
+L72: jmp *r3
+mov L20, r1
+inc r7
+.data -480, -76, -416, 380, 222, -445, 491, 488
+.string "mvwmnhczbxzwuicc"
+mov L79, r3
+mov L8, r3
+L73: inc r6
+mov r6, r7
+jmp L12
+mov r0, r1
+cmp #134, r2
+mov r5, r1
+.data -2, -56, 255, -322, -314, -335, -235, -196
+jmp L57
+L74: cmp #619, r6
+jmp *r1
+mov L12, r2
+inc r7
+inc r1
+cmp #528, L8
+inc r2
+m1
+L75: .data 239, -476, 141, -106, -480, 29, -394, -111
+.string "kmbksjpvvlofanae"
+jmp L88
+cmp #204, r5
+cmp #928, L7
+inc r6
+jmp *r0
+L76: inc r6
+.data 349, -345, 343, 349, -332, 366, -365, -350
+mov r0, r5
+cmp #593, L45
+cmp #915, L45
+jmp *r7
+jmp *r6
+L77: jmp *r6
+cmp #276, r4
+mov L44, r0
+cmp #905, r5
+.data -395, 147, -231, -138, -328, 260, -213, 114
+.string "esiqesthtohshqqv"
+jmp L86
+L78: inc r1
+jsr X10
+jmp L9
+cmp #893, r6
+jmp *r7
+mov L77, r3
+.data 468, -62, -408, -110, 256, 435, 8, 159
+jmp *r4
+L79: mov r7, r7
+inc r5
+jmp L49
+mov r5, r7
+jmp *r1
+jmp L50
+mov L1, r4
+L80: .data 211, -23, -454, 86, 223, 453, -65, 96
+.string "tgrzoabofsvlgcbq"
+jmp L105
+jmp *r3
+inc r5
+cmp #712, L57
+mov r3, r7
+mov r3, r2
+L81: cmp #100, L78
+inc r7
+m0
+.data 19, 25, 142, 221, -455, -80, 126, 278
+inc r4
+mov r4, r3
+jmp L10
+L82: cmp #491, r0
+cmp #21, r5
+cmp #219, L75
+inc r0
+.data 385, 152, -307, -413, -105, 312, -65, -138
+.string "hboisgsngdxkysus"
+inc r7
+inc r1
+L83: inc r5
+mov L119, r0
+jmp *r0
+cmp #818, L39
+mov r5, r1
+.data 339, 263, 270, -379, 365, -102, -121, 166
+inc r3
+L84: cmp #225, L35
+cmp #45, L0
+mov r5, r4
+mov r7, r1
+inc r6
+mov r1, r5
+jmp *r3
+inc r4
+L85: .data 47, 129, 463, -405, -118, 332, -385, -483
+.string "sqlqwgkbphyongfz"
+jmp L124
+inc r4
+cmp #160, r4
+cmp #58, r7
+cmp #645, r5
+L86: jsr X11
+jmp L33
+.data 22, -399, 281, -50, 295, 226, -120, -240
+cmp #325, r7
+jmp *r7
+mov L52, r1
+cmp #377, L18
+L87: mov L78, r4
+jmp L40
+jmp *r6
+cmp #325, r4
+m4
+.data -418, -294, 229, -114, 292, 391, 156, -130
+.string "smxzawaisubmlexg"
+mov L93, r5
+L88: jmp *r2
+inc r3
+inc r3
+cmp #816, r5
+jmp L9
+inc r4
+.data 488, 148, 140, -480, -116, 134, -327, -274
+L89: mov L29, r6
+mov r5, r6
+mov r3, r3
+cmp #619, r2
+mov L82, r3
+mov L83, r3
+cmp #389, r2
+cmp #674, r4
+L90: .data -310, 41, -117, -316, -211, -418, 217, -290
+.string "tloojoorvkyfqhxl"
+inc r6
+mov L112, r3
+cmp #592, L88
+inc r5
+cmp #465, r5
+L91: mov r5, r2
+inc r2
+.data -220, -70, -16, 9, -61, -188, -49, -411
+jmp L18
+inc r2
+cmp #430, r4
+cmp #205, r4
+jmp L18
+L92: cmp #282, r3
+cmp #928, L58
+cmp #261, L5
+.data 182, 132, -425, -112, -3, 423, -460, -483
+.string "nusedhocffmiutok"
+cmp #6, L110
+jmp L68
+L93: cmp #653, L6
+jmp *r1
+inc r2
+mov L88, r7
+mov r5, r0
+jmp *r1
+m3
+.data -261, -280, -77, 469, 27, 24, -230, -335
+L94: jsr X12
+inc r7
+inc r0
+mov r4, r0
+cmp #390, r1
+cmp #249, L0
+mov L37, r0
+L95: .data 118, -338, 39, -87, -154, 444, -21, 277
+.string "mwrjrforhzfkqmtz"
+mov L118, r0
+inc r5
+jmp *r4
+jmp L33
+inc r3
+jmp *r3
+L96: inc r4
+.data -115, 11, 255, -483, -251, -85, -174, 19
+cmp #931, r7
+inc r4
+mov L36, r2
+inc r7
+mov r6, r4
+L97: cmp #61, L44
+cmp #80, r3
+mov r6, r5
+cmp #519, L35
+.data 332, -60, 125, 207, -229, -285, 30, -402
+.string "xuzztnfjrqxiezfj"
+mov L102, r6
+L98: inc r5
+inc r2
+jmp *r4
+mov L84, r0
+jmp *r3
+jmp L10
+.data -451, -432, 84, -189, 48, -473, -150, 88
+cmp #689, L72
+L99: jmp L79
+mov L24, r4
+jmp L0
+cmp #258, r0
+inc r7
+jmp L13
+mov r3, r2
+m2
+L100: .data 50, -357, -170, -367, 95, -447, 474, 317
+.string "hawnvunchstryhsq"
+jmp L101
+cmp #257, L65
+cmp #793, L43
+mov L4, r4
+mov r5, r3
+L101: jmp L77
+mov r4, r5
+.data -55, 352, 281, 43, -225, 167, 424, 272
+inc r2
+jsr X13
+cmp #803, L67
+cmp #180, L45
+L102: inc r4
+cmp #381, L80
+jmp L54
+cmp #230, r2
+.data 288, -269, -66, -227, 126, 251, 494, 416
+.string "fbidpgijafdfvujb"
+mov L111, r4
+inc r2
+L103: cmp #88, L45
+mov L32, r0
+mov L66, r7
+cmp #518, r3
+mov r3, r7
+.data 151, 159, -72, 129, -414, -121, -14, 144
+mov r7, r3
+L104: mov L81, r0
+mov r1, r7
+mov L16, r4
+cmp #658, r7
+mov r5, r1
+mov r2, r2
+jmp *r5
+cmp #607, L66
+L105: .data -76, -244, 484, 4, 433, 293, 366, 233
+.string "rhhuqrarhnzwvxnf"
+jmp L114
+cmp #372, r3
+cmp #860, r4
+inc r5
+cmp #160, L87
+L106: cmp #44, L18
+cmp #612, L1
+m3
+.data -1, -80, -158, -301, 473, -101, 125, 372
+jmp L71
+jmp *r7
+cmp #143, L9
+L107: cmp #652, r5
+inc r3
+inc r7
+mov L51, r0
+.data 316, 448, -56, -184, 466, 391, 385, 404
+.string "qfiwqivozkxkbrar"
+cmp #460, L124
+mov L99, r0
+L108: jmp *r0
+jmp L91
+jmp L100
+inc r7
+mov r1, r7
+.data -35, 229, 199, -150, 351, 192, -26, 84
+mov r4, r6
+L109: cmp #998, L107
+inc r4
+mov r5, r7
+jsr X14
+inc r4
+inc r7
+jmp L20
+inc r0
+L110: .data -194, 344, 125, 445, -484, 93, -457, 300
+.string "vlqahsiarxcyuoge"
+cmp #153, L121
+jmp *r3
+inc r6
+jmp *r6
+jmp L103
+L111: cmp #347, r6
+mov r2, r5
+.data -320, -245, 197, 20, 168, 359, -180, 52
+cmp #272, L44
+mov L18, r4
+mov r3, r4
+mov r1, r6
+jmp L34
+L112: jmp L77
+inc r1
+inc r7
+m4
+.data -41, -72, -245, -63, 108, -440, -19, 282
+.string "hrktcamnnkglleus"
+cmp #663, L123
+L113: inc r3
+mov L64, r3
+jmp L71
+mov L65, r4
+mov L70, r5
+inc r0
+.data 294, 221, 191, -4, -47, 390, 296, -419
+cmp #508, r5
+L114: jmp L54
+inc r2
+mov r0, r0
+cmp #789, L5
+jmp *r4
+jmp L19
+inc r0
+L115: .data 221, -496, 92, -182, 381, -200, 281, -480
+.string "ivjrmildfwnvdmta"
+mov L119, r3
+jmp L23
+inc r7
+inc r7
+mov r4, r5
+L116: jmp *r4
+cmp #296, r6
+.data 283, 190, 232, -374, 456, -342, -447, -423
+mov r1, r4
+cmp #464, r2
+mov r5, r6
+inc r5
+inc r4
+L117: jmp L100
+jsr X15
+inc r6
+jmp L88
+.data 63, -111, 492, 19, -178, -457, -69, -73
+.string "eqgkbrlqeprarecn"
+inc r2
+L118: cmp #17, L120
+inc r3
+mov r7, r7
+mov L77, r5
+jmp L48
+cmp #879, r7
+m2
+.data -231, -82, -118, 182, 244, -84, 273, 224
+L119: inc r1
+cmp #620, r0
+jmp L12
+jmp L14
+inc r7
+cmp #382, r3
+cmp #288, r6
+L120: .data 485, -216, -69, -93, 197, -140, -126, 117
+.string "gznlbhlvwvqvrhtx"
+inc r1
+mov L124, r5
+cmp #126, L105
+cmp #696, L62
+jmp L91
+inc r1
+L121: inc r6
+inc r4
+.data 143, -246, -396, -264, -292, 86, -471, -64
+cmp #689, L73
+inc r7
+mov L84, r2
+mov r7, r0
+L122: mov L50, r6
+inc r2
+inc r1
+jmp L2
+.data -55, 263, -433, -405, -206, -494, 23, -333
+.string "aahydshcuhccwymv"
+inc r4
+jmp L124
+L123: mov L119, r0
+inc r1
+mov r1, r4
+jmp *r1
+jmp *r6
+.data -400, 399, 403, -44, 464, 422, -438, -300
+inc r6
+L124: inc r4
+jmp L45
+mov L90, r4
+jmp L34
+cmp #52, L55
+cmp #732, r3
+mov r1, r2
+mov L78, r5
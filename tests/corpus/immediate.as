@@ -0,0 +1,5 @@
+MAIN: mov #4095, r1
+cmp #-2048, #4096
+add #-2049, r2
+prn #2047
+stop
@@ -0,0 +1,2 @@
+MAIN: prn #99999999999
+stop
@@ -0,0 +1,2 @@
+MAIN: cmp r1, #-99999999999999999999
+stop
@@ -0,0 +1,2 @@
+MAIN: prn #4294967296
+stop
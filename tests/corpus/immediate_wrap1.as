@@ -0,0 +1,2 @@
+MAIN: mov #4294967297, r1
+stop
@@ -0,0 +1,25 @@
+; file ps.as
+.entry LIST
+.extern W
+macr m_macr
+ cmp r3, #-6
+ bne END
+endmacr
+MAIN:  add   r3,  LIST
+LOOP: prn #48
+   lea STR, r6
+ inc r6
+ mov *r6,K
+ sub r1, r4
+ m_macr
+ dec K
+.entry MAIN
+ jmp LOOP
+END: stop
+STR: .string "abcd"
+LIST: .data 6, -9
+ .data -100
+K: .data 31
+.extern L3
+ jsr L3
+ mov W, r1
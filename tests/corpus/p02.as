@@ -0,0 +1,28 @@
+; second program with several macros
+.extern EXT1
+.extern EXT2
+macr inc_twice
+ inc r1
+ inc r1
+endmacr
+macr   save_reg
+	mov r2 , r3
+
+	add #5 ,  r3
+endmacr
+.entry START
+START:	mov EXT1 , r2
+	inc_twice
+	save_reg
+	cmp #3, *r4
+	jsr EXT2
+	red r7
+	not *r2
+	clr DATA
+	prn EXT1
+	bne START
+	rts
+DATA: .data 1,2,3 , 4,   -5
+S2: .string "hello world"
+.entry DATA
+	stop
@@ -0,0 +1,10 @@
+MAIN: mov r1,r2
+ add r1
+ foo r2
+LABEL: .data 5,,6
+ .string "abc
+LOOP: jmp NOWHERE
+MAIN: stop
+1BAD: stop
+ .entry MISSING
+r3: stop
@@ -0,0 +1,10 @@
+macr mov
+ stop
+endmacr
+macr good extra
+ stop
+endmacr
+macr good
+ stop
+endmacr
+ good
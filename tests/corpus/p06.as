@@ -0,0 +1,2 @@
+A: mov r1,r2
+ stop
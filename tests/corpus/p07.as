@@ -0,0 +1,11 @@
+.extern X
+.extern Y
+ mov X,Y
+ cmp X,X
+ lea Y,r1
+ prn #-2
+ mov #1000,r0
+ mov *r1,*r2
+ sub r1,*r7
+K: .string ""
+ .data 0
@@ -0,0 +1,166 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../globals.h"
+#include "../normalize.h"
+
+/* Runs every kernel of remove_extra_spaces_str that the processor supports on the lines of the files on the
+ * command line and on generated long, tab-heavy and comma-heavy lines, and checks that every kernel writes
+ * the same lines as the scalar one. Every line is held in a buffer of its own length, so a kernel that reads
+ * past the end of a line is caught by a memory checker. */
+
+/* The generated lines have every length up to this one, past the runs of 16 and 32 characters of the vector kernels */
+#define LONGEST_LINE 300
+
+/* The generated lines of every length and kind */
+#define LINES_PER_LENGTH 8
+
+/* A generated line is made of runs of letters, each followed by a few special characters */
+typedef struct line_kind {
+	const char *name;     /* the name of the kind in the reports */
+	const char *special;  /* the characters between the runs */
+	long longest_run;     /* the most letters of a run */
+	long most_special;    /* the most special characters after a run */
+} line_kind;
+
+static const line_kind KINDS[] = {
+	{"long", " ", 100, 1},
+	{"tab-heavy", "\t \v\f\r", 40, 6},
+	{"comma-heavy", ", \t", 40, 4}
+};
+
+#define KINDS_COUNT (int)(sizeof(KINDS) / sizeof(KINDS[0]))
+
+static unsigned long seed = 1;
+
+/* the next of a sequence of pseudo random numbers, from 0 to limit - 1 */
+static long next_random(long limit) {
+	seed = seed * 1103515245UL + 12345UL;
+	return (long)((seed >> 16) % (unsigned long)limit);
+}
+
+/* normalizes the line with every kernel, returns 0 when one writes another line than the scalar kernel */
+static int check_line(const char *line, size_t len, const char *source, long number) {
+	char *line_copy = malloc(len > 0 ? len : 1);
+	char *expected = malloc(len + 2);
+	char *actual = malloc(len + 2);
+	normalize_kernel kernel;
+	int same = 1;
+
+	if (line_copy == NULL || expected == NULL || actual == NULL) {
+		fprintf(stderr, "normalize_check: out of memory\n");
+		exit(1);
+	}
+	memcpy(line_copy, line, len);
+	select_normalize_kernel(NORMALIZE_SCALAR);
+	remove_extra_spaces_str(line_copy, len, expected);
+	for (kernel = NORMALIZE_SSE2; kernel <= NORMALIZE_AVX2 && same; kernel++) {
+		/* a kernel the processor does not support is replaced by another one, which is checked on its own */
+		if (select_normalize_kernel(kernel) != kernel) {
+			break;
+		}
+		remove_extra_spaces_str(line_copy, len, actual);
+		if (strcmp(expected, actual) != 0) {
+			fprintf(stderr, "normalize_check: %s, line %ld: the %s kernel wrote \"%s\", the scalar kernel \"%s\"\n",
+				source, number, normalize_kernel_name(kernel), actual, expected);
+			same = 0;
+		}
+	}
+	free(line_copy);
+	free(expected);
+	free(actual);
+	return same;
+}
+
+/* checks every line of a file, with its '\n' as the assembler reads it */
+static int check_file(const char *name, long *lines) {
+	FILE *file = fopen(name, "rb");
+	char *text = NULL, *start, *end;
+	size_t size = 0, capacity = 0, read;
+	int same = 1;
+	long number = 0;
+
+	if (file == NULL) {
+		fprintf(stderr, "normalize_check: cannot open %s\n", name);
+		return 0;
+	}
+	do {
+		if (size == capacity) {
+			capacity = (capacity == 0) ? 4096 : capacity * 2;
+			text = realloc(text, capacity);
+			if (text == NULL) {
+				fprintf(stderr, "normalize_check: out of memory\n");
+				exit(1);
+			}
+		}
+		read = fread(text + size, 1, capacity - size, file);
+		size += read;
+	} while (read > 0);
+	fclose(file);
+
+	for (start = text; start < text + size && same; start = end) {
+		end = memchr(start, '\n', (size_t)(text + size - start));
+		end = (end == NULL) ? text + size : end + 1;
+		same = check_line(start, (size_t)(end - start), name, ++number);
+	}
+	free(text);
+	*lines += number;
+	return same;
+}
+
+/* checks lines of every length of a kind, with and without a '\n', some of them starting with a comma */
+static int check_kind(const line_kind *kind, long *lines) {
+	char line[LONGEST_LINE + 1];
+	size_t len, i, stop;
+	long number = 0;
+	int k;
+
+	for (len = 0; len <= LONGEST_LINE; len++) {
+		for (k = 0; k < LINES_PER_LENGTH; k++) {
+			for (i = 0; i < len;) {
+				for (stop = i + (size_t)next_random(kind->longest_run + 1); i < len && i < stop; i++) {
+					line[i] = (char)('a' + next_random(26));
+				}
+				for (stop = i + 1 + (size_t)next_random(kind->most_special); i < len && i < stop; i++) {
+					line[i] = kind->special[next_random((long)strlen(kind->special))];
+				}
+			}
+			if (len > 0 && k % 4 == 1) {
+				line[len - 1] = '\n';
+			}
+			if (len > 0 && k % 4 == 2) {
+				line[0] = ',';
+			}
+			number++;
+			if (!check_line(line, len, kind->name, number)) {
+				return 0;
+			}
+		}
+	}
+	*lines += number;
+	return 1;
+}
+
+int main(int argc, char *argv[]) {
+	normalize_kernel best = select_normalize_kernel(NORMALIZE_AUTO);
+	normalize_kernel kernel;
+	long lines = 0;
+	int i;
+
+	for (i = 1; i < argc; i++) {
+		if (!check_file(argv[i], &lines)) {
+			return 1;
+		}
+	}
+	for (i = 0; i < KINDS_COUNT; i++) {
+		if (!check_kind(&KINDS[i], &lines)) {
+			return 1;
+		}
+	}
+	printf("normalize_check: %ld lines, the kernels", lines);
+	for (kernel = NORMALIZE_SCALAR; kernel <= best; kernel++) {
+		printf(" %s", normalize_kernel_name(kernel));
+	}
+	printf(" write the same lines\n");
+	return 0;
+}